@@ -629,12 +629,137 @@ void Actor::AddRotationR( float rot )
 	RageQuatMultiply( &DestTweenState().quat, DestTweenState().quat, RageQuatFromR(rot) );
 }
 
-void Actor::Command( CString sCommands )
+/* Names are listed in the same order as the enum. */
+enum ActorCommand
+{
+	AC_SLEEP,
+	AC_LINEAR,
+	AC_ACCELERATE,
+	AC_DECELERATE,
+	AC_BOUNCEBEGIN,
+	AC_BOUNCEEND,
+	AC_SPRING,
+	AC_STOPTWEENING,
+	AC_FINISHTWEENING,
+	AC_HURRYTWEENING,
+	AC_X,
+	AC_Y,
+	AC_Z,
+	AC_ADDX,
+	AC_ADDY,
+	AC_ADDZ,
+	AC_ZOOM,
+	AC_ZOOMX,
+	AC_ZOOMY,
+	AC_ZOOMZ,
+	AC_ZOOMTOWIDTH,
+	AC_ZOOMTOHEIGHT,
+	AC_STRETCHTO,
+	AC_CROPLEFT,
+	AC_CROPTOP,
+	AC_CROPRIGHT,
+	AC_CROPBOTTOM,
+	AC_FADELEFT,
+	AC_FADETOP,
+	AC_FADERIGHT,
+	AC_FADEBOTTOM,
+	AC_FADECOLOR,
+	AC_DIFFUSE,
+	AC_DIFFUSELEFTEDGE,
+	AC_DIFFUSERIGHTEDGE,
+	AC_DIFFUSETOPEDGE,
+	AC_DIFFUSEBOTTOMEDGE,
+	AC_DIFFUSEALPHA,
+	AC_DIFFUSECOLOR,
+	AC_GLOW,
+	AC_GLOWMODE,
+	AC_ROTATIONX,
+	AC_ROTATIONY,
+	AC_ROTATIONZ,
+	AC_HEADING,
+	AC_PITCH,
+	AC_ROLL,
+	AC_SHADOWLENGTH,
+	AC_HORIZALIGN,
+	AC_VERTALIGN,
+	AC_DIFFUSEBLINK,
+	AC_DIFFUSESHIFT,
+	AC_GLOWBLINK,
+	AC_GLOWSHIFT,
+	AC_RAINBOW,
+	AC_WAG,
+	AC_BOUNCE,
+	AC_BOB,
+	AC_PULSE,
+	AC_SPIN,
+	AC_VIBRATE,
+	AC_STOPEFFECT,
+	AC_EFFECTCOLOR1,
+	AC_EFFECTCOLOR2,
+	AC_EFFECTPERIOD,
+	AC_EFFECTOFFSET,
+	AC_EFFECTDELAY,
+	AC_EFFECTCLOCK,
+	AC_EFFECTMAGNITUDE,
+	AC_SCALETOCOVER,
+	AC_SCALETOFIT,
+	AC_ANIMATE,
+	AC_SETSTATE,
+	AC_TEXTUREWRAPPING,
+	AC_ADDITIVEBLEND,
+	AC_BLEND,
+	AC_ZBUFFER,
+	AC_ZTEST,
+	AC_ZTESTMODE,
+	AC_ZWRITE,
+	AC_CLEARZBUFFER,
+	AC_BACKFACECULL,
+	AC_CULLMODE,
+	AC_HIDDEN,
+	AC_HIBERNATE,
+	AC_DRAWORDER,
+	AC_PLAYCOMMAND,
+	AC_QUEUECOMMAND,
+	AC_CUSTOMTEXTURERECT,
+	AC_TEXCOORDVELOCITY,
+	AC_SCALETOCLIPPED,
+	AC_STRETCHTEXCOORDS,
+	AC_POSITION,
+	AC_LOOP,
+	AC_PLAY,
+	AC_PAUSE,
+	AC_RATE,
+	NUM_ACTOR_COMMANDS
+};
+
+static const char *const g_szActorCommandNames[NUM_ACTOR_COMMANDS] =
 {
-	sCommands.MakeLower();
+	"sleep", "linear", "accelerate", "decelerate", "bouncebegin", "bounceend",
+	"spring", "stoptweening", "finishtweening", "hurrytweening", "x", "y", "z",
+	"addx", "addy", "addz", "zoom", "zoomx", "zoomy", "zoomz", "zoomtowidth",
+	"zoomtoheight", "stretchto", "cropleft", "croptop", "cropright",
+	"cropbottom", "fadeleft", "fadetop", "faderight", "fadebottom",
+	"fadecolor", "diffuse", "diffuseleftedge", "diffuserightedge",
+	"diffusetopedge", "diffusebottomedge", "diffusealpha", "diffusecolor",
+	"glow", "glowmode", "rotationx", "rotationy", "rotationz", "heading",
+	"pitch", "roll", "shadowlength", "horizalign", "vertalign", "diffuseblink",
+	"diffuseshift", "glowblink", "glowshift", "rainbow", "wag", "bounce",
+	"bob", "pulse", "spin", "vibrate", "stopeffect", "effectcolor1",
+	"effectcolor2", "effectperiod", "effectoffset", "effectdelay",
+	"effectclock", "effectmagnitude", "scaletocover", "scaletofit", "animate",
+	"setstate", "texturewrapping", "additiveblend", "blend", "zbuffer",
+	"ztest", "ztestmode", "zwrite", "clearzbuffer", "backfacecull", "cullmode",
+	"hidden", "hibernate", "draworder", "playcommand", "queuecommand",
+	"customtexturerect", "texcoordvelocity", "scaletoclipped",
+	"stretchtexcoords", "position", "loop", "play", "pause", "rate"
+};
+
+static const CommandNameTable g_ActorCommands( g_szActorCommandNames, NUM_ACTOR_COMMANDS );
 
-	vector<ParsedCommand> vCommands;
-	ParseCommands( sCommands, vCommands );
+void Actor::Command( CString sCommands )
+{
+	vector<ParsedCommand> vScratch;
+	const vector<ParsedCommand> &vCommands = CompileCommands( sCommands, vScratch );
 
 	for( unsigned i=0; i<vCommands.size(); i++ )
 		this->HandleCommand( vCommands[i] );
@@ -644,108 +769,108 @@ void Actor::HandleCommand( const ParsedCommand &command )
 {
 	HandleParams;
 
-	const CString& sName = sParam(0);
-
+	switch( g_ActorCommands.Lookup(command) )
+	{
 	// Commands that go in the tweening queue:
-	if     ( sName=="sleep" )			Sleep( fParam(1) );
-	else if( sName=="linear" )			BeginTweening( fParam(1), TWEEN_LINEAR );
-	else if( sName=="accelerate" )		BeginTweening( fParam(1), TWEEN_ACCELERATE );
-	else if( sName=="decelerate" )		BeginTweening( fParam(1), TWEEN_DECELERATE );
-	else if( sName=="bouncebegin" )		BeginTweening( fParam(1), TWEEN_BOUNCE_BEGIN );
-	else if( sName=="bounceend" )		BeginTweening( fParam(1), TWEEN_BOUNCE_END );
-	else if( sName=="spring" )			BeginTweening( fParam(1), TWEEN_SPRING );
-	else if( sName=="stoptweening" )	{ StopTweening(); BeginTweening( 0.0001f, TWEEN_LINEAR ); }	// Why BeginT again? -Chris
-	else if( sName=="finishtweening" )	FinishTweening();
-	else if( sName=="hurrytweening" )	HurryTweening( fParam(1) );
-	else if( sName=="x" )				SetX( fParam(1) );
-	else if( sName=="y" )				SetY( fParam(1) );
-	else if( sName=="z" )				SetZ( fParam(1) );
-	else if( sName=="addx" )			SetX( GetDestX()+fParam(1) );
-	else if( sName=="addy" )			SetY( GetDestY()+fParam(1) );
-	else if( sName=="addz" )			SetZ( GetDestZ()+fParam(1) );
-	else if( sName=="zoom" )			SetZoom( fParam(1) );
-	else if( sName=="zoomx" )			SetZoomX( fParam(1) );
-	else if( sName=="zoomy" )			SetZoomY( fParam(1) );
-	else if( sName=="zoomz" )			SetZoomZ( fParam(1) );
-	else if( sName=="zoomtowidth" )		ZoomToWidth( fParam(1) );
-	else if( sName=="zoomtoheight" )	ZoomToHeight( fParam(1) );
-	else if( sName=="stretchto" )		StretchTo( RectF( fParam(1), fParam(2), fParam(3), fParam(4) ) );
-	else if( sName=="cropleft" )		SetCropLeft( fParam(1) );
-	else if( sName=="croptop" )			SetCropTop( fParam(1) );
-	else if( sName=="cropright" )		SetCropRight( fParam(1) );
-	else if( sName=="cropbottom" )		SetCropBottom( fParam(1) );
-	else if( sName=="fadeleft" )		SetFadeLeft( fParam(1) );
-	else if( sName=="fadetop" )			SetFadeTop( fParam(1) );
-	else if( sName=="faderight" )		SetFadeRight( fParam(1) );
-	else if( sName=="fadebottom" )		SetFadeBottom( fParam(1) );
-	else if( sName=="fadecolor" )		SetFadeDiffuseColor( cParam(1) );
-	else if( sName=="diffuse" )			SetDiffuse( cParam(1) );
-	else if( sName=="diffuseleftedge" )		SetDiffuseLeftEdge( cParam(1) );
-	else if( sName=="diffuserightedge" )	SetDiffuseRightEdge( cParam(1) );
-	else if( sName=="diffusetopedge" )		SetDiffuseTopEdge( cParam(1) );
-	else if( sName=="diffusebottomedge" )	SetDiffuseBottomEdge( cParam(1) );
+	case AC_SLEEP:						Sleep( fParam(1) ); break;
+	case AC_LINEAR:						BeginTweening( fParam(1), TWEEN_LINEAR ); break;
+	case AC_ACCELERATE:					BeginTweening( fParam(1), TWEEN_ACCELERATE ); break;
+	case AC_DECELERATE:					BeginTweening( fParam(1), TWEEN_DECELERATE ); break;
+	case AC_BOUNCEBEGIN:				BeginTweening( fParam(1), TWEEN_BOUNCE_BEGIN ); break;
+	case AC_BOUNCEEND:					BeginTweening( fParam(1), TWEEN_BOUNCE_END ); break;
+	case AC_SPRING:						BeginTweening( fParam(1), TWEEN_SPRING ); break;
+	case AC_STOPTWEENING:				StopTweening(); BeginTweening( 0.0001f, TWEEN_LINEAR ); break;	// Why BeginT again? -Chris
+	case AC_FINISHTWEENING:				FinishTweening(); break;
+	case AC_HURRYTWEENING:				HurryTweening( fParam(1) ); break;
+	case AC_X:							SetX( fParam(1) ); break;
+	case AC_Y:							SetY( fParam(1) ); break;
+	case AC_Z:							SetZ( fParam(1) ); break;
+	case AC_ADDX:						SetX( GetDestX()+fParam(1) ); break;
+	case AC_ADDY:						SetY( GetDestY()+fParam(1) ); break;
+	case AC_ADDZ:						SetZ( GetDestZ()+fParam(1) ); break;
+	case AC_ZOOM:						SetZoom( fParam(1) ); break;
+	case AC_ZOOMX:						SetZoomX( fParam(1) ); break;
+	case AC_ZOOMY:						SetZoomY( fParam(1) ); break;
+	case AC_ZOOMZ:						SetZoomZ( fParam(1) ); break;
+	case AC_ZOOMTOWIDTH:				ZoomToWidth( fParam(1) ); break;
+	case AC_ZOOMTOHEIGHT:				ZoomToHeight( fParam(1) ); break;
+	case AC_STRETCHTO:					StretchTo( RectF( fParam(1), fParam(2), fParam(3), fParam(4) ) ); break;
+	case AC_CROPLEFT:					SetCropLeft( fParam(1) ); break;
+	case AC_CROPTOP:					SetCropTop( fParam(1) ); break;
+	case AC_CROPRIGHT:					SetCropRight( fParam(1) ); break;
+	case AC_CROPBOTTOM:					SetCropBottom( fParam(1) ); break;
+	case AC_FADELEFT:					SetFadeLeft( fParam(1) ); break;
+	case AC_FADETOP:					SetFadeTop( fParam(1) ); break;
+	case AC_FADERIGHT:					SetFadeRight( fParam(1) ); break;
+	case AC_FADEBOTTOM:					SetFadeBottom( fParam(1) ); break;
+	case AC_FADECOLOR:					SetFadeDiffuseColor( cParam(1) ); break;
+	case AC_DIFFUSE:					SetDiffuse( cParam(1) ); break;
+	case AC_DIFFUSELEFTEDGE:			SetDiffuseLeftEdge( cParam(1) ); break;
+	case AC_DIFFUSERIGHTEDGE:			SetDiffuseRightEdge( cParam(1) ); break;
+	case AC_DIFFUSETOPEDGE:				SetDiffuseTopEdge( cParam(1) ); break;
+	case AC_DIFFUSEBOTTOMEDGE:			SetDiffuseBottomEdge( cParam(1) ); break;
 	/* Add left/right/top/bottom for alpha if needed. */
-	else if( sName=="diffusealpha" )	SetDiffuseAlpha( fParam(1) );
-	else if( sName=="diffusecolor" )	SetDiffuseColor( cParam(1) );
-	else if( sName=="glow" )			SetGlow( cParam(1) );
-	else if( sName=="glowmode" ) {
+	case AC_DIFFUSEALPHA:				SetDiffuseAlpha( fParam(1) ); break;
+	case AC_DIFFUSECOLOR:				SetDiffuseColor( cParam(1) ); break;
+	case AC_GLOW:						SetGlow( cParam(1) ); break;
+	case AC_GLOWMODE:
 		if(!sParam(1).CompareNoCase("whiten"))
 			SetGlowMode( GLOW_WHITEN );
 		else if(!sParam(1).CompareNoCase("brighten"))
 			SetGlowMode( GLOW_BRIGHTEN );
 		else ASSERT(0);
-	}
-	else if( sName=="rotationx" )		SetRotationX( fParam(1) );
-	else if( sName=="rotationy" )		SetRotationY( fParam(1) );
-	else if( sName=="rotationz" )		SetRotationZ( fParam(1) );
-	else if( sName=="heading" )			AddRotationH( fParam(1) );
-	else if( sName=="pitch" )			AddRotationP( fParam(1) );
-	else if( sName=="roll" ) 			AddRotationR( fParam(1) );
-	else if( sName=="shadowlength" )	SetShadowLength( fParam(1) );
-	else if( sName=="horizalign" )		SetHorizAlign( sParam(1) );
-	else if( sName=="vertalign" )		SetVertAlign( sParam(1) );
-	else if( sName=="diffuseblink" )	SetEffectDiffuseBlink();
-	else if( sName=="diffuseshift" )	SetEffectDiffuseShift();
-	else if( sName=="glowblink" )		SetEffectGlowBlink();
-	else if( sName=="glowshift" )		SetEffectGlowShift();
-	else if( sName=="rainbow" )			SetEffectRainbow();
-	else if( sName=="wag" )				SetEffectWag();
-	else if( sName=="bounce" )			SetEffectBounce();
-	else if( sName=="bob" )				SetEffectBob();
-	else if( sName=="pulse" )			SetEffectPulse();
-	else if( sName=="spin" )			SetEffectSpin();
-	else if( sName=="vibrate" )			SetEffectVibrate();
-	else if( sName=="stopeffect" )		SetEffectNone();
-	else if( sName=="effectcolor1" )	SetEffectColor1( cParam(1) );
-	else if( sName=="effectcolor2" )	SetEffectColor2( cParam(1) );
-	else if( sName=="effectperiod" )	SetEffectPeriod( fParam(1) );
-	else if( sName=="effectoffset" )	SetEffectOffset( fParam(1) );
-	else if( sName=="effectdelay" )		SetEffectDelay( fParam(1) );
-	else if( sName=="effectclock" )		SetEffectClock( sParam(1) );
-	else if( sName=="effectmagnitude" )	SetEffectMagnitude( RageVector3(fParam(1),fParam(2),fParam(3)) );
-	else if( sName=="scaletocover" )	{ RectI R(iParam(1), iParam(2), iParam(3), iParam(4));  ScaleToCover(R); }
-	else if( sName=="scaletofit" )		{ RectI R(iParam(1), iParam(2), iParam(3), iParam(4));  ScaleToFitInside(R); }
+		break;
+	case AC_ROTATIONX:					SetRotationX( fParam(1) ); break;
+	case AC_ROTATIONY:					SetRotationY( fParam(1) ); break;
+	case AC_ROTATIONZ:					SetRotationZ( fParam(1) ); break;
+	case AC_HEADING:					AddRotationH( fParam(1) ); break;
+	case AC_PITCH:						AddRotationP( fParam(1) ); break;
+	case AC_ROLL:						AddRotationR( fParam(1) ); break;
+	case AC_SHADOWLENGTH:				SetShadowLength( fParam(1) ); break;
+	case AC_HORIZALIGN:					SetHorizAlign( sParam(1) ); break;
+	case AC_VERTALIGN:					SetVertAlign( sParam(1) ); break;
+	case AC_DIFFUSEBLINK:				SetEffectDiffuseBlink(); break;
+	case AC_DIFFUSESHIFT:				SetEffectDiffuseShift(); break;
+	case AC_GLOWBLINK:					SetEffectGlowBlink(); break;
+	case AC_GLOWSHIFT:					SetEffectGlowShift(); break;
+	case AC_RAINBOW:					SetEffectRainbow(); break;
+	case AC_WAG:						SetEffectWag(); break;
+	case AC_BOUNCE:						SetEffectBounce(); break;
+	case AC_BOB:						SetEffectBob(); break;
+	case AC_PULSE:						SetEffectPulse(); break;
+	case AC_SPIN:						SetEffectSpin(); break;
+	case AC_VIBRATE:					SetEffectVibrate(); break;
+	case AC_STOPEFFECT:					SetEffectNone(); break;
+	case AC_EFFECTCOLOR1:				SetEffectColor1( cParam(1) ); break;
+	case AC_EFFECTCOLOR2:				SetEffectColor2( cParam(1) ); break;
+	case AC_EFFECTPERIOD:				SetEffectPeriod( fParam(1) ); break;
+	case AC_EFFECTOFFSET:				SetEffectOffset( fParam(1) ); break;
+	case AC_EFFECTDELAY:				SetEffectDelay( fParam(1) ); break;
+	case AC_EFFECTCLOCK:				SetEffectClock( sParam(1) ); break;
+	case AC_EFFECTMAGNITUDE:			SetEffectMagnitude( RageVector3(fParam(1),fParam(2),fParam(3)) ); break;
+	case AC_SCALETOCOVER:				{ RectI R(iParam(1), iParam(2), iParam(3), iParam(4));  ScaleToCover(R); break; }
+	case AC_SCALETOFIT:					{ RectI R(iParam(1), iParam(2), iParam(3), iParam(4));  ScaleToFitInside(R); break; }
 	// Commands that take effect immediately (ignoring the tweening queue):
-	else if( sName=="animate" )			EnableAnimation( bParam(1) );
-	else if( sName=="setstate" )		SetState( iParam(1) );
-	else if( sName=="texturewrapping" )	SetTextureWrapping( bParam(1) );
-	else if( sName=="additiveblend" )	SetBlendMode( bParam(1) ? BLEND_ADD : BLEND_NORMAL );
-	else if( sName=="blend" )			SetBlendMode( sParam(1) );
-	else if( sName=="zbuffer" )			SetUseZBuffer( bParam(1) );
-	else if( sName=="ztest" )			SetZTestMode( bParam(1)?ZTEST_WRITE_ON_PASS:ZTEST_OFF );
-	else if( sName=="ztestmode" )		SetZTestMode( sParam(1) );
-	else if( sName=="zwrite" )			SetZWrite( bParam(1) );
-	else if( sName=="clearzbuffer" )	SetClearZBuffer( bParam(1) );
-	else if( sName=="backfacecull" )	SetCullMode( bParam(1) ? CULL_BACK : CULL_NONE );
-	else if( sName=="cullmode" )		SetCullMode( sParam(1) );
-	else if( sName=="hidden" )			SetHidden( bParam(1) );
-	else if( sName=="hibernate" )		SetHibernate( fParam(1) );
-	else if( sName=="draworder" )		SetDrawOrder( iParam(1) );
-	else if( sName=="playcommand" )		PlayCommand( sParam(1) );
-	else if( sName=="queuecommand" )	
+	case AC_ANIMATE:					EnableAnimation( bParam(1) ); break;
+	case AC_SETSTATE:					SetState( iParam(1) ); break;
+	case AC_TEXTUREWRAPPING:			SetTextureWrapping( bParam(1) ); break;
+	case AC_ADDITIVEBLEND:				SetBlendMode( bParam(1) ? BLEND_ADD : BLEND_NORMAL ); break;
+	case AC_BLEND:						SetBlendMode( sParam(1) ); break;
+	case AC_ZBUFFER:					SetUseZBuffer( bParam(1) ); break;
+	case AC_ZTEST:						SetZTestMode( bParam(1)?ZTEST_WRITE_ON_PASS:ZTEST_OFF ); break;
+	case AC_ZTESTMODE:					SetZTestMode( sParam(1) ); break;
+	case AC_ZWRITE:						SetZWrite( bParam(1) ); break;
+	case AC_CLEARZBUFFER:				SetClearZBuffer( bParam(1) ); break;
+	case AC_BACKFACECULL:				SetCullMode( bParam(1) ? CULL_BACK : CULL_NONE ); break;
+	case AC_CULLMODE:					SetCullMode( sParam(1) ); break;
+	case AC_HIDDEN:						SetHidden( bParam(1) ); break;
+	case AC_HIBERNATE:					SetHibernate( fParam(1) ); break;
+	case AC_DRAWORDER:					SetDrawOrder( iParam(1) ); break;
+	case AC_PLAYCOMMAND:				PlayCommand( sParam(1) ); break;
+	case AC_QUEUECOMMAND:
 	{
 		ParsedCommand newcommand = command;
-		newcommand.vTokens.erase( newcommand.vTokens.begin() );
+		newcommand.EraseFirstToken();
 		QueueCommand( newcommand );
 		return;	// don't do parameter number checking
 	}
@@ -754,16 +879,24 @@ void Actor::HandleCommand( const ParsedCommand &command )
 	 * sent to all sub-actors (which aren't necessarily Sprites) on 
 	 * GainFocus and LoseFocus.  So, don't run CheckHandledParams 
 	 * on these commands. */
-	else if( sName=="customtexturerect" || sName=="texcoordvelocity" || sName=="scaletoclipped" ||
-		 sName=="stretchtexcoords" || sName=="position" || sName=="loop" || sName=="play" ||
-		 sName=="pause" || sName=="rate" )
+	case AC_CUSTOMTEXTURERECT:
+	case AC_TEXCOORDVELOCITY:
+	case AC_SCALETOCLIPPED:
+	case AC_STRETCHTEXCOORDS:
+	case AC_POSITION:
+	case AC_LOOP:
+	case AC_PLAY:
+	case AC_PAUSE:
+	case AC_RATE:
 		return;
-	else
+	default:
 	{
+		const CString sName = sParam(0);
 		CString sError = ssprintf( "Actor::HandleCommand: Unrecognized command name '%s'.", sName.c_str() );
 		LOG->Warn( sError );
 		Dialog::OK( sError );
 	}
+	}
 
 	CheckHandledParams;
 }
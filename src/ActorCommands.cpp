@@ -30,6 +30,14 @@ void ParsedCommand::Set( const CString &sCommand )
 
 	for( unsigned j=0; j<vsTokens.size(); j++ )
 		vTokens[j].Set( vsTokens[j] );
+
+	iNameID = vTokens.empty()? -1:GetCommandNameID( vTokens[0].s );
+}
+
+void ParsedCommand::EraseFirstToken()
+{
+	vTokens.erase( vTokens.begin() );
+	iNameID = vTokens.empty()? -1:GetCommandNameID( vTokens[0].s );
 }
 
 CString ParsedCommand::GetOriginalCommandString() const
@@ -52,6 +60,64 @@ void ParseCommands( const CString &sCommands, vector<ParsedCommand> &vCommandsOu
 		vCommandsOut[i].Set( vsCommands[i] );
 }
 
+/* Commands built with ssprintf would grow the cache without bound; past this
+ * many distinct strings, parse into the caller's scratch list instead. */
+static const unsigned MAX_COMPILED_COMMANDS = 2048;
+static map<CString, vector<ParsedCommand> > g_CompiledCommands;
+
+const vector<ParsedCommand> &CompileCommands( const CString &sCommands, vector<ParsedCommand> &vScratch )
+{
+	map<CString, vector<ParsedCommand> >::const_iterator it = g_CompiledCommands.find( sCommands );
+	if( it != g_CompiledCommands.end() )
+		return it->second;
+
+	CString sLower = sCommands;
+	sLower.MakeLower();
+
+	if( g_CompiledCommands.size() >= MAX_COMPILED_COMMANDS )
+	{
+		ParseCommands( sLower, vScratch );
+		return vScratch;
+	}
+
+	/* Entries are never removed, so references stay valid even if a command
+	 * runs another command that adds to the cache. */
+	vector<ParsedCommand> &vCommands = g_CompiledCommands[sCommands];
+	ParseCommands( sLower, vCommands );
+	return vCommands;
+}
+
+static map<CString,int> &GetCommandNameIDs()
+{
+	/* Function-local, so CommandNameTables built at static init time can use it. */
+	static map<CString,int> s_mapNameToID;
+	return s_mapNameToID;
+}
+
+int GetCommandNameID( const CString &sName )
+{
+	map<CString,int> &mapNameToID = GetCommandNameIDs();
+	map<CString,int>::const_iterator it = mapNameToID.find( sName );
+	if( it != mapNameToID.end() )
+		return it->second;
+
+	const int iID = mapNameToID.size();
+	mapNameToID[sName] = iID;
+	return iID;
+}
+
+CommandNameTable::CommandNameTable( const char *const szNames[], unsigned iNumNames )
+{
+	for( unsigned i = 0; i < iNumNames; ++i )
+	{
+		ASSERT_M( szNames[i] != NULL, ssprintf("%u", i) );	/* name list shorter than the enum */
+		const int iID = GetCommandNameID( szNames[i] );
+		if( iID >= (int) m_iNameIDToIndex.size() )
+			m_iNameIDToIndex.resize( iID+1, -1 );
+		m_iNameIDToIndex[iID] = i;
+	}
+}
+
 /*
  * (c) 2004 Chris Danford
  * All rights reserved.
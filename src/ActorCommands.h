@@ -25,9 +25,12 @@ struct ParsedCommandToken
 
 struct ParsedCommand
 {
+	ParsedCommand() { iNameID = -1; }
 	void Set( const CString &sCommand );
+	void EraseFirstToken();
 
 	vector<ParsedCommandToken> vTokens;
+	int iNameID;	// vTokens[0] interned by GetCommandNameID; -1 if no tokens
 
 	CString GetOriginalCommandString() const;	// for when reporting an error in number of params
 };
@@ -36,6 +39,32 @@ struct ParsedCommand
 // string.  sCommand list is a list of commands separated by ';'.
 void ParseCommands( const CString &sCommands, vector<ParsedCommand> &vCommandsOut );
 
+// Lowercase and parse sCommands once, and keep the result keyed by the source
+// string; running the same command string again does no string work.  Returns
+// the cached list, or vScratch if the cache is full.
+const vector<ParsedCommand> &CompileCommands( const CString &sCommands, vector<ParsedCommand> &vScratch );
+
+// Command names are interned to small integers when a command is parsed, so
+// handlers can dispatch on an integer instead of comparing strings.
+int GetCommandNameID( const CString &sName );
+
+// A handler's command names, in the order of its own enum.  Lookup maps a
+// command to an index into that list, or -1 if it isn't one of ours.
+class CommandNameTable
+{
+public:
+	CommandNameTable( const char *const szNames[], unsigned iNumNames );
+	int Lookup( const ParsedCommand &command ) const
+	{
+		if( command.iNameID < 0 || command.iNameID >= (int) m_iNameIDToIndex.size() )
+			return -1;
+		return m_iNameIDToIndex[command.iNameID];
+	}
+
+private:
+	vector<int> m_iNameIDToIndex;
+};
+
 
 #define HandleParams int iMaxIndexAccessed = 0;
 #define sParam(i) (GetParam<CString>(command,i,iMaxIndexAccessed))
@@ -19,44 +19,13 @@ static float GetNoteFieldHeight( PlayerNumber pn )
 	return SCREEN_HEIGHT + fabsf(GAMESTATE->m_CurrentPlayerOptions[pn].m_fPerspectiveTilt)*200;
 }
 
-float ArrowGetYOffset( PlayerNumber pn, int iCol, float fNoteBeat )
+/* Boost, brake, wave and boomerang; only applies to arrows that haven't passed yet. */
+static float ApplyAccels( const float* fAccels, float fEffectHeight, float fYOffset )
 {
-	float fYOffset = 0;
-
-	/* Usually, fTimeSpacing is 0 or 1, in which case we use entirely beat spacing or
-	 * entirely time spacing (respectively).  Occasionally, we tween between them. */
-	if( GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing != 1.0f )
-	{
-		float fSongBeat = GAMESTATE->m_fSongBeat;
-		float fBeatsUntilStep = fNoteBeat - fSongBeat;
-		float fYOffsetBeatSpacing = fBeatsUntilStep * ARROW_SPACING;
-		fYOffset += fYOffsetBeatSpacing * (1-GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing);
-	}
-
-	if( GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing != 0.0f )
-	{
-		float fSongSeconds = GAMESTATE->m_fMusicSeconds;
-		float fNoteSeconds = GAMESTATE->m_pCurSong->GetElapsedTimeFromBeat(fNoteBeat);
-		float fSecondsUntilStep = fNoteSeconds - fSongSeconds;
-		float fBPM = GAMESTATE->m_CurrentPlayerOptions[pn].m_fScrollBPM;
-		float fBPS = fBPM/60.f;
-		float fYOffsetTimeSpacing = fSecondsUntilStep * fBPS * ARROW_SPACING;
-		fYOffset += fYOffsetTimeSpacing * GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing;
-	}
-
-	// don't mess with the arrows after they've crossed 0
-	if( fYOffset < 0 )
-		return fYOffset * GAMESTATE->m_CurrentPlayerOptions[pn].m_fScrollSpeed;
-
-	const float* fAccels = GAMESTATE->m_CurrentPlayerOptions[pn].m_fAccels;
-	//const float* fEffects = GAMESTATE->m_CurrentPlayerOptions[pn].m_fEffects;
-
-
 	float fYAdjust = 0;	// fill this in depending on PlayerOptions
 
 	if( fAccels[PlayerOptions::ACCEL_BOOST] > 0 )
 	{
-		float fEffectHeight = GetNoteFieldHeight(pn);
 		float fNewYOffset = fYOffset * 1.5f / ((fYOffset+fEffectHeight/1.2f)/fEffectHeight); 
 		float fAccelYAdjust = fAccels[PlayerOptions::ACCEL_BOOST] * (fNewYOffset - fYOffset);
 		// TRICKY:	Clamp this value, or else BOOST+BOOMERANG will draw a ton of arrows on the screen.
@@ -65,7 +34,6 @@ float ArrowGetYOffset( PlayerNumber pn, int iCol, float fNoteBeat )
 	}
 	if( fAccels[PlayerOptions::ACCEL_BRAKE] > 0 )
 	{
-		float fEffectHeight = GetNoteFieldHeight(pn);
 		float fScale = SCALE( fYOffset, 0.f, fEffectHeight, 0, 1.f );
 		float fNewYOffset = fYOffset * fScale; 
 		float fBrakeYAdjust = fAccels[PlayerOptions::ACCEL_BRAKE] * (fNewYOffset - fYOffset);
@@ -81,6 +49,13 @@ float ArrowGetYOffset( PlayerNumber pn, int iCol, float fNoteBeat )
 	if( fAccels[PlayerOptions::ACCEL_BOOMERANG] > 0 )
 		fYOffset +=	fAccels[PlayerOptions::ACCEL_BOOMERANG] * (fYOffset * SCALE( fYOffset, 0.f, SCREEN_HEIGHT, 1.5f, 0.5f )- fYOffset);
 
+	return fYOffset;
+}
+
+/* Scroll speed with expand applied.  This advances the expand timer. */
+static float GetExpandedScrollSpeed( PlayerNumber pn )
+{
+	const float* fAccels = GAMESTATE->m_CurrentPlayerOptions[pn].m_fAccels;
 	float fScrollSpeed = GAMESTATE->m_CurrentPlayerOptions[pn].m_fScrollSpeed;
 
 	if( fAccels[PlayerOptions::ACCEL_EXPAND] > 0 )
@@ -95,7 +70,40 @@ float ArrowGetYOffset( PlayerNumber pn, int iCol, float fNoteBeat )
 		fScrollSpeed *=	SCALE( fAccels[PlayerOptions::ACCEL_EXPAND], 0.f, 1.f, 1.f, fExpandMultiplier );
 	}
 
-	fYOffset *= fScrollSpeed;
+	return fScrollSpeed;
+}
+
+float ArrowGetYOffset( PlayerNumber pn, int iCol, float fNoteBeat )
+{
+	float fYOffset = 0;
+
+	/* Usually, fTimeSpacing is 0 or 1, in which case we use entirely beat spacing or
+	 * entirely time spacing (respectively).  Occasionally, we tween between them. */
+	if( GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing != 1.0f )
+	{
+		float fSongBeat = GAMESTATE->m_fSongBeat;
+		float fBeatsUntilStep = fNoteBeat - fSongBeat;
+		float fYOffsetBeatSpacing = fBeatsUntilStep * ARROW_SPACING;
+		fYOffset += fYOffsetBeatSpacing * (1-GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing);
+	}
+
+	if( GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing != 0.0f )
+	{
+		float fSongSeconds = GAMESTATE->m_fMusicSeconds;
+		float fNoteSeconds = GAMESTATE->m_pCurSong->GetElapsedTimeFromBeat(fNoteBeat);
+		float fSecondsUntilStep = fNoteSeconds - fSongSeconds;
+		float fBPM = GAMESTATE->m_CurrentPlayerOptions[pn].m_fScrollBPM;
+		float fBPS = fBPM/60.f;
+		float fYOffsetTimeSpacing = fSecondsUntilStep * fBPS * ARROW_SPACING;
+		fYOffset += fYOffsetTimeSpacing * GAMESTATE->m_CurrentPlayerOptions[pn].m_fTimeSpacing;
+	}
+
+	// don't mess with the arrows after they've crossed 0
+	if( fYOffset < 0 )
+		return fYOffset * GAMESTATE->m_CurrentPlayerOptions[pn].m_fScrollSpeed;
+
+	fYOffset = ApplyAccels( GAMESTATE->m_CurrentPlayerOptions[pn].m_fAccels, GetNoteFieldHeight(pn), fYOffset );
+	fYOffset *= GetExpandedScrollSpeed( pn );
 
 	return fYOffset;
 }
@@ -153,6 +161,51 @@ float ArrowGetYOffsetFromYPos( PlayerNumber pn, int iCol, float YPos, float fYRe
 	return f;
 }
 
+/* Amount of EFFECT_BEAT right now; returns false if it has no effect this frame. */
+static bool GetBeatAmount( float &fAmountOut )
+{
+	float fAccelTime = 0.2f, fTotalTime = 0.5f;
+	
+	/* If the song is really fast, slow down the rate, but speed up the
+	 * acceleration to compensate or it'll look weird. */
+	const float fBPM = GAMESTATE->m_fCurBPS * 60;
+	const float fDiv = max(1.0f, truncf( fBPM / 150.0f ));
+	fAccelTime /= fDiv;
+	fTotalTime /= fDiv;
+
+	float fBeat = GAMESTATE->m_fSongBeat + fAccelTime;
+	fBeat /= fDiv;
+
+	const bool bEvenBeat = ( int(fBeat) & 1 ) != 0;
+
+	/* -100.2 -> -0.2 -> 0.2 */
+	if( fBeat < 0 )
+		return false;
+
+	fBeat -= truncf( fBeat );
+	fBeat += 1;
+	fBeat -= truncf( fBeat );
+
+	if( fBeat >= fTotalTime )
+		return false;
+
+	float fAmount;
+	if( fBeat < fAccelTime )
+	{
+		fAmount = SCALE( fBeat, 0.0f, fAccelTime, 0.0f, 1.0f);
+		fAmount *= fAmount;
+	} else /* fBeat < fTotalTime */ {
+		fAmount = SCALE( fBeat, fAccelTime, fTotalTime, 1.0f, 0.0f);
+		fAmount = 1 - (1-fAmount) * (1-fAmount);
+	}
+
+	if( bEvenBeat )
+		fAmount = -fAmount;
+
+	fAmountOut = fAmount;
+	return true;
+}
+
 float ArrowGetXPos( PlayerNumber pn, int iColNum, float fYOffset ) 
 {
 	float fPixelOffsetFromCenter = 0;
@@ -202,49 +255,12 @@ float ArrowGetXPos( PlayerNumber pn, int iColNum, float fYOffset )
 		fPixelOffsetFromCenter += fDistance * fEffects[PlayerOptions::EFFECT_FLIP];
 	}
 
-	if( fEffects[PlayerOptions::EFFECT_BEAT] > 0 )
-	do {
-		float fAccelTime = 0.2f, fTotalTime = 0.5f;
-		
-		/* If the song is really fast, slow down the rate, but speed up the
-		 * acceleration to compensate or it'll look weird. */
-		const float fBPM = GAMESTATE->m_fCurBPS * 60;
-		const float fDiv = max(1.0f, truncf( fBPM / 150.0f ));
-		fAccelTime /= fDiv;
-		fTotalTime /= fDiv;
-
-		float fBeat = GAMESTATE->m_fSongBeat + fAccelTime;
-		fBeat /= fDiv;
-
-		const bool bEvenBeat = ( int(fBeat) & 1 ) != 0;
-
-		/* -100.2 -> -0.2 -> 0.2 */
-		if( fBeat < 0 )
-			break;
-
-		fBeat -= truncf( fBeat );
-		fBeat += 1;
-		fBeat -= truncf( fBeat );
-
-		if( fBeat >= fTotalTime )
-			break;
-
-		float fAmount;
-		if( fBeat < fAccelTime )
-		{
-			fAmount = SCALE( fBeat, 0.0f, fAccelTime, 0.0f, 1.0f);
-			fAmount *= fAmount;
-		} else /* fBeat < fTotalTime */ {
-			fAmount = SCALE( fBeat, fAccelTime, fTotalTime, 1.0f, 0.0f);
-			fAmount = 1 - (1-fAmount) * (1-fAmount);
-		}
-
-		if( bEvenBeat )
-			fAmount = -fAmount;
-
+	float fAmount;
+	if( fEffects[PlayerOptions::EFFECT_BEAT] > 0 && GetBeatAmount(fAmount) )
+	{
 		const float fShift = 20.0f*fAmount*sinf( fYOffset / 15.0f + PI/2.0f );
 		fPixelOffsetFromCenter += fEffects[PlayerOptions::EFFECT_BEAT] * fShift;
-	} while(0);
+	}
 
 	return fPixelOffsetFromCenter;
 }
@@ -431,6 +447,362 @@ float ArrowGetZoom( PlayerNumber pn )
 	return 1.0f;
 }
 
+//
+// Batch evaluation.  Everything that's constant for a frame is snapshotted by
+// ArrowEffectsUpdate, so evaluating each arrow is only the per-arrow math, and
+// terms for modifiers that are off are skipped entirely.
+//
+struct ArrowEffectsFrame
+{
+	float fSongBeat;
+	float fMusicSeconds;
+
+	float fTimeSpacing;
+	float fScrollBPM;
+	float fScrollSpeed;			// for arrows that have passed
+	float fExpandedScrollSpeed;	// for everything else
+	float fNoteFieldHeight;
+	bool bAccels;
+	float fAccels[PlayerOptions::NUM_ACCELS];
+
+	float fMiniPercent;
+	float fCentered;
+	float fReversePercent[MAX_COLS_PER_PLAYER];
+
+	bool bTipsy;
+	float fTipsy[MAX_COLS_PER_PLAYER];			// added by ArrowGetYPos
+	float fTipsyInverse[MAX_COLS_PER_PLAYER];	// subtracted by ArrowGetYOffsetFromYPos
+
+	float fTornado;
+	float fTornadoMinX[MAX_COLS_PER_PLAYER];
+	float fTornadoMaxX[MAX_COLS_PER_PLAYER];
+	float fTornadoRealX[MAX_COLS_PER_PLAYER];
+	float fTornadoRads[MAX_COLS_PER_PLAYER];
+	float fDrunk;
+	float fDrunkPhase[MAX_COLS_PER_PLAYER];
+	float fFlip;
+	float fFlipShift[MAX_COLS_PER_PLAYER];
+	float fBeat;
+	bool bBeatActive;
+	float fBeatAmount;
+	float fBumpy;
+
+	bool bAppearances;
+	float fAppearances[PlayerOptions::NUM_APPEARANCES];
+	float fCenterLine;
+	float fHiddenStartLine, fHiddenEndLine;
+	float fSuddenStartLine, fSuddenEndLine;
+	float fBlinkAdjust;
+};
+
+static ArrowEffectsFrame g_Frame[NUM_PLAYERS];
+
+void ArrowEffectsUpdate( PlayerNumber pn )
+{
+	ArrowEffectsFrame &f = g_Frame[pn];
+	PlayerOptions &po = GAMESTATE->m_CurrentPlayerOptions[pn];
+	const float* fEffects = po.m_fEffects;
+	const Style* pStyle = GAMESTATE->GetCurrentStyle();
+	const int iNumCols = min( pStyle->m_iColsPerPlayer, MAX_COLS_PER_PLAYER );
+	const float fTime = RageTimer::GetTimeSinceStart();
+
+	f.fSongBeat = GAMESTATE->m_fSongBeat;
+	f.fMusicSeconds = GAMESTATE->m_fMusicSeconds;
+
+	f.fTimeSpacing = po.m_fTimeSpacing;
+	f.fScrollBPM = po.m_fScrollBPM;
+	f.fScrollSpeed = po.m_fScrollSpeed;
+	f.fExpandedScrollSpeed = GetExpandedScrollSpeed( pn );
+	f.fNoteFieldHeight = GetNoteFieldHeight( pn );
+	memcpy( f.fAccels, po.m_fAccels, sizeof(f.fAccels) );
+	f.bAccels =
+		f.fAccels[PlayerOptions::ACCEL_BOOST] > 0 ||
+		f.fAccels[PlayerOptions::ACCEL_BRAKE] > 0 ||
+		f.fAccels[PlayerOptions::ACCEL_WAVE] > 0 ||
+		f.fAccels[PlayerOptions::ACCEL_BOOMERANG] > 0;
+
+	f.fMiniPercent = fEffects[PlayerOptions::EFFECT_MINI];
+	f.fCentered = po.m_fScrolls[PlayerOptions::SCROLL_CENTERED];
+	f.bTipsy = fEffects[PlayerOptions::EFFECT_TIPSY] > 0;
+	f.fTornado = fEffects[PlayerOptions::EFFECT_TORNADO];
+	f.fDrunk = fEffects[PlayerOptions::EFFECT_DRUNK];
+	f.fFlip = fEffects[PlayerOptions::EFFECT_FLIP];
+	f.fBeat = fEffects[PlayerOptions::EFFECT_BEAT];
+	f.fBumpy = fEffects[PlayerOptions::EFFECT_BUMPY];
+
+	const Style::ColumnInfo *columnInfo = pStyle->m_ColumnInfo[pn];
+	for( int c=0; c<iNumCols; c++ )
+	{
+		f.fReversePercent[c] = po.GetReversePercentForColumn( c );
+
+		if( f.bTipsy )
+		{
+			f.fTipsy[c] = fEffects[PlayerOptions::EFFECT_TIPSY] * ( cosf( fTime*1.2f + c*1.8f) * ARROW_SIZE*0.4f );
+			f.fTipsyInverse[c] = fEffects[PlayerOptions::EFFECT_TIPSY] * ( cosf( fTime*1.2f + c*2.f) * ARROW_SIZE*0.4f );
+		}
+
+		if( f.fTornado > 0 )
+		{
+			bool bWideField = pStyle->m_iColsPerPlayer > 4;
+			int iTornadoWidth = bWideField ? 2 : 3;
+
+			int iStartCol = c - iTornadoWidth;
+			int iEndCol = c + iTornadoWidth;
+			CLAMP( iStartCol, 0, pStyle->m_iColsPerPlayer-1 );
+			CLAMP( iEndCol, 0, pStyle->m_iColsPerPlayer-1 );
+
+			float fMinX = +100000;
+			float fMaxX = -100000;
+			for( int i=iStartCol; i<=iEndCol; i++ )
+			{
+				fMinX = min( fMinX, columnInfo[i].fXOffset );
+				fMaxX = max( fMaxX, columnInfo[i].fXOffset );
+			}
+
+			f.fTornadoMinX[c] = fMinX;
+			f.fTornadoMaxX[c] = fMaxX;
+			f.fTornadoRealX[c] = columnInfo[c].fXOffset;
+			f.fTornadoRads[c] = acosf( SCALE( f.fTornadoRealX[c], fMinX, fMaxX, -1, 1 ) );
+		}
+
+		f.fDrunkPhase[c] = fTime + c*0.2f;
+		f.fFlipShift[c] = (-columnInfo[c].fXOffset * 2) * f.fFlip;
+	}
+
+	f.bBeatActive = f.fBeat > 0 && GetBeatAmount( f.fBeatAmount );
+
+	memcpy( f.fAppearances, po.m_fAppearances, sizeof(f.fAppearances) );
+	f.bAppearances = false;
+	for( int a=0; a<PlayerOptions::NUM_APPEARANCES; a++ )
+		if( f.fAppearances[a] > 0 )
+			f.bAppearances = true;
+	f.fCenterLine = GetCenterLine( pn );
+	f.fHiddenStartLine = GetHiddenStartLine( pn );
+	f.fHiddenEndLine = GetHiddenEndLine( pn );
+	f.fSuddenStartLine = GetSuddenStartLine( pn );
+	f.fSuddenEndLine = GetSuddenEndLine( pn );
+	{
+		float fBlink = sinf( fTime*10 );
+		fBlink = froundf( fBlink, 0.3333f );
+		f.fBlinkAdjust = SCALE( fBlink, 0, 1, -1, 0 );
+	}
+}
+
+void ArrowGetYOffsets( PlayerNumber pn, const float *pNoteBeats, float *pYOffsetsOut, int iCount )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+	const bool bBeatSpacing = f.fTimeSpacing != 1.0f;
+	const bool bTimeSpacing = f.fTimeSpacing != 0.0f;
+	const float fBPS = f.fScrollBPM/60.f;
+
+	/* Convert all of the beats to times at once. */
+	static vector<float> vfNoteSeconds;
+	if( bTimeSpacing )
+	{
+		vfNoteSeconds.resize( iCount );
+		if( iCount )
+			GAMESTATE->m_pCurSong->m_Timing.GetElapsedTimesFromBeats( pNoteBeats, &vfNoteSeconds[0], iCount );
+	}
+
+	for( int i=0; i<iCount; i++ )
+	{
+		const float fNoteBeat = pNoteBeats[i];
+		float fYOffset = 0;
+
+		if( bBeatSpacing )
+		{
+			float fBeatsUntilStep = fNoteBeat - f.fSongBeat;
+			float fYOffsetBeatSpacing = fBeatsUntilStep * ARROW_SPACING;
+			fYOffset += fYOffsetBeatSpacing * (1-f.fTimeSpacing);
+		}
+
+		if( bTimeSpacing )
+		{
+			float fSecondsUntilStep = vfNoteSeconds[i] - f.fMusicSeconds;
+			float fYOffsetTimeSpacing = fSecondsUntilStep * fBPS * ARROW_SPACING;
+			fYOffset += fYOffsetTimeSpacing * f.fTimeSpacing;
+		}
+
+		// don't mess with the arrows after they've crossed 0
+		if( fYOffset < 0 )
+		{
+			pYOffsetsOut[i] = fYOffset * f.fScrollSpeed;
+			continue;
+		}
+
+		if( f.bAccels )
+			fYOffset = ApplyAccels( f.fAccels, f.fNoteFieldHeight, fYOffset );
+		pYOffsetsOut[i] = fYOffset * f.fExpandedScrollSpeed;
+	}
+}
+
+/* Same as ArrowGetReverseShiftAndScale, against the snapshot. */
+static void GetReverseShiftAndScale( const ArrowEffectsFrame &f, int iCol, float fYReverseOffsetPixels, float &fShiftOut, float &fScaleOut )
+{
+	float fZoom = 1 - f.fMiniPercent*0.5f;
+	float fPercentReverse = f.fReversePercent[iCol];
+	fShiftOut = SCALE( fPercentReverse, 0.f, 1.f, -fYReverseOffsetPixels/fZoom*0.5f, fYReverseOffsetPixels/fZoom*0.5f );
+	fShiftOut = SCALE( f.fCentered, 0.f, 1.f, fShiftOut, 0.5f );
+	fScaleOut = SCALE( fPercentReverse, 0.f, 1.f, 1.f, -1.f);
+}
+
+void ArrowGetYPositions( PlayerNumber pn, int iCol, const float *pYOffsets, float *pYPosOut, int iCount, float fYReverseOffsetPixels )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+
+	float fShift, fScale;
+	GetReverseShiftAndScale( f, iCol, fYReverseOffsetPixels, fShift, fScale );
+
+	for( int i=0; i<iCount; i++ )
+	{
+		float fYPos = pYOffsets[i] * fScale + fShift;
+		if( f.bTipsy )
+			fYPos += f.fTipsy[iCol];
+		pYPosOut[i] = fYPos;
+	}
+}
+
+void ArrowGetYOffsetsFromYPos( PlayerNumber pn, int iCol, const float *pYPos, float *pYOffsetsOut, int iCount, float fYReverseOffsetPixels )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+
+	float fShift, fScale;
+	GetReverseShiftAndScale( f, iCol, fYReverseOffsetPixels, fShift, fScale );
+
+	for( int i=0; i<iCount; i++ )
+	{
+		float fYOffset = pYPos[i];
+		if( f.bTipsy )
+			fYOffset -= f.fTipsyInverse[iCol];
+		fYOffset -= fShift;
+		if( fScale )
+			fYOffset /= fScale;
+		pYOffsetsOut[i] = fYOffset;
+	}
+}
+
+void ArrowGetXPositions( PlayerNumber pn, int iCol, const float *pYOffsets, float *pXOut, int iCount )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+
+	for( int i=0; i<iCount; i++ )
+	{
+		const float fYOffset = pYOffsets[i];
+		float fPixelOffsetFromCenter = 0;
+
+		if( f.fTornado > 0 )
+		{
+			float fRads = f.fTornadoRads[iCol];
+			fRads += fYOffset * 6 / SCREEN_HEIGHT;
+			const float fAdjustedPixelOffset = SCALE( cosf(fRads), -1, 1, f.fTornadoMinX[iCol], f.fTornadoMaxX[iCol] );
+			fPixelOffsetFromCenter += (fAdjustedPixelOffset - f.fTornadoRealX[iCol]) * f.fTornado;
+		}
+		if( f.fDrunk > 0 )
+			fPixelOffsetFromCenter += f.fDrunk * ( cosf( f.fDrunkPhase[iCol] + fYOffset*10/SCREEN_HEIGHT) * ARROW_SIZE*0.5f );
+		if( f.fFlip > 0 )
+			fPixelOffsetFromCenter += f.fFlipShift[iCol];
+		if( f.bBeatActive )
+		{
+			const float fShift = 20.0f*f.fBeatAmount*sinf( fYOffset / 15.0f + PI/2.0f );
+			fPixelOffsetFromCenter += f.fBeat * fShift;
+		}
+
+		pXOut[i] = fPixelOffsetFromCenter;
+	}
+}
+
+void ArrowGetZPositions( PlayerNumber pn, const float *pYOffsets, float *pZOut, int iCount )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+
+	if( !(f.fBumpy > 0) )
+	{
+		for( int i=0; i<iCount; i++ )
+			pZOut[i] = 0;
+		return;
+	}
+
+	for( int i=0; i<iCount; i++ )
+		pZOut[i] = 0 + f.fBumpy * 40*sinf( pYOffsets[i]/16.0f );
+}
+
+/* Same as ArrowGetPercentVisible, against the snapshot. */
+static float GetPercentVisible( const ArrowEffectsFrame &f, int iCol, float fYOffset )
+{
+	float fYPos = fYOffset;
+	if( f.bTipsy )
+		fYPos += f.fTipsy[iCol];
+
+	const float fDistFromCenterLine = fYPos - f.fCenterLine;
+
+	if( fYPos < 0 )	// past Gray Arrows
+		return 1;	// totally visible
+
+	const float* fAppearances = f.fAppearances;
+
+	float fVisibleAdjust = 0;
+
+	if( fAppearances[PlayerOptions::APPEARANCE_HIDDEN] > 0 )
+	{
+		float fHiddenVisibleAdjust = SCALE( fYPos, f.fHiddenStartLine, f.fHiddenEndLine, 0, -1 );
+		CLAMP( fHiddenVisibleAdjust, -1, 0 );
+		fVisibleAdjust += fAppearances[PlayerOptions::APPEARANCE_HIDDEN] * fHiddenVisibleAdjust;
+	}
+	if( fAppearances[PlayerOptions::APPEARANCE_SUDDEN] > 0 )
+	{
+		float fSuddenVisibleAdjust = SCALE( fYPos, f.fSuddenStartLine, f.fSuddenEndLine, -1, 0 );
+		CLAMP( fSuddenVisibleAdjust, -1, 0 );
+		fVisibleAdjust += fAppearances[PlayerOptions::APPEARANCE_SUDDEN] * fSuddenVisibleAdjust;
+	}
+
+	if( fAppearances[PlayerOptions::APPEARANCE_STEALTH] > 0 )
+		fVisibleAdjust -= fAppearances[PlayerOptions::APPEARANCE_STEALTH];
+	if( fAppearances[PlayerOptions::APPEARANCE_BLINK] > 0 )
+		fVisibleAdjust += f.fBlinkAdjust;
+	if( fAppearances[PlayerOptions::APPEARANCE_RANDOMVANISH] > 0)
+	{
+		const float fRealFadeDist = 80;
+		fVisibleAdjust += SCALE( fabsf(fDistFromCenterLine), fRealFadeDist, 2*fRealFadeDist, -1, 0 )
+			* fAppearances[PlayerOptions::APPEARANCE_RANDOMVANISH];
+	}
+
+	return clamp( 1+fVisibleAdjust, 0, 1 );
+}
+
+static void GetPercentsVisible( PlayerNumber pn, int iCol, const float *pYOffsets, float *pOut, int iCount, float fPercentFadeToFail )
+{
+	const ArrowEffectsFrame &f = g_Frame[pn];
+
+	/* Fading to fail and having no appearance mods both make every arrow the same. */
+	if( fPercentFadeToFail != -1 || !f.bAppearances )
+	{
+		const float fPercentVisible = (fPercentFadeToFail != -1)? 1 - fPercentFadeToFail: 1;
+		for( int i=0; i<iCount; i++ )
+			pOut[i] = fPercentVisible;
+		return;
+	}
+
+	for( int i=0; i<iCount; i++ )
+		pOut[i] = GetPercentVisible( f, iCol, pYOffsets[i] );
+}
+
+void ArrowGetAlphas( PlayerNumber pn, int iCol, const float *pYOffsets, float *pAlphaOut, int iCount, float fPercentFadeToFail )
+{
+	GetPercentsVisible( pn, iCol, pYOffsets, pAlphaOut, iCount, fPercentFadeToFail );
+	for( int i=0; i<iCount; i++ )
+		pAlphaOut[i] = (pAlphaOut[i]>0.5f) ? 1.0f : 0.0f;
+}
+
+void ArrowGetGlows( PlayerNumber pn, int iCol, const float *pYOffsets, float *pGlowOut, int iCount, float fPercentFadeToFail )
+{
+	GetPercentsVisible( pn, iCol, pYOffsets, pGlowOut, iCount, fPercentFadeToFail );
+	for( int i=0; i<iCount; i++ )
+	{
+		const float fDistFromHalf = fabsf( pGlowOut[i] - 0.5f );
+		pGlowOut[i] = SCALE( fDistFromHalf, 0, 0.5f, 1.3f, 0 );
+	}
+}
+
 /*
  * (c) 2001-2004 Chris Danford
  * All rights reserved.
@@ -54,6 +54,19 @@ float ArrowGetBrightness( PlayerNumber pn, float fNoteBeat );
 // This is the zoom of the individual tracks, not of the whole Player.
 float ArrowGetZoom( PlayerNumber pn );
 
+/* Batched versions of the above, for drawing many arrows at once.  Call
+ * ArrowEffectsUpdate once per frame before using them; everything that doesn't
+ * depend on the individual arrow is computed there, so the results match the
+ * single-arrow functions evaluated at that moment. */
+void ArrowEffectsUpdate( PlayerNumber pn );
+void ArrowGetYOffsets( PlayerNumber pn, const float *pNoteBeats, float *pYOffsetsOut, int iCount );
+void ArrowGetYPositions( PlayerNumber pn, int iCol, const float *pYOffsets, float *pYPosOut, int iCount, float fYReverseOffsetPixels );
+void ArrowGetYOffsetsFromYPos( PlayerNumber pn, int iCol, const float *pYPos, float *pYOffsetsOut, int iCount, float fYReverseOffsetPixels );
+void ArrowGetXPositions( PlayerNumber pn, int iCol, const float *pYOffsets, float *pXOut, int iCount );
+void ArrowGetZPositions( PlayerNumber pn, const float *pYOffsets, float *pZOut, int iCount );
+void ArrowGetAlphas( PlayerNumber pn, int iCol, const float *pYOffsets, float *pAlphaOut, int iCount, float fPercentFadeToFail );
+void ArrowGetGlows( PlayerNumber pn, int iCol, const float *pYOffsets, float *pGlowOut, int iCount, float fPercentFadeToFail );
+
 #endif
 
 /*
@@ -79,6 +79,8 @@ void BGAnimationLayer::Init()
 	m_fUpdateRate = 1;
 	m_fFOV = -1;	// no change
 	m_bLighting = false;
+	m_sDrawCond = "";
+	m_DrawCond = Lua::INVALID_EXPRESSION;
 
 //	m_bCycleColor = false;
 //	m_bCycleAlpha = false;
@@ -532,7 +534,8 @@ void BGAnimationLayer::LoadFromIni( CString sAniDir, const CString &sLayer )
 	ini.GetValue( sLayer, "Lighting", m_bLighting );
 	ini.GetValue( sLayer, "TexCoordVelocityX", m_fTexCoordVelocityX );
 	ini.GetValue( sLayer, "TexCoordVelocityY", m_fTexCoordVelocityY );
-	ini.GetValue( sLayer, "DrawCond", m_sDrawCond );
+	if( ini.GetValue( sLayer, "DrawCond", m_sDrawCond ) && !m_sDrawCond.empty() )
+		m_DrawCond = Lua::CompileExpression( m_sDrawCond );
 
 	// compat:
 	ini.GetValue( sLayer, "StretchTexCoordVelocityX", m_fTexCoordVelocityX );
@@ -933,10 +936,10 @@ void BGAnimationLayer::Update( float fDeltaTime )
 
 bool BGAnimationLayer::EarlyAbortDraw()
 {
-	if( m_sDrawCond.empty() )
+	if( m_DrawCond == Lua::INVALID_EXPRESSION )
 		return false;
 
-	if( !Lua::RunExpression( m_sDrawCond ) )
+	if( !Lua::RunExpression( m_DrawCond ) )
 		return true;
 
 	return false;
@@ -5,6 +5,7 @@
 
 #include "GameConstantsAndTypes.h"
 #include "ActorFrame.h"
+#include "LuaHelpers.h"
 #include <map>
 
 class BGAnimationLayer : public ActorFrame
@@ -89,6 +90,7 @@ protected:
 	bool m_bLighting;
 
 	CString m_sDrawCond;
+	Lua::ExpressionHandle m_DrawCond;	/* compiled m_sDrawCond, evaluated every frame */
 
 	// stretch stuff
 	float m_fTexCoordVelocityX;
@@ -59,6 +59,8 @@ void BannerCache::LoadBanner( const CString &BannerPath )
 	if( PREFSMAN->m_BannerCache != PrefsManager::BNCACHE_LOW_RES || BannerPath == "" )
 		return;
 
+	LockMut( m_Mutex );
+
 	/* Load it. */
 	const CString CachePath = GetBannerCachePath(BannerPath);
 
@@ -114,7 +116,8 @@ void BannerCache::UnloadAllBanners()
 	g_BannerPathToImage.clear();
 }
 
-BannerCache::BannerCache()
+BannerCache::BannerCache():
+	m_Mutex( "BannerCache" )
 {
 	BannerData.ReadFile( BANNER_CACHE_INDEX );	// don't care if this fails
 }
@@ -279,6 +282,7 @@ void BannerCache::CacheBanner( const CString &BannerPath )
 	if( PREFSMAN->m_BannerCache != PrefsManager::BNCACHE_LOW_RES )
 		return;
 
+	LockMut( m_Mutex );
 	CHECKPOINT_M( BannerPath );
 	if( !DoesFileExist(BannerPath) )
 		return;
@@ -6,6 +6,7 @@
 #include "IniFile.h"
 
 #include "RageTexture.h"
+#include "RageThreads.h"
 
 class LoadingWindow;
 
@@ -13,6 +14,9 @@ class BannerCache
 {
 	IniFile BannerData;
 
+	/* CacheBanner and LoadBanner may be called from song loading threads. */
+	RageMutex m_Mutex;
+
 	static CString GetBannerCachePath( const CString &BannerPath );
 	void UnloadAllBanners();
 	void CacheBannerInternal( const CString &BannerPath );
@@ -306,6 +306,22 @@ void BitmapText::SetText( CString sText, const CString &sAlternateText, int iWra
 	m_sText = sText;
 	m_iWrapWidthPixels = iWrapWidthPixels;
 
+	/* Wrapping and building quads is most of the cost of SetText, and the same
+	 * strings are set over and over (scores, menu items); reuse the font's copy. */
+	const CString sLayoutKey = ssprintf( "%i|%i|%i|", m_HorizAlign, m_VertAlign, iWrapWidthPixels ) + sText;
+	const FontTextLayout *pLayout = m_pFont->GetCachedLayout( sLayoutKey );
+	if( pLayout != NULL )
+	{
+		m_wTextLines = pLayout->wTextLines;
+		m_iLineWidths = pLayout->iLineWidths;
+		verts = pLayout->verts;
+		tex = pLayout->tex;
+		m_size.x = pLayout->size.x;
+		if( !m_wTextLines.empty() )
+			m_size.y = pLayout->size.y;
+		UpdateBaseZoom();
+		return;
+	}
 
 	// Break the string into lines.
 	//
@@ -369,6 +385,15 @@ void BitmapText::SetText( CString sText, const CString &sAlternateText, int iWra
 	}
 
 	BuildChars();
+
+	FontTextLayout layout;
+	layout.wTextLines = m_wTextLines;
+	layout.iLineWidths = m_iLineWidths;
+	layout.verts = verts;
+	layout.tex = tex;
+	layout.size = m_size;
+	m_pFont->CacheLayout( sLayoutKey, layout );
+
 	UpdateBaseZoom();
 }
 
@@ -519,18 +544,31 @@ void BitmapText::SetVertAlign( VertAlign va )
 	BuildChars();
 }
 
+enum BitmapTextCommand
+{
+	BTC_WRAPWIDTHPIXELS,
+	BTC_MAXWIDTH,
+	NUM_BITMAPTEXT_COMMANDS
+};
+
+static const char *const g_szBitmapTextCommandNames[NUM_BITMAPTEXT_COMMANDS] =
+{
+	"wrapwidthpixels", "maxwidth"
+};
+
+static const CommandNameTable g_BitmapTextCommands( g_szBitmapTextCommandNames, NUM_BITMAPTEXT_COMMANDS );
+
 void BitmapText::HandleCommand( const ParsedCommand &command )
 {
 	HandleParams;
 
-	const CString& sName = sParam(0);
-
 	// Commands that go in the tweening queue:
 	// Commands that take effect immediately (ignoring the tweening queue):
-	if( sName=="wrapwidthpixels" )		SetWrapWidthPixels( iParam(1) );
-	else if( sName=="maxwidth" )		SetMaxWidth( fParam(1) );
-	else
+	switch( g_BitmapTextCommands.Lookup(command) )
 	{
+	case BTC_WRAPWIDTHPIXELS:	SetWrapWidthPixels( iParam(1) ); break;
+	case BTC_MAXWIDTH:			SetMaxWidth( fParam(1) ); break;
+	default:
 		Actor::HandleCommand( command );
 		return;
 	}
@@ -210,6 +210,9 @@ Font::Font()
 
 	m_iRefCount = 1;
 	def = NULL;
+	m_pDefaultGlyph = NULL;
+	m_pGlyphTableGame = NULL;
+	m_bGlyphTableValid = false;
 }
 
 Font::~Font()
@@ -226,6 +229,7 @@ void Font::Unload()
 	pages.clear();
 	
 	m_iCharToGlyph.clear();
+	InvalidateGlyphTable();
 	def = NULL;
 
 	/* Don't clear the refcount.  We've unloaded, but that doesn't mean things
@@ -249,6 +253,7 @@ void Font::AddPage(FontPage *fp)
 	{
 		m_iCharToGlyph[it->first] = &fp->glyphs[it->second];
 	}
+	InvalidateGlyphTable();
 }
 
 void Font::MergeFont(Font &f)
@@ -265,30 +270,113 @@ void Font::MergeFont(Font &f)
 	{
 		m_iCharToGlyph[it->first] = it->second;
 	}
+	InvalidateGlyphTable();
 
 	pages.insert(pages.end(), f.pages.begin(), f.pages.end());
 
 	f.pages.clear();
 }
 
+void Font::InvalidateGlyphTable()
+{
+	m_bGlyphTableValid = false;
+	m_Layouts.clear();
+	m_LayoutIndex.clear();
+}
+
+void Font::BuildGlyphTable() const
+{
+	for( int i = 0; i < NUM_GLYPH_PAGES; ++i )
+		m_GlyphPages[i].clear();
+
+	map<longchar,glyph*>::const_iterator def = m_iCharToGlyph.find(DEFAULT_GLYPH);
+	m_pDefaultGlyph = def == m_iCharToGlyph.end()? NULL:def->second;
+	m_GlyphPages[0].resize( GLYPHS_PER_PAGE, m_pDefaultGlyph );
+
+	/* Game-specific characters sort after all regular characters, so they
+	 * overwrite the regular version of the same character. */
+	const longchar iGameBits = FontManager::MakeGameGlyph( 0, GAMESTATE->m_pCurGame );
+	for( map<longchar,glyph*>::const_iterator it = m_iCharToGlyph.begin(); it != m_iCharToGlyph.end(); ++it )
+	{
+		longchar c = it->first;
+		if( (c & ~0xFFFF) == iGameBits )
+			c &= 0xFFFF;
+		else if( c < 0 || c > 0xFFFF )
+			continue;	/* another game's character */
+
+		vector<glyph *> &page = m_GlyphPages[c / GLYPHS_PER_PAGE];
+		if( page.empty() )
+			page.resize( GLYPHS_PER_PAGE, m_pDefaultGlyph );
+		page[c % GLYPHS_PER_PAGE] = it->second;
+	}
+
+	m_pGlyphTableGame = GAMESTATE->m_pCurGame;
+	m_bGlyphTableValid = true;
+}
+
 const glyph &Font::GetGlyph( wchar_t c ) const
 {
 	ASSERT(c >= 0 && c <= 0xFFFFFF);
 
-	/* See if there's a game-specific version of this character. */
-	int gc = FontManager::MakeGameGlyph(c, GAMESTATE->m_pCurGame);
-	map<longchar,glyph*>::const_iterator it = m_iCharToGlyph.find(gc);
-
-	/* If there isn't, try the regular character. */
-	if(it == m_iCharToGlyph.end()) it = m_iCharToGlyph.find(c);
+	if( !m_bGlyphTableValid || m_pGlyphTableGame != GAMESTATE->m_pCurGame )
+	{
+		BuildGlyphTable();
+		/* Layouts were built with the other game's glyphs. */
+		const_cast<Font *>(this)->m_Layouts.clear();
+		const_cast<Font *>(this)->m_LayoutIndex.clear();
+	}
 
-	/* If *that's* missing, use the default glyph. */
-	if(it == m_iCharToGlyph.end()) it = m_iCharToGlyph.find(DEFAULT_GLYPH);
+	const glyph *pGlyph = m_pDefaultGlyph;
+	if( c <= 0xFFFF )
+	{
+		const vector<glyph *> &page = m_GlyphPages[c / GLYPHS_PER_PAGE];
+		if( !page.empty() )
+			pGlyph = page[c % GLYPHS_PER_PAGE];
+	}
+	else
+	{
+		map<longchar,glyph*>::const_iterator it = m_iCharToGlyph.find(c);
+		if( it != m_iCharToGlyph.end() )
+			pGlyph = it->second;
+	}
 
-	if(it == m_iCharToGlyph.end()) 
+	if( pGlyph == NULL )
 		RageException::Throw( "The default glyph is missing from the font '%s'", path.c_str() );
 	
-	return *it->second;
+	return *pGlyph;
+}
+
+const FontTextLayout *Font::GetCachedLayout( const CString &sKey )
+{
+	/* Make sure the glyph table (and so the layouts) is for the current game. */
+	if( !m_bGlyphTableValid || m_pGlyphTableGame != GAMESTATE->m_pCurGame )
+		return NULL;
+
+	map<CString, LayoutList::iterator>::iterator it = m_LayoutIndex.find( sKey );
+	if( it == m_LayoutIndex.end() )
+		return NULL;
+
+	m_Layouts.splice( m_Layouts.begin(), m_Layouts, it->second );
+	return &it->second->second;
+}
+
+void Font::CacheLayout( const CString &sKey, const FontTextLayout &layout )
+{
+	map<CString, LayoutList::iterator>::iterator it = m_LayoutIndex.find( sKey );
+	if( it != m_LayoutIndex.end() )
+	{
+		m_Layouts.erase( it->second );
+		m_LayoutIndex.erase( it );
+	}
+
+	if( m_Layouts.size() >= MAX_CACHED_LAYOUTS )
+	{
+		m_LayoutIndex.erase( m_Layouts.back().first );
+		m_Layouts.pop_back();
+	}
+
+	m_Layouts.push_front( make_pair(sKey, layout) );
+	m_LayoutIndex[sKey] = m_Layouts.begin();
 }
 
 bool Font::FontCompleteForString( const wstring &str ) const
@@ -320,6 +408,7 @@ void Font::CapsOnly()
 
 		m_iCharToGlyph[(char) tolower(c)] = it->second;
 	}
+	InvalidateGlyphTable();
 }
 
 void Font::SetDefaultGlyph(FontPage *fp)
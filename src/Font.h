@@ -7,9 +7,12 @@
 #include "RageUtil.h"
 #include "RageTypes.h"
 
+#include <list>
+
 class FontPage;
 class RageTexture;
 class IniFile;
+class Game;
 
 struct glyph {
 	FontPage *fp;
@@ -93,6 +96,16 @@ private:
 	void SetTextureCoords(const vector<int> &widths, int AdvanceExtraPixels);
 };
 
+/* A string laid out by BitmapText: its lines and the quads to draw them. */
+struct FontTextLayout
+{
+	vector<wstring> wTextLines;
+	vector<int> iLineWidths;
+	vector<RageSpriteVertex> verts;
+	vector<RageTexture *> tex;
+	RageVector2 size;
+};
+
 class Font
 {
 public:
@@ -134,6 +147,12 @@ public:
 	/* Remove filenames in 'v' that aren't in the same font as "FileName". */
 	static void WeedFontNames(vector<CString> &v, const CString &FileName);
 
+	/* A small LRU of layouts built from this font, keyed by the caller (text,
+	 * alignment, wrap width).  The returned pointer is valid until the next
+	 * CacheLayout.  Layouts are dropped when the font's glyphs change. */
+	const FontTextLayout *GetCachedLayout( const CString &sKey );
+	void CacheLayout( const CString &sKey, const FontTextLayout &layout );
+
 private:
 	/* List of pages and fonts that we use (and are responsible for freeing). */
 	vector<FontPage *> pages;
@@ -145,6 +164,24 @@ private:
 	/* Map from characters to glyphs.  (Each glyph* is part of one of pages[].) */
 	map<longchar,glyph*> m_iCharToGlyph;
 
+	/* m_iCharToGlyph flattened for the current game, so GetGlyph is two array
+	 * lookups: 256 pages of 256 characters each.  Page 0 (ASCII and Latin-1)
+	 * always exists; other pages exist only if the font has a glyph in them,
+	 * and an empty page means the default glyph.  Rebuilt when the glyphs or
+	 * the game change. */
+	enum { GLYPHS_PER_PAGE = 256, NUM_GLYPH_PAGES = 256 };
+	mutable vector<glyph *> m_GlyphPages[NUM_GLYPH_PAGES];
+	mutable glyph *m_pDefaultGlyph;
+	mutable const Game *m_pGlyphTableGame;
+	mutable bool m_bGlyphTableValid;
+	void BuildGlyphTable() const;
+	void InvalidateGlyphTable();
+
+	enum { MAX_CACHED_LAYOUTS = 32 };
+	typedef list< pair<CString, FontTextLayout> > LayoutList;
+	LayoutList m_Layouts;	/* most recently used first */
+	map<CString, LayoutList::iterator> m_LayoutIndex;
+
 	/* We keep this around only for reloading. */
 	CString Chars;
 
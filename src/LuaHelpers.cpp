@@ -3,6 +3,7 @@
 #include "LuaFunctions.h"
 #include "RageUtil.h"
 #include "RageLog.h"
+#include "RageThreads.h"
 
 #include <csetjmp>
 #include <cassert>
@@ -96,7 +97,7 @@ bool Lua::GetStack( lua_State *L, int pos, int &out )
 	return true;
 }
 
-void LoadFromString( lua_State *L, const CString &str )
+static void LoadFromString( lua_State *L, const CString &str )
 {
 	ChunkReaderData data;
 	data.buf = &str;
@@ -106,6 +107,7 @@ void LoadFromString( lua_State *L, const CString &str )
 	{
 		CString err;
 		Lua::PopStack( L, err );
+		lua_settop( L, 0 );
 		RageException::Throw( "Error loading script \"%s\": %s", str.c_str(), err.c_str() );
 	}
 }
@@ -129,10 +131,21 @@ static int LuaPanic( lua_State *L )
 	longjmp( jbuf, 1 );
 }
 
-bool Lua::RunExpression( const CString &str )
+/* One state is kept for the life of the program; opening a state and
+ * registering every function per expression was most of the cost of
+ * evaluating one.  Compiled chunks live in a table in the registry,
+ * indexed by handle+1. */
+static RageMutex g_LuaLock( "Lua" );
+static lua_State *g_pLuaState = NULL;
+static map<CString,Lua::ExpressionHandle> g_mapExpressionToHandle;
+static vector<CString> g_asExpressionText;	/* indexed by handle */
+static char g_ChunkTableKey;	/* address used as the registry key */
+
+static lua_State *GetLuaState()
 {
-	if( setjmp(jbuf) )
-		RageException::Throw( "Error running \"%s\": %s", str.c_str(), jbuf_error.c_str() );
+	if( g_pLuaState != NULL )
+		return g_pLuaState;
+
 	lua_State *L = lua_open();
 	ASSERT( L );
 
@@ -145,7 +158,83 @@ bool Lua::RunExpression( const CString &str )
 
 	Lua::RegisterFunctions( L );
 
+	lua_pushlightuserdata( L, &g_ChunkTableKey );
+	lua_newtable( L );
+	lua_rawset( L, LUA_REGISTRYINDEX );
+
+	g_pLuaState = L;
+	return L;
+}
+
+/* After a panic the state can't be trusted; close it and start over on the
+ * next call.  Handles stay valid: their chunks are recompiled from
+ * g_asExpressionText as they're run. */
+static void DiscardLuaState()
+{
+	if( g_pLuaState != NULL )
+		lua_close( g_pLuaState );
+	g_pLuaState = NULL;
+}
+
+Lua::ExpressionHandle Lua::CompileExpression( const CString &str )
+{
+	LockMut( g_LuaLock );
+
+	map<CString,ExpressionHandle>::const_iterator it = g_mapExpressionToHandle.find( str );
+	if( it != g_mapExpressionToHandle.end() )
+		return it->second;
+
+	if( setjmp(jbuf) )
+	{
+		DiscardLuaState();
+		RageException::Throw( "Error compiling \"%s\": %s", str.c_str(), jbuf_error.c_str() );
+	}
+
+	lua_State *L = GetLuaState();
+
+	lua_pushlightuserdata( L, &g_ChunkTableKey );
+	lua_rawget( L, LUA_REGISTRYINDEX );
+
 	LoadFromString( L, "return " + str );
+
+	const ExpressionHandle h = g_asExpressionText.size();
+	lua_rawseti( L, -2, h+1 );
+	lua_settop( L, 0 );
+
+	g_asExpressionText.push_back( str );
+	g_mapExpressionToHandle[str] = h;
+	return h;
+}
+
+bool Lua::RunExpression( ExpressionHandle h )
+{
+	LockMut( g_LuaLock );
+
+	ASSERT_M( h >= 0 && h < (int) g_asExpressionText.size(), ssprintf("%i", h) );
+	const CString &str = g_asExpressionText[h];
+
+	if( setjmp(jbuf) )
+	{
+		const CString sExpr = str;
+		DiscardLuaState();
+		RageException::Throw( "Error running \"%s\": %s", sExpr.c_str(), jbuf_error.c_str() );
+	}
+
+	lua_State *L = GetLuaState();
+	ASSERT( lua_gettop(L) == 0 );
+
+	lua_pushlightuserdata( L, &g_ChunkTableKey );
+	lua_rawget( L, LUA_REGISTRYINDEX );
+	lua_rawgeti( L, -1, h+1 );
+	if( lua_isnil(L, -1) )
+	{
+		/* The state was replaced since this was compiled. */
+		lua_pop( L, 1 );
+		LoadFromString( L, "return " + str );
+		lua_pushvalue( L, -1 );
+		lua_rawseti( L, -3, h+1 );
+	}
+	lua_remove( L, 1 );
 	ASSERT_M( lua_gettop(L) == 1, ssprintf("%i", lua_gettop(L)) );
 
 	int ret = lua_pcall(L, 0, 1, 0);
@@ -153,6 +242,7 @@ bool Lua::RunExpression( const CString &str )
 	{
 		CString err;
 		Lua::PopStack( L, err );
+		lua_settop( L, 0 );
 		RageException::Throw( "Runtime error running \"%s\": %s", str.c_str(), err.c_str() );
 	}
 
@@ -161,16 +251,31 @@ bool Lua::RunExpression( const CString &str )
 	/* Don't accept a function as a return value; if you really want to use a function
 	 * as a boolean, convert it before returning. */
 	if( lua_isfunction( L, -1 ) )
+	{
+		lua_settop( L, 0 );
 		RageException::Throw( "Error running \"%s\": result is a function; did you forget \"()\"?", str.c_str() );
+	}
 
 	bool result = !!lua_toboolean( L, -1 );
-	lua_pop( L, -1 );
-
-	lua_close( L );
+	lua_settop( L, 0 );
 
 	return result;
 }
 
+bool Lua::RunExpression( const CString &str )
+{
+	return RunExpression( CompileExpression(str) );
+}
+
+void Lua::Shutdown()
+{
+	LockMut( g_LuaLock );
+
+	DiscardLuaState();
+	g_mapExpressionToHandle.clear();
+	g_asExpressionText.clear();
+}
+
 void Lua::Fail( lua_State *L, const CString &err )
 {
 	lua_pushstring( L, err );
@@ -4,8 +4,21 @@
 struct lua_State;
 namespace Lua
 {
+	/* Evaluate str as a boolean expression.  Expressions are compiled once
+	 * and cached by text in a single long-lived lua_State. */
 	bool RunExpression( const CString &str );
 
+	/* Compile str once and return a handle to the compiled chunk; evaluating
+	 * the handle does no string work.  Compiling the same text again returns
+	 * the same handle.  Throws on syntax errors. */
+	typedef int ExpressionHandle;
+	const ExpressionHandle INVALID_EXPRESSION = -1;
+	ExpressionHandle CompileExpression( const CString &str );
+	bool RunExpression( ExpressionHandle h );
+
+	/* Close the shared state and forget all compiled expressions. */
+	void Shutdown();
+
 	void Fail( lua_State *L, const CString &err );
 
 	/* Add all registered functions into L. */
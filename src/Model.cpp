@@ -708,10 +708,11 @@ void Model::SetSecondsIntoAnimation( float fSeconds )
 
 void Model::HandleCommand( const ParsedCommand &command )
 {
+	static const int iPlayID = GetCommandNameID( "play" );
+
 	HandleParams;
 
-	const CString& sName = sParam(0);
-	if( sName=="play" )
+	if( command.iNameID == iPlayID )
 		PlayAnimation( sParam(1),fParam(2) );
 	else
 	{
@@ -24,13 +24,24 @@
 
 void MsdFile::AddParam( char *buf, int len )
 {
-	values.back().params.push_back(CString(buf, len));
+	value_t::param_t p;
+	p.iOffset = buf - m_sBuffer.data();
+	p.iLength = len;
+	values.back().params.push_back( p );
 }
 
-void MsdFile::AddValue() /* (no extra charge) */
+void MsdFile::AddValue( int iOffset ) /* (no extra charge) */
 {
 	values.push_back(value_t());
 	values.back().params.reserve( 32 );
+	values.back().pBuf = m_sBuffer.data();
+	values.back().iOffset = iOffset;
+	values.back().iLength = 0;
+}
+
+void MsdFile::EndValue( int iEnd )
+{
+	values.back().iLength = iEnd - values.back().iOffset;
 }
 
 void MsdFile::ReadBuf( char *buf, int len )
@@ -81,12 +92,13 @@ void MsdFile::ReadBuf( char *buf, int len )
 				--j;
 
 			AddParam(buf+value_start, j - value_start);
+			EndValue( j );
 			ReadingValue=false;
 		}
 
 		/* # starts a new value. */
 		if(!ReadingValue && buf[i] == '#') {
-			AddValue();
+			AddValue( i );
 			ReadingValue=true;
 		}
 
@@ -110,20 +122,27 @@ void MsdFile::ReadBuf( char *buf, int len )
 
 		/* ; ends the current value. */
 		if(buf[i] == ';')
+		{
+			EndValue( i+1 );
 			ReadingValue=false;
+		}
 
 		i++;
 	}
 	
 	/* Add any unterminated value at the very end. */
 	if(ReadingValue)
+	{
 		AddParam(buf+value_start, i - value_start);
+		EndValue( i );
+	}
 }
 
 // returns true if successful, false otherwise
 bool MsdFile::ReadFile( const CString &sNewPath )
 {
 	error = "";
+	values.clear();
 
 	RageFile f;
 	/* Open a file. */
@@ -134,27 +153,40 @@ bool MsdFile::ReadFile( const CString &sNewPath )
 	}
 
 	// allocate a string to hold the file
-	CString FileString;
-	FileString.reserve( f.GetFileSize() );
+	m_sBuffer = CString();
+	m_sBuffer.reserve( f.GetFileSize() );
 
-	int iBytesRead = f.Read( FileString );
+	int iBytesRead = f.Read( m_sBuffer );
 	if( iBytesRead < 0 )
 	{
 		error = f.GetError();
+		m_sBuffer = CString();
 		return false;
 	}
 
-	ReadBuf( (char*) FileString.c_str(), iBytesRead );
+	if( iBytesRead > 0 )
+		ReadBuf( &m_sBuffer[0], iBytesRead );
 
 	return true;
 }
 
+void MsdFile::ReadFromString( const CString &sString )
+{
+	error = "";
+	values.clear();
+
+	/* ReadBuf modifies the buffer in place, so make sure we have our own. */
+	m_sBuffer.assign( sString.data(), sString.size() );
+	if( !m_sBuffer.empty() )
+		ReadBuf( &m_sBuffer[0], m_sBuffer.size() );
+}
+
 CString MsdFile::GetParam(unsigned val, unsigned par) const
 {
 	if(val >= GetNumValues()) return "";
 	if(par >= GetNumParams(val)) return "";
 
-	return values[val].params[par];
+	return values[val][par];
 }
 
 /*
@@ -9,15 +9,22 @@ public:
 	/* #param:param:param:param; <- one whole value */
 	struct value_t
 	{
-		vector<CString> params;
+		/* Params are byte ranges of the file buffer; they're only copied into
+		 * strings when asked for. */
+		struct param_t { int iOffset, iLength; };
+		vector<param_t> params;
+		const char *pBuf;
+		int iOffset, iLength;	/* byte range of "#...;" in the source buffer */
 
-		CString operator[](unsigned i) const { if(i >= params.size()) return ""; return params[i]; }
+		CString operator[](unsigned i) const { if(i >= params.size()) return ""; return CString( pBuf+params[i].iOffset, params[i].iLength ); }
 	};
 
+	MsdFile() { }
 	virtual ~MsdFile() { }
 
 	// Returns true if successful, false otherwise.
 	bool ReadFile( const CString &sFilePath );
+	void ReadFromString( const CString &sString );
 	CString GetError() const { return error; }
 
 	unsigned GetNumValues() const { return values.size(); }
@@ -27,10 +34,16 @@ public:
 
 
 private:
+	/* values point into m_sBuffer. */
+	MsdFile( const MsdFile &cpy );
+	MsdFile &operator=( const MsdFile &cpy );
+
 	void ReadBuf( char *buf, int len );
 	void AddParam( char *buf, int len );
-	void AddValue();
+	void AddValue( int iOffset );
+	void EndValue( int iEnd );
 
+	CString m_sBuffer;
 	vector<value_t> values;
 	CString error;
 };
@@ -229,6 +229,41 @@ void MusicWheel::Load()
 	RebuildMusicWheelItems();
 }
 
+/* The last sorted song list for each sort order.  The wheel is rebuilt every time
+ * the music select screen loads; if a sort order gets the same songs again, and no
+ * sort keys, steps type or sort preferences have changed since, reuse the order
+ * instead of sorting again. */
+struct SortedSongList
+{
+	SortedSongList() { m_iGeneration = -1; }
+
+	bool Matches( const vector<Song*> &vpIn, bool bUseSections ) const
+	{
+		return m_iGeneration == SongUtil::GetSortKeyGeneration() &&
+			m_StepsType == GAMESTATE->GetCurrentStyle()->m_StepsType &&
+			m_bSubSortByNumSteps == PREFSMAN->m_bSubSortByNumSteps &&
+			m_bUseSections == bUseSections &&
+			m_vpIn == vpIn;
+	}
+
+	void Set( const vector<Song*> &vpIn, const vector<Song*> &vpOut, bool bUseSections )
+	{
+		m_vpIn = vpIn;
+		m_vpOut = vpOut;
+		m_iGeneration = SongUtil::GetSortKeyGeneration();
+		m_StepsType = GAMESTATE->GetCurrentStyle()->m_StepsType;
+		m_bSubSortByNumSteps = PREFSMAN->m_bSubSortByNumSteps;
+		m_bUseSections = bUseSections;
+	}
+
+	vector<Song*> m_vpIn, m_vpOut;
+	int m_iGeneration;
+	StepsType m_StepsType;
+	bool m_bSubSortByNumSteps;
+	bool m_bUseSections;
+};
+static SortedSongList g_SortedSongs[NUM_SORT_ORDERS];
+
 MusicWheel::~MusicWheel()
 {
 }
@@ -492,75 +527,95 @@ void MusicWheel::BuildWheelItemDatas( vector<WheelItemData> &arrayWheelItemDatas
 		GetSongList(arraySongs, so, GAMESTATE->m_sPreferredGroup );
 
 		bool bUseSections = true;
-
-		// sort the songs
 		switch( so )
 		{
 		case SORT_PREFERRED:
 		case SORT_ROULETTE:
-			SongUtil::SortSongPointerArrayByGroupAndDifficulty( arraySongs );
+		case SORT_MOST_PLAYED:
 			bUseSections = false;
 			break;
 		case SORT_GROUP:
-			SongUtil::SortSongPointerArrayByGroupAndTitle( arraySongs );
 			bUseSections = GAMESTATE->m_sPreferredGroup == GROUP_ALL_MUSIC;
 			break;
-		case SORT_TITLE:
-			SongUtil::SortSongPointerArrayByTitle( arraySongs );
-			break;
-		case SORT_BPM:
-			SongUtil::SortSongPointerArrayByBPM( arraySongs );
-			break;
-		case SORT_MOST_PLAYED:
-			if( (int) arraySongs.size() > MOST_PLAYED_SONGS_TO_SHOW )
-				arraySongs.erase( arraySongs.begin()+MOST_PLAYED_SONGS_TO_SHOW, arraySongs.end() );
-			bUseSections = false;
-			break;
-		case SORT_GRADE:
-			SongUtil::SortSongPointerArrayByGrade( arraySongs );
-			break;
-		case SORT_ARTIST:
-			SongUtil::SortSongPointerArrayByArtist( arraySongs );
-			break;
-		case SORT_EASY_METER:
-			SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_EASY );
-			break;
-		case SORT_MEDIUM_METER:
-			SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_MEDIUM );
-			break;
-		case SORT_HARD_METER:
-			SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_HARD );
-			break;
-		case SORT_CHALLENGE_METER:
-			SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_CHALLENGE );
-			break;
-		default:
-			ASSERT(0);	// unhandled SortOrder
 		}
 
-
-		///////////////////////////////////
-		// Build an array of WheelItemDatas from the sorted list of Song*'s
-		///////////////////////////////////
-		arrayWheelItemDatas.clear();	// clear out the previous wheel items 
-		arrayWheelItemDatas.reserve( arraySongs.size() );
-
 		if( PREFSMAN->m_MusicWheelUsesSections == PrefsManager::NEVER || (so != SORT_TITLE && PREFSMAN->m_MusicWheelUsesSections == PrefsManager::ABC_ONLY ))
 			bUseSections = false;
 
-		if( bUseSections )
+		// sort the songs, unless we sorted the same list last time
+		SortedSongList &sorted = g_SortedSongs[so];
+		if( so != SORT_MOST_PLAYED && sorted.Matches(arraySongs, bUseSections) )
+		{
+			arraySongs = sorted.m_vpOut;
+		}
+		else
 		{
+			const vector<Song*> arrayUnsorted = arraySongs;
+
+			switch( so )
+			{
+			case SORT_PREFERRED:
+			case SORT_ROULETTE:
+				SongUtil::SortSongPointerArrayByGroupAndDifficulty( arraySongs );
+				break;
+			case SORT_GROUP:
+				SongUtil::SortSongPointerArrayByGroupAndTitle( arraySongs );
+				break;
+			case SORT_TITLE:
+				SongUtil::SortSongPointerArrayByTitle( arraySongs );
+				break;
+			case SORT_BPM:
+				SongUtil::SortSongPointerArrayByBPM( arraySongs );
+				break;
+			case SORT_MOST_PLAYED:
+				if( (int) arraySongs.size() > MOST_PLAYED_SONGS_TO_SHOW )
+					arraySongs.erase( arraySongs.begin()+MOST_PLAYED_SONGS_TO_SHOW, arraySongs.end() );
+				break;
+			case SORT_GRADE:
+				SongUtil::SortSongPointerArrayByGrade( arraySongs );
+				break;
+			case SORT_ARTIST:
+				SongUtil::SortSongPointerArrayByArtist( arraySongs );
+				break;
+			case SORT_EASY_METER:
+				SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_EASY );
+				break;
+			case SORT_MEDIUM_METER:
+				SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_MEDIUM );
+				break;
+			case SORT_HARD_METER:
+				SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_HARD );
+				break;
+			case SORT_CHALLENGE_METER:
+				SongUtil::SortSongPointerArrayByMeter( arraySongs, DIFFICULTY_CHALLENGE );
+				break;
+			default:
+				ASSERT(0);	// unhandled SortOrder
+			}
+
 			// Sorting twice isn't necessary.  Instead, modify the compatator functions 
 			// in Song.cpp to have the desired effect. -Chris
 			/* Keeping groups together with the sorts is tricky and brittle; we
 				* keep getting OTHER split up without this.  However, it puts the 
 				* Grade and BPM sorts in the wrong order, and they're already correct,
 				* so don't re-sort for them. */
-//				/* We're using sections, so use the section name as the top-level
-//				 * sort. */
-			if( so != SORT_GRADE && so != SORT_BPM )
+//			/* We're using sections, so use the section name as the top-level
+//			 * sort. */
+			if( bUseSections && so != SORT_GRADE && so != SORT_BPM )
 				SongUtil::SortSongPointerArrayBySectionName(arraySongs, so);
 
+			sorted.Set( arrayUnsorted, arraySongs, bUseSections );
+		}
+
+
+		///////////////////////////////////
+		// Build an array of WheelItemDatas from the sorted list of Song*'s
+		///////////////////////////////////
+		arrayWheelItemDatas.clear();	// clear out the previous wheel items 
+		arrayWheelItemDatas.reserve( arraySongs.size() );
+
+		if( bUseSections )
+		{
 			// make WheelItemDatas with sections
 			CString sLastSection = "";
 			int iSectionColorIndex = 0;
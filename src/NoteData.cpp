@@ -13,6 +13,7 @@
 NoteData::NoteData()
 {
 	m_iNumTracks = 0;
+	m_bHoldIndexDirty = true;
 	Init();
 }
 
@@ -34,23 +35,16 @@ int NoteData::GetNumTracks() const
 void NoteData::SetNumTracks( int iNewNumTracks )
 {
 	m_iNumTracks = iNewNumTracks;
-
-	// Make sure that all tracks are of the same length
 	ASSERT( m_iNumTracks > 0 );
-	int rows = m_TapNotes[0].size();
 
-	for( int t=0; t<MAX_NOTE_TRACKS; t++ )
-	{
-		if( t<m_iNumTracks )
-			m_TapNotes[t].resize( rows, TAP_EMPTY );
-		else
-			m_TapNotes[t].clear();
-	}
+	for( int t=m_iNumTracks; t<MAX_NOTE_TRACKS; t++ )
+		m_TapNotes[t].clear();
 
 	/* Remove all hold notes that are out of bounds. */
 	for( int h = m_HoldNotes.size()-1; h >= 0; --h )
 		if( m_HoldNotes[h].iTrack >= iNewNumTracks )
 			m_HoldNotes.erase( m_HoldNotes.begin()+h );
+	m_bHoldIndexDirty = true;
 }
 
 
@@ -59,10 +53,7 @@ void NoteData::ClearRange( int iNoteIndexBegin, int iNoteIndexEnd )
 {
 	this->ConvertHoldNotesTo4s();
 	for( int c=0; c<m_iNumTracks; c++ )
-	{
-		for( int i=iNoteIndexBegin; i <= iNoteIndexEnd; i++ )
-			SetTapNote(c, i, TAP_EMPTY);
-	}
+		FillTapNoteRange( c, iNoteIndexBegin, iNoteIndexEnd+1, TAP_EMPTY );
 	this->Convert4sToHoldNotes();
 }
 
@@ -71,6 +62,7 @@ void NoteData::ClearAll()
 	for( int t=0; t<m_iNumTracks; t++ )
 		m_TapNotes[t].clear();
 	m_HoldNotes.clear();
+	m_bHoldIndexDirty = true;
 }
 
 /* Copy a range from pFrom to this.  (Note that this does *not* overlay;
@@ -84,24 +76,19 @@ void NoteData::CopyRange( const NoteData* pFrom, int iFromIndexBegin, int iFromI
 	To.To4s( *this );
 
 	// copy recorded TapNotes
-	int f = iFromIndexBegin, t = iToIndexBegin;
-	
-	while( f<=iFromIndexEnd )
+	const int iShift = iToIndexBegin - iFromIndexBegin;
+	for( int c=0; c<m_iNumTracks; c++ )
 	{
-		for( int c=0; c<m_iNumTracks; c++ )
+		To.FillTapNoteRange( c, iToIndexBegin, iToIndexBegin + iFromIndexEnd - iFromIndexBegin + 1, TAP_EMPTY );
+
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( From, c, f, iFromIndexBegin, iFromIndexEnd )
 		{
 			TapNote tn = From.GetTapNote( c, f );
 			if( tn.type == TapNote::attack )
-			{
-				To.SetTapAttackNote( c, t, From.GetAttackAt(c, f) );
-			}
+				To.SetTapAttackNote( c, f+iShift, From.GetAttackAt(c, f) );
 			else
-			{
-				To.SetTapNote( c, t, tn );
-			}
+				To.SetTapNote( c, f+iShift, tn );
 		}
-		f++;
-		t++;
 	}
 
 	this->From4s( To );
@@ -120,17 +107,14 @@ void NoteData::CopyAll( const NoteData* pFrom )
 	for( int c=0; c<m_iNumTracks; c++ )
 		m_TapNotes[c] = pFrom->m_TapNotes[c];
 	m_HoldNotes = pFrom->m_HoldNotes;
+	m_bHoldIndexDirty = true;
 	m_AttackMap = pFrom->m_AttackMap;
 }
 
 bool NoteData::IsRowEmpty( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return true;
-
 	for( int t=0; t<m_iNumTracks; t++ )
-		if( GetTapNoteX(t, index).type != TapNote::empty )
+		if( GetTapNote(t, index).type != TapNote::empty )
 			return false;
 	return true;
 }
@@ -138,14 +122,9 @@ bool NoteData::IsRowEmpty( int index ) const
 bool NoteData::IsRangeEmpty( int track, int iIndexBegin, int iIndexEnd ) const
 {
 	ASSERT( track<m_iNumTracks );
-	
-	CLAMP( iIndexBegin, 0, GetNumRows()-1 );
-	CLAMP( iIndexEnd, 0, GetNumRows()-1 );
 
-	for( int i=iIndexBegin; i<=iIndexEnd; i++ )
-		if( GetTapNoteX(track,i).type != TapNote::empty )
-			return false;
-	return true;
+	int iRow = iIndexBegin-1;
+	return !GetNextTapNoteRowForTrack( track, iRow ) || iRow > iIndexEnd;
 }
 
 int NoteData::GetNumTapNonEmptyTracks( int index ) const
@@ -166,26 +145,18 @@ void NoteData::GetTapNonEmptyTracks( int index, set<int>& addTo ) const
 
 int NoteData::GetFirstNonEmptyTrack( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return 0;
-
 	for( int t=0; t<m_iNumTracks; t++ )
-		if( GetTapNoteX( t, index ).type != TapNote::empty )
+		if( GetTapNote( t, index ).type != TapNote::empty )
 			return t;
 	return -1;
 }
 
 int NoteData::GetNumTracksWithTap( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return 0;
-
 	int iNum = 0;
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		TapNote tn = GetTapNoteX( t, index );
+		TapNote tn = GetTapNote( t, index );
 		if( tn.type == TapNote::tap )
 			iNum++;
 	}
@@ -194,14 +165,10 @@ int NoteData::GetNumTracksWithTap( int index ) const
 
 int NoteData::GetNumTracksWithTapOrHoldHead( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return 0;
-
 	int iNum = 0;
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		TapNote tn = GetTapNoteX( t, index );
+		TapNote tn = GetTapNote( t, index );
 		if( tn.type == TapNote::tap || tn.type == TapNote::hold_head )
 			iNum++;
 	}
@@ -210,13 +177,9 @@ int NoteData::GetNumTracksWithTapOrHoldHead( int index ) const
 
 int NoteData::GetFirstTrackWithTap( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return -1;
-
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		TapNote tn = GetTapNoteX( t, index );
+		TapNote tn = GetTapNote( t, index );
 		if( tn.type == TapNote::tap )
 			return t;
 	}
@@ -225,13 +188,9 @@ int NoteData::GetFirstTrackWithTap( int index ) const
 
 int NoteData::GetFirstTrackWithTapOrHoldHead( int index ) const
 {
-	/* If this is out of range, we don't have any notes there, so all tracks are empty. */
-	if( index < 0 || index >= GetNumRows() )
-		return -1;
-
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		TapNote tn = GetTapNoteX( t, index );
+		TapNote tn = GetTapNote( t, index );
 		if( tn.type == TapNote::tap || tn.type == TapNote::hold_head )
 			return t;
 	}
@@ -242,12 +201,10 @@ void NoteData::AddHoldNote( HoldNote add )
 {
 	ASSERT( add.iStartRow>=0 && add.iEndRow>=0 );
 
-	int i;
-
 	// look for other hold notes that overlap and merge them
 	// XXX: this is done implicitly with 4s, but 4s uses this function.
 	// Rework this later.
-	for( i=0; i<GetNumHoldNotes(); i++ )	// for each HoldNote
+	for( int i=0; i<GetNumHoldNotes(); i++ )	// for each HoldNote
 	{
 		HoldNote &other = GetHoldNote(i);
 		if( add.iTrack == other.iTrack  &&		// the tracks correspond
@@ -262,17 +219,14 @@ void NoteData::AddHoldNote( HoldNote add )
 		}
 	}
 
-	int iAddStartIndex = add.iStartRow;
-	int iAddEndIndex = add.iEndRow;
-
 	// delete TapNotes under this HoldNote
-	for( i=iAddStartIndex+1; i<=iAddEndIndex; i++ )
-		SetTapNote( add.iTrack, i, TAP_EMPTY );
+	FillTapNoteRange( add.iTrack, add.iStartRow+1, add.iEndRow+1, TAP_EMPTY );
 
 	// add a tap note at the start of this hold
-	SetTapNote( add.iTrack, iAddStartIndex, TAP_ORIGINAL_HOLD_HEAD );		// Hold begin marker.  Don't draw this, but do grade it.
+	SetTapNote( add.iTrack, add.iStartRow, TAP_ORIGINAL_HOLD_HEAD );		// Hold begin marker.  Don't draw this, but do grade it.
 
 	m_HoldNotes.push_back(add);
+	m_bHoldIndexDirty = true;
 }
 
 void NoteData::RemoveHoldNote( int iHoldIndex )
@@ -288,9 +242,9 @@ void NoteData::RemoveHoldNote( int iHoldIndex )
 
 	// remove from list
 	m_HoldNotes.erase(m_HoldNotes.begin()+iHoldIndex, m_HoldNotes.begin()+iHoldIndex+1);
+	m_bHoldIndexDirty = true;
 }
 
-/* Get a hold note with the same track and end row as hn. */
 int NoteData::GetMatchingHoldNote( const HoldNote &hn ) const
 {
 	for( int i=0; i<GetNumHoldNotes(); i++ )	// for each HoldNote
@@ -302,6 +256,61 @@ int NoteData::GetMatchingHoldNote( const HoldNote &hn ) const
 	FAIL_M( ssprintf("%i..%i, %i", hn.iStartRow, hn.iEndRow, hn.iTrack) );
 }
 
+struct CompareHoldStart
+{
+	const vector<HoldNote> &m_Holds;
+	CompareHoldStart( const vector<HoldNote> &holds ): m_Holds(holds) { }
+	bool operator()( int a, int b ) const { return m_Holds[a].iStartRow < m_Holds[b].iStartRow; }
+};
+
+struct HoldStartsBefore
+{
+	const vector<HoldNote> &m_Holds;
+	HoldStartsBefore( const vector<HoldNote> &holds ): m_Holds(holds) { }
+	bool operator()( int a, int iRow ) const { return m_Holds[a].iStartRow < iRow; }
+};
+
+void NoteData::BuildHoldIndex() const
+{
+	for( int t=0; t<MAX_NOTE_TRACKS; t++ )
+	{
+		m_HoldIndex[t].clear();
+		m_iLongestHold[t] = 0;
+	}
+
+	for( unsigned i=0; i<m_HoldNotes.size(); i++ )
+	{
+		const HoldNote &hn = m_HoldNotes[i];
+		m_HoldIndex[hn.iTrack].push_back( i );
+		m_iLongestHold[hn.iTrack] = max( m_iLongestHold[hn.iTrack], hn.iEndRow - hn.iStartRow );
+	}
+
+	for( int t=0; t<MAX_NOTE_TRACKS; t++ )
+		stable_sort( m_HoldIndex[t].begin(), m_HoldIndex[t].end(), CompareHoldStart(m_HoldNotes) );
+
+	m_bHoldIndexDirty = false;
+}
+
+void NoteData::GetHoldNotesInRange( int track, int iStartRow, int iEndRow, vector<int> &viIndexesOut ) const
+{
+	if( m_bHoldIndexDirty )
+		BuildHoldIndex();
+
+	/* A hold that overlaps the range can't start after iEndRow, or more than
+	 * the longest hold's length before iStartRow. */
+	const vector<int> &index = m_HoldIndex[track];
+	vector<int>::const_iterator it = lower_bound( index.begin(), index.end(),
+		iStartRow - m_iLongestHold[track], HoldStartsBefore(m_HoldNotes) );
+	for( ; it != index.end(); ++it )
+	{
+		const HoldNote &hn = m_HoldNotes[*it];
+		if( hn.iStartRow > iEndRow )
+			break;
+		if( hn.iEndRow >= iStartRow )
+			viIndexesOut.push_back( *it );
+	}
+}
+
 
 void NoteData::SetTapAttackNote( int track, int row, const Attack &attack )
 {
@@ -328,15 +337,12 @@ void NoteData::PruneUnusedAttacksFromMap()
 	// Add all used AttackNote index values to a map.
 	set<unsigned> setUsedIndices;
 
-	int num_rows = GetNumRows();
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		for( int r=0; r<num_rows; r++ )
-		{
-			TapNote tn = GetTapNote(t, r);
-			if( tn.type == TapNote::attack )
-				setUsedIndices.insert( tn.attackIndex );
-		}
+		const TrackMap &tm = m_TapNotes[t];
+		for( unsigned i=0; i<tm.size(); i++ )
+			if( tm[i].tn.type == TapNote::attack )
+				setUsedIndices.insert( tm[i].tn.attackIndex );
 	}
 
 	// Remove all items from m_AttackMap that don't have corresponding
@@ -379,13 +385,13 @@ int NoteData::GetFirstRow() const
 	
 	int i;
 
-	for( i=0; i < int(m_TapNotes[0].size()); i++ )
+	for( i=0; i<m_iNumTracks; i++ )
 	{
-		if( !IsRowEmpty(i) )
-		{
-			iEarliestRowFoundSoFar = i;
-			break;
-		}
+		const TrackMap &tm = m_TapNotes[i];
+		if( tm.empty() )
+			continue;
+		if( iEarliestRowFoundSoFar == -1 || tm.front().iRow < iEarliestRowFoundSoFar )
+			iEarliestRowFoundSoFar = tm.front().iRow;
 	}
 
 	for( i=0; i<GetNumHoldNotes(); i++ )
@@ -412,13 +418,11 @@ int NoteData::GetLastRow() const
 	
 	int i;
 
-	for( i = int(m_TapNotes[0].size()); i>=0; i-- )		// iterate back to front
+	for( i=0; i<m_iNumTracks; i++ )
 	{
-		if( !IsRowEmpty(i) )
-		{
-			iOldestRowFoundSoFar = i;
-			break;
-		}
+		const TrackMap &tm = m_TapNotes[i];
+		if( !tm.empty() && tm.back().iRow > iOldestRowFoundSoFar )
+			iOldestRowFoundSoFar = tm.back().iRow;
 	}
 
 	for( i=0; i<GetNumHoldNotes(); i++ )
@@ -445,16 +449,12 @@ int NoteData::GetNumTapNotes( float fStartBeat, float fEndBeat ) const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	/* Clamp to known-good ranges. */
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-	
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		for( int i=iStartIndex; i<=iEndIndex; i++ )
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( *this, t, i, iStartIndex, iEndIndex )
 		{
-			TapNote tn = GetTapNoteX(t, i);
-			if( tn.type != TapNote::empty  &&  tn.type != TapNote::mine )
+			TapNote tn = GetTapNote(t, i);
+			if( tn.type != TapNote::mine )
 				iNumNotes++;
 		}
 	}
@@ -470,7 +470,7 @@ int NoteData::GetNumRowsWithTap( float fStartBeat, float fEndBeat ) const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 	
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 		if( IsThereATapAtRow(i) )
 			iNumNotes++;
 	
@@ -487,14 +487,10 @@ int NoteData::GetNumMines( float fStartBeat, float fEndBeat ) const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	/* Clamp to known-good ranges. */
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-	
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		for( int i=iStartIndex; i<=iEndIndex; i++ )
-			if( GetTapNoteX(t, i).type == TapNote::mine )
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( *this, t, i, iStartIndex, iEndIndex )
+			if( GetTapNote(t, i).type == TapNote::mine )
 				iNumMines++;
 	}
 	
@@ -509,7 +505,7 @@ int NoteData::GetNumRowsWithTapOrHoldHead( float fStartBeat, float fEndBeat ) co
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 	
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 		if( IsThereATapOrHoldHeadAtRow(i) )
 			iNumNotes++;
 	
@@ -521,7 +517,7 @@ int NoteData::RowNeedsHands( const int row ) const
 	int iNumNotesThisIndex = 0;
 	for( int t=0; t<m_iNumTracks; t++ )
 	{
-		TapNote tn = GetTapNoteX(t, row);
+		TapNote tn = GetTapNote(t, row);
 		switch( tn.type )
 		{
 		case TapNote::mine:
@@ -563,12 +559,8 @@ int NoteData::GetNumHands( float fStartBeat, float fEndBeat ) const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	/* Clamp to known-good ranges. */
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-
 	int iNum = 0;
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 	{
 		if( !RowNeedsHands(i) )
 			continue;
@@ -587,17 +579,13 @@ int NoteData::GetNumN( int MinTaps, float fStartBeat, float fEndBeat ) const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	/* Clamp to known-good ranges. */
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-
 	int iNum = 0;
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 	{
 		int iNumNotesThisIndex = 0;
 		for( int t=0; t<m_iNumTracks; t++ )
 		{
-			TapNote tn = GetTapNoteX(t, i);
+			TapNote tn = GetTapNote(t, i);
 			if( tn.type != TapNote::mine  &&  tn.type != TapNote::empty )	// mines don't count
 				iNumNotesThisIndex++;
 		}
@@ -630,27 +618,23 @@ void NoteData::Convert2sAnd3sToHoldNotes()
 	// Any note will end a hold (not just a TAP_HOLD_TAIL).  This makes parsing DWIs much easier.
 	// Plus, allowing tap notes in the middle of a hold doesn't make sense!
 
-	int rows = GetLastRow();
 	for( int col=0; col<m_iNumTracks; col++ )	// foreach column
 	{
-		for( int i=0; i<=rows; i++ )	// foreach TapNote element
+		FOREACH_NONEMPTY_ROW_IN_TRACK( *this, col, i )	// foreach TapNote element
 		{
 			if( GetTapNote(col,i).type != TapNote::hold_head )	// this is a HoldNote begin marker
 				continue;
 			SetTapNote(col, i, TAP_EMPTY);	// clear the hold head marker
 
-			for( int j=i+1; j<=rows; j++ )	// search for end of HoldNote
-			{
-				// End hold on the next note we see.  This should be a hold_tail if the 
-				// data is in a consistent state, but doesn't have to be.
-				if( GetTapNote(col, j).type == TapNote::empty )
-					continue;
+			// End hold on the next note we see.  This should be a hold_tail if the 
+			// data is in a consistent state, but doesn't have to be.
+			int j = i;
+			if( !GetNextTapNoteRowForTrack(col, j) )
+				continue;
 
-				SetTapNote(col, j, TAP_EMPTY);
+			SetTapNote(col, j, TAP_EMPTY);
 
-				AddHoldNote( HoldNote(col, i, j) );
-				break;	// done searching for the end of this hold
-			}
+			AddHoldNote( HoldNote(col, i, j) );
 		}
 	}
 }
@@ -673,6 +657,7 @@ void NoteData::ConvertHoldNotesTo2sAnd3s()
 		}
 	}
 	m_HoldNotes.clear();
+	m_bHoldIndexDirty = true;
 }
 
 
@@ -708,25 +693,38 @@ void NoteData::From4s( const NoteData &out )
  * So, make sure the character after a 4 is always a 0. */
 void NoteData::Convert4sToHoldNotes()
 {
-	int rows = GetLastRow();
 	for( int col=0; col<m_iNumTracks; col++ )	// foreach column
 	{
-		for( int i=0; i<=rows; i++ )	// foreach TapNote element
+		/* Pull the hold bodies out of the track in one pass, then add the holds.
+		 * Erasing them one row at a time would be quadratic. */
+		vector<HoldNote> vHolds;
+		TrackMap &tm = m_TapNotes[col];
+		TrackMap kept;
+		kept.reserve( tm.size() );
+		for( unsigned i=0; i<tm.size(); i++ )
 		{
-			if( GetTapNote(col, i).type == TapNote::hold )	// this is a HoldNote body
+			if( tm[i].tn.type != TapNote::hold )	// this is a HoldNote body
 			{
-				HoldNote hn( col, i, 0 );
-				// search for end of HoldNote
-				do {
-					SetTapNote(col, i, TAP_EMPTY);
-					i++;
-				} while( GetTapNote(col, i).type == TapNote::hold );
-				SetTapNote(col, i, TAP_EMPTY);
-
-				hn.iEndRow = i;
-				AddHoldNote( hn );
+				kept.push_back( tm[i] );
+				continue;
 			}
+
+			// search for end of HoldNote
+			HoldNote hn( col, tm[i].iRow, 0 );
+			while( i+1 < tm.size() && tm[i+1].iRow == tm[i].iRow+1 && tm[i+1].tn.type == TapNote::hold )
+				i++;
+			hn.iEndRow = tm[i].iRow+1;
+
+			// the row after the hold is always cleared
+			if( i+1 < tm.size() && tm[i+1].iRow == hn.iEndRow )
+				i++;
+
+			vHolds.push_back( hn );
 		}
+		tm.swap( kept );
+
+		for( unsigned h=0; h<vHolds.size(); h++ )
+			AddHoldNote( vHolds[h] );
 	}
 }
 
@@ -736,10 +734,10 @@ void NoteData::ConvertHoldNotesTo4s()
 	for( int i=0; i<GetNumHoldNotes(); i++ ) 
 	{
 		const HoldNote &hn = GetHoldNote(i);
-		for( int j = hn.iStartRow; j < hn.iEndRow; ++j)
-			SetTapNote(hn.iTrack, j, TAP_ORIGINAL_HOLD);
+		FillTapNoteRange( hn.iTrack, hn.iStartRow, hn.iEndRow, TAP_ORIGINAL_HOLD );
 	}
 	m_HoldNotes.clear();
+	m_bHoldIndexDirty = true;
 }
 
 // -1 for iOriginalTracksToTakeFrom means no track
@@ -771,22 +769,104 @@ void NoteData::LoadTransformed( const NoteData* pOriginal, int iNewNumTracks, co
 	m_AttackMap = Original.GetAttackMap();
 }
 
-void NoteData::PadTapNotes(int rows)
+int NoteData::GetNumRows() const
 {
-	int needed = rows - m_TapNotes[0].size() + 1;
-	if(needed < 0) 
+	/* Empty rows aren't stored, so this is one past the last row with a
+	 * tap or the end of a hold. */
+	int iNumRows = 0;
+	for( int t=0; t<m_iNumTracks; t++ )
+		if( !m_TapNotes[t].empty() )
+			iNumRows = max( iNumRows, m_TapNotes[t].back().iRow+1 );
+	for( unsigned i=0; i<m_HoldNotes.size(); i++ )
+		iNumRows = max( iNumRows, m_HoldNotes[i].iEndRow+1 );
+	return iNumRows;
+}
+
+bool NoteData::GetNextTapNoteRowForTrack( int track, int &rowInOut ) const
+{
+	const TrackMap &tm = m_TapNotes[track];
+	TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), rowInOut+1 );
+	if( it == tm.end() )
+		return false;
+	rowInOut = it->iRow;
+	return true;
+}
+
+bool NoteData::GetPrevTapNoteRowForTrack( int track, int &rowInOut ) const
+{
+	const TrackMap &tm = m_TapNotes[track];
+	TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), rowInOut );
+	if( it == tm.begin() )
+		return false;
+	--it;
+	rowInOut = it->iRow;
+	return true;
+}
+
+bool NoteData::GetNextTapNoteRowForAllTracks( int &rowInOut ) const
+{
+	bool bAnyHaveNextNote = false;
+	int iClosestNextRow = INT_MAX;
+	for( int t=0; t<m_iNumTracks; t++ )
+	{
+		int iNewRowThisTrack = rowInOut;
+		if( GetNextTapNoteRowForTrack(t, iNewRowThisTrack) )
+		{
+			bAnyHaveNextNote = true;
+			iClosestNextRow = min( iClosestNextRow, iNewRowThisTrack );
+		}
+	}
+
+	if( bAnyHaveNextNote )
+		rowInOut = iClosestNextRow;
+	return bAnyHaveNextNote;
+}
+
+bool NoteData::GetPrevTapNoteRowForAllTracks( int &rowInOut ) const
+{
+	bool bAnyHavePrevNote = false;
+	int iClosestPrevRow = -1;
+	for( int t=0; t<m_iNumTracks; t++ )
+	{
+		int iNewRowThisTrack = rowInOut;
+		if( GetPrevTapNoteRowForTrack(t, iNewRowThisTrack) )
+		{
+			bAnyHavePrevNote = true;
+			iClosestPrevRow = max( iClosestPrevRow, iNewRowThisTrack );
+		}
+	}
+
+	if( bAnyHavePrevNote )
+		rowInOut = iClosestPrevRow;
+	return bAnyHavePrevNote;
+}
+
+void NoteData::FillTapNoteRange( int track, int iRowBegin, int iRowEnd, TapNote tn )
+{
+	iRowBegin = max( iRowBegin, 0 );
+	if( iRowBegin >= iRowEnd )
 		return;
 
-	needed += 100; /* optimization: give it a little more than it needs */
+	TrackMap &tm = m_TapNotes[track];
+	TrackMap::iterator begin = lower_bound( tm.begin(), tm.end(), iRowBegin );
+	TrackMap::iterator end = lower_bound( begin, tm.end(), iRowEnd );
+	const int iPos = begin - tm.begin();
+	tm.erase( begin, end );
+
+	if( tn.type == TapNote::empty )
+		return;
 
-	for(int track = 0; track < m_iNumTracks; ++track)
-		m_TapNotes[track].insert( m_TapNotes[track].end(), needed, TAP_EMPTY );
+	TrackEntry e;
+	e.tn = tn;
+	tm.insert( tm.begin()+iPos, iRowEnd-iRowBegin, e );
+	for( int r=iRowBegin; r<iRowEnd; ++r )
+		tm[iPos + r-iRowBegin].iRow = r;
 }
 
 void NoteData::MoveTapNoteTrack(int dest, int src)
 {
 	if(dest == src) return;
-	m_TapNotes[dest] = m_TapNotes[src];
+	m_TapNotes[dest].swap( m_TapNotes[src] );
 	m_TapNotes[src].clear();
 }
 
@@ -795,26 +875,50 @@ void NoteData::SetTapNote(int track, int row, TapNote t)
 	if(row < 0) return;
 	ASSERT(track < MAX_NOTE_TRACKS);
 
-	PadTapNotes(row);
-	m_TapNotes[track][row]=t;
-}
+	TrackMap &tm = m_TapNotes[track];
 
-void NoteData::ReserveRows( int row )
-{
-	for(int track = 0; track < m_iNumTracks; ++track)
-		m_TapNotes[track].reserve( row );
+	/* Loaders and transforms mostly write in increasing row order, so
+	 * appending is the common case. */
+	if( tm.empty() || tm.back().iRow < row )
+	{
+		if( t.type == TapNote::empty )
+			return;
+		TrackEntry e;
+		e.iRow = row;
+		e.tn = t;
+		tm.push_back( e );
+		return;
+	}
+
+	TrackMap::iterator it = lower_bound( tm.begin(), tm.end(), row );
+	if( it->iRow == row )
+	{
+		if( t.type == TapNote::empty )
+			tm.erase( it );
+		else
+			it->tn = t;
+		return;
+	}
+
+	if( t.type == TapNote::empty )
+		return;
+
+	TrackEntry e;
+	e.iRow = row;
+	e.tn = t;
+	tm.insert( it, e );
 }
 
+
+
 void NoteData::EliminateAllButOneTap(int row)
 {
 	if(row < 0) return;
 
-	PadTapNotes(row);
-
 	int track;
 	for(track = 0; track < m_iNumTracks; ++track)
 	{
-		if( m_TapNotes[track][row].type == TapNote::tap )
+		if( GetTapNote(track, row).type == TapNote::tap )
 			break;
 	}
 
@@ -822,8 +926,8 @@ void NoteData::EliminateAllButOneTap(int row)
 
 	for( ; track < m_iNumTracks; ++track)
 	{
-		if( m_TapNotes[track][row].type == TapNote::tap )
-			m_TapNotes[track][row] = TAP_EMPTY;
+		if( GetTapNote(track, row).type == TapNote::tap )
+			SetTapNote( track, row, TAP_EMPTY );
 	}
 }
 
@@ -839,8 +943,7 @@ void NoteData::GetTracksHeldAtRow( int row, set<int>& addTo )
 
 int NoteData::GetNumTracksHeldAtRow( int row )
 {
-	static set<int> viTracks;
-	viTracks.clear();
+	set<int> viTracks;
 	GetTracksHeldAtRow( row, viTracks );
 	return viTracks.size();
 }
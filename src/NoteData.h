@@ -11,16 +11,38 @@
 
 class NoteData
 {
-	/* Keep this aligned, so that they all have the same size. */
-	vector<TapNote> m_TapNotes[MAX_NOTE_TRACKS];
+public:
+	/* One non-empty row of a track. */
+	struct TrackEntry
+	{
+		int iRow;
+		TapNote tn;
+		bool operator<( int row ) const { return iRow < row; }
+	};
+	typedef vector<TrackEntry> TrackMap;
+
+private:
+	/* Each track holds only its non-empty rows, sorted by row.  TAP_EMPTY
+	 * is never stored, so memory scales with the number of notes instead of
+	 * the length of the chart, and whole-chart scans only visit real notes. */
+	TrackMap m_TapNotes[MAX_NOTE_TRACKS];
 	int m_iNumTracks;
 
 	vector<HoldNote>		m_HoldNotes;
 
+	/* For each track, the indexes into m_HoldNotes of the holds in that track,
+	 * sorted by start row, and the length of the longest one.  Anything that
+	 * changes m_HoldNotes sets m_bHoldIndexDirty, and the index is rebuilt on
+	 * the next query. */
+	mutable vector<int>		m_HoldIndex[MAX_NOTE_TRACKS];
+	mutable int				m_iLongestHold[MAX_NOTE_TRACKS];
+	mutable bool			m_bHoldIndexDirty;
+	void BuildHoldIndex() const;
+
 	map<unsigned,Attack>	m_AttackMap;
 
-	/* Pad m_TapNotes so it includes the row "rows". */
-	void PadTapNotes(int rows);
+	/* Set [iRowBegin,iRowEnd) in track to tn, replacing whatever was there. */
+	void FillTapNoteRange( int track, int iRowBegin, int iRowEnd, TapNote tn );
 
 public:
 
@@ -43,18 +65,24 @@ public:
 	 * range; pretend the song goes on with TAP_EMPTYs indefinitely. */
 	inline TapNote GetTapNote(unsigned track, int row) const
 	{
-		if(row < 0 || row >= (int) m_TapNotes[track].size()) 
+		const TrackMap &tm = m_TapNotes[track];
+		TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), row );
+		if( it == tm.end() || it->iRow != row )
 			return TAP_EMPTY;
-		return m_TapNotes[track][row];
+		return it->tn;
 	}
-	void ReserveRows( int row );
 
-	/* GetTapNote is called a lot.  This one doesn't do any bounds checking,
-	 * which is much faster.  Be sure that 0 <= row < GetNumRows(). */
-	inline TapNote GetTapNoteX(unsigned track, int row) const
-	{
-		return m_TapNotes[track][row];
-	}
+	/* Iterate over the non-empty rows only.  These move rowInOut to the next
+	 * (or previous) row that has a note, and return false if there is none.
+	 * Start from row-1 to find the first non-empty row at or after row. */
+	bool GetNextTapNoteRowForTrack( int track, int &rowInOut ) const;
+	bool GetPrevTapNoteRowForTrack( int track, int &rowInOut ) const;
+	bool GetNextTapNoteRowForAllTracks( int &rowInOut ) const;
+	bool GetPrevTapNoteRowForAllTracks( int &rowInOut ) const;
+
+	/* Direct access to a track's non-empty rows, in row order. */
+	const TrackMap &GetTrack( int track ) const { return m_TapNotes[track]; }
+
 	void MoveTapNoteTrack(int dest, int src);
 	void SetTapNote(int track, int row, TapNote t);
 	
@@ -93,6 +121,11 @@ public:
 	const HoldNote &GetHoldNote( int index ) const { ASSERT( index < (int) m_HoldNotes.size() ); return m_HoldNotes[index]; }
 	int GetMatchingHoldNote( const HoldNote &hn ) const;
 
+	/* Get the indexes of the holds in track that overlap [iStartRow,iEndRow],
+	 * sorted by start row.  The index assumes a hold's rows and track aren't
+	 * changed through GetHoldNote; use RemoveHoldNote and AddHoldNote. */
+	void GetHoldNotesInRange( int track, int iStartRow, int iEndRow, vector<int> &viIndexesOut ) const;
+
 	void SetTapAttackNote( int track, int row, const Attack &attack );
 	void PruneUnusedAttacksFromMap();	// slow
 	const Attack& GetAttackAt( int track, int row );
@@ -104,7 +137,7 @@ public:
 	/* Return the number of beats/rows that might contain notes.  Use 
 	 * GetLast* if you need to know the location of the last note. */
 	float GetNumBeats() const { return NoteRowToBeat(GetNumRows()); }
-	int GetNumRows() const { return int(m_TapNotes[0].size()); }
+	int GetNumRows() const;
 
 	float GetFirstBeat() const;	// return the beat number of the first note
 	int GetFirstRow() const;
@@ -140,6 +173,16 @@ public:
 	void EliminateAllButOneTap( int row ); 
 };
 
+/* Loop over each non-empty row, in order.  The row lookup is repeated on
+ * each step, so it's safe to change notes inside the loop. */
+#define FOREACH_NONEMPTY_ROW_IN_TRACK( nd, track, row ) \
+	for( int row = -1; (nd).GetNextTapNoteRowForTrack(track,row); )
+#define FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( nd, track, row, start, last ) \
+	for( int row = (start)-1; (nd).GetNextTapNoteRowForTrack(track,row) && row <= (last); )
+#define FOREACH_NONEMPTY_ROW_ALL_TRACKS( nd, row ) \
+	for( int row = -1; (nd).GetNextTapNoteRowForAllTracks(row); )
+#define FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( nd, row, start, last ) \
+	for( int row = (start)-1; (nd).GetNextTapNoteRowForAllTracks(row) && row <= (last); )
 
 #endif
 
@@ -21,16 +21,13 @@ NoteType NoteDataUtil::GetSmallestNoteTypeForMeasure( const NoteData &n, int iMe
 		int iRowSpacing = int(roundf( fBeatSpacing * ROWS_PER_BEAT ));
 
 		bool bFoundSmallerNote = false;
-		for( int i=iMeasureStartIndex; i<=iMeasureLastIndex; i++ )	// for each index in this measure
+		FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( n, i, iMeasureStartIndex, iMeasureLastIndex )	// for each note in this measure
 		{
 			if( i % iRowSpacing == 0 )
 				continue;	// skip
 			
-			if( !n.IsRowEmpty(i) )
-			{
-				bFoundSmallerNote = true;
-				break;
-			}
+			bFoundSmallerNote = true;
+			break;
 		}
 
 		if( bFoundSmallerNote )
@@ -45,7 +42,67 @@ NoteType NoteDataUtil::GetSmallestNoteTypeForMeasure( const NoteData &n, int iMe
 		return nt;
 }
 
-void NoteDataUtil::LoadFromSMNoteDataString( NoteData &out, CString sSMNoteData, const CString &sSMAttackData )
+static inline bool IsSMSpace( char c )
+{
+	return c == '\r' || c == '\n' || c == '\t' || c == ' ';
+}
+
+static TapNote SMCharToTapNote( char ch )
+{
+	switch( ch )
+	{
+	case '0': return TAP_EMPTY;
+	case '1': return TAP_ORIGINAL_TAP;
+	case '2': return TAP_ORIGINAL_HOLD_HEAD;
+	case '3': return TAP_ORIGINAL_HOLD_TAIL;
+//	case 'm':
+	// Don't be loose with the definition.  Use only 'M' since
+	// that's what we've been writing to disk.  -Chris
+	case 'M': return TAP_ORIGINAL_MINE;
+	default: 
+		if( ch >= 'a' && ch <= 'z' )
+		{
+			TapNote t;
+			t.Set( TapNote::attack, TapNote::original, ch - 'a' );
+			return t;
+		}
+
+		/* Invalid data.  We don't want to assert, since there might
+		 * simply be invalid data in an .SM, and we don't want to die
+		 * due to invalid data.  We should probably check for this when
+		 * we load SM data for the first time ... */
+		// ASSERT(0); 
+		return TAP_EMPTY;
+	}
+}
+
+/* Comments run from "//" up to (not including) the next newline.  A "//" with
+ * no newline after it drops only the two slashes. */
+static void StripSMComments( const CString &sIn, CString &sOut )
+{
+	const size_t iLastNewline = sIn.rfind( '\n' );
+	sOut.erase();
+	sOut.reserve( sIn.size() );
+
+	size_t i = 0;
+	while( i < sIn.size() )
+	{
+		const size_t iComment = sIn.find( "//", i );
+		if( iComment == sIn.npos )
+		{
+			sOut.append( sIn, i, sIn.npos );
+			break;
+		}
+
+		sOut.append( sIn, i, iComment-i );
+		if( iLastNewline != sIn.npos && iLastNewline > iComment )
+			i = sIn.find( '\n', iComment );
+		else
+			i = iComment + 2;
+	}
+}
+
+void NoteDataUtil::LoadFromSMNoteDataString( NoteData &out, const CString &sSMNoteData, const CString &sSMAttackData )
 {
 	{
 		//
@@ -57,74 +114,70 @@ void NoteDataUtil::LoadFromSMNoteDataString( NoteData &out, CString sSMNoteData,
 		out.Init();
 		out.SetNumTracks( iNumTracks );
 
-		// strip comments out of sSMNoteData
-		while( sSMNoteData.Find("//") != -1 )
+		/* Most note data has no comments; only copy it if it does. */
+		CString sStripped;
+		const CString *pNoteData = &sSMNoteData;
+		if( sSMNoteData.find("//") != sSMNoteData.npos )
 		{
-			int iIndexCommentStart = sSMNoteData.Find("//");
-			int iIndexCommentEnd = sSMNoteData.Find("\n", iIndexCommentStart);
-			if( iIndexCommentEnd == -1 )	// comment doesn't have an end?
-				sSMNoteData.erase( iIndexCommentStart, 2 );
-			else
-				sSMNoteData.erase( iIndexCommentStart, iIndexCommentEnd-iIndexCommentStart );
+			StripSMComments( sSMNoteData, sStripped );
+			pNoteData = &sStripped;
 		}
 
-		CStringArray asMeasures;
-		split( sSMNoteData, ",", asMeasures, true );	// ignore empty is important
-		for( unsigned m=0; m<asMeasures.size(); m++ )	// foreach measure
+		/* Walk the buffer directly: measures are separated by commas (empty
+		 * measures are ignored) and trimmed; lines are separated by newlines
+		 * (empty lines are ignored) and trimmed.  A line that's only whitespace
+		 * still counts as a row. */
+		const char *p = pNoteData->data();
+		const char *const pEnd = p + pNoteData->size();
+		vector< pair<const char *, const char *> > vLines;
+		int m = 0;
+		while( p < pEnd )
 		{
-			TrimLeft(asMeasures[m]);
-			TrimRight(asMeasures[m]);
+			const char *pMeasureEnd = (const char *) memchr( p, ',', pEnd-p );
+			if( pMeasureEnd == NULL )
+				pMeasureEnd = pEnd;
+			if( pMeasureEnd == p )
+			{
+				++p;
+				continue;	// ignore empty is important
+			}
 
-			CStringArray asMeasureLines;
-			split( asMeasures[m], "\n", asMeasureLines, true );	// ignore empty is important
+			const char *pBegin = p, *pStop = pMeasureEnd;
+			while( pBegin < pStop && IsSMSpace(*pBegin) )
+				++pBegin;
+			while( pStop > pBegin && IsSMSpace(pStop[-1]) )
+				--pStop;
 
-			for( unsigned l=0; l<asMeasureLines.size(); l++ )
+			vLines.clear();
+			for( const char *q = pBegin; q < pStop; )
 			{
-				CString &sMeasureLine = asMeasureLines[l];
-				TrimLeft(sMeasureLine);
-				TrimRight(sMeasureLine);
+				const char *pLineEnd = (const char *) memchr( q, '\n', pStop-q );
+				if( pLineEnd == NULL )
+					pLineEnd = pStop;
+				if( pLineEnd > q )
+					vLines.push_back( make_pair(q, pLineEnd) );
+				q = pLineEnd + 1;
+			}
 
-				const float fPercentIntoMeasure = l/(float)asMeasureLines.size();
+			for( unsigned l=0; l<vLines.size(); l++ )
+			{
+				const char *pLine = vLines[l].first, *pLineEnd = vLines[l].second;
+				while( pLine < pLineEnd && IsSMSpace(*pLine) )
+					++pLine;
+				while( pLineEnd > pLine && IsSMSpace(pLineEnd[-1]) )
+					--pLineEnd;
+
+				const float fPercentIntoMeasure = l/(float)vLines.size();
 				const float fBeat = (m + fPercentIntoMeasure) * BEATS_PER_MEASURE;
 				const int iIndex = BeatToNoteRow( fBeat );
 
-	//			if( m_iNumTracks != sMeasureLine.GetLength() )
-	//				RageException::Throw( "Actual number of note columns (%d) is different from the StepsType (%d).", m_iNumTracks, sMeasureLine.GetLength() );
-
-				for( int c=0; c<min(sMeasureLine.GetLength(),out.GetNumTracks()); c++ )
-				{
-					TapNote t;
-					char ch = sMeasureLine[c];
-					switch( ch )
-					{
-					case '0': t = TAP_EMPTY;				break;
-					case '1': t = TAP_ORIGINAL_TAP;			break;
-					case '2': t = TAP_ORIGINAL_HOLD_HEAD;	break;
-					case '3': t = TAP_ORIGINAL_HOLD_TAIL;	break;
-	//				case 'm':
-					// Don't be loose with the definition.  Use only 'M' since
-					// that's what we've been writing to disk.  -Chris
-					case 'M': 
-						t = TAP_ORIGINAL_MINE;				break;					
-					default: 
-						if( ch >= 'a' && ch <= 'z' )
-						{
-							t.Set( TapNote::attack, TapNote::original, ch - 'a' );
-						}
-						else
-						{
-							/* Invalid data.  We don't want to assert, since there might
-							 * simply be invalid data in an .SM, and we don't want to die
-							 * due to invalid data.  We should probably check for this when
-							 * we load SM data for the first time ... */
-							// ASSERT(0); 
-							t = TAP_EMPTY;
-						}
-						break;
-					}
-					out.SetTapNote(c, iIndex, t);
-				}
+				const int iNumCols = min( int(pLineEnd-pLine), out.GetNumTracks() );
+				for( int c=0; c<iNumCols; c++ )
+					out.SetTapNote( c, iIndex, SMCharToTapNote(pLine[c]) );
 			}
+
+			p = pMeasureEnd + 1;
+			++m;
 		}
 		out.Convert2sAnd3sToHoldNotes();
 	}
@@ -340,8 +393,7 @@ void NoteDataUtil::LoadOverlapped( const NoteData &input, NoteData &out, int iNe
 
 	const int ShiftThreshold = BeatToNoteRow(1);
 
-	const int iNumRows = in.GetNumRows();
-	for( int row = 0; row < iNumRows; ++row )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, row )
 	{
 		for ( int i = 0; i < in.GetNumTracks(); i++ )
 		{
@@ -459,10 +511,9 @@ float NoteDataUtil::GetChaosRadarValue( const NoteData &in, float fSongSeconds )
 		return 0.0f;
 	// count number of triplets or 16ths
 	int iNumChaosNotes = 0;
-	int rows = in.GetLastRow();
-	for( int r=0; r<=rows; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
-		if( !in.IsRowEmpty(r)  &&  GetNoteType(r) >= NOTE_TYPE_12TH )
+		if( GetNoteType(r) >= NOTE_TYPE_12TH )
 			iNumChaosNotes++;
 	}
 
@@ -494,11 +545,8 @@ void NoteDataUtil::RemoveSimultaneousNotes(NoteData &in, int iMaxSimultaneous, f
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
 	// turn all the HoldNotes into TapNotes
-	for( int r=iStartIndex; r<=iEndIndex; r++ )	// iterate backwards so we can delete
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( in, r, iStartIndex, iEndIndex )
 	{
-		if( in.IsRowEmpty(r) )
-			continue;	// skip
-
 		set<int> viTracksHeld;
 		in.GetTracksHeldAtRow( r, viTracksHeld );
 
@@ -549,7 +597,7 @@ void NoteDataUtil::RemoveMines(NoteData &in, float fStartBeat, float fEndBeat )
 	int iRowStart = BeatToNoteRow(fStartBeat);
 	int iRowEnd = BeatToNoteRow(fEndBeat);
 	for( int t=0; t<in.GetNumTracks(); t++ )
-		for( int r=iRowStart; r<=iRowEnd; r++ ) 
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( in, t, r, iRowStart, iRowEnd )
 			if( in.GetTapNote(t,r).type == TapNote::mine )
 				in.SetTapNote( t, r, TAP_EMPTY );
 }
@@ -701,7 +749,7 @@ static void SuperShuffleTaps( NoteData &in, int iStartIndex, int iEndIndex )
 	 *
 	 * This is only called by NoteDataUtil::Turn.  "in" is in 4s, and iStartIndex
 	 * and iEndIndex are in range. */
-	for( int r=iStartIndex; r<=iEndIndex; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( in, r, iStartIndex, iEndIndex )
 	{
 		for( int t1=0; t1<in.GetNumTracks(); t1++ )
 		{
@@ -756,7 +804,7 @@ void NoteDataUtil::Turn( NoteData &in, StepsType st, TrackMapping tt, float fSta
 
 	// transform notes
 	for( int t=0; t<in.GetNumTracks(); t++ )
-		for( int r=iStartIndex; r<=iEndIndex; r++ ) 			
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( tempNoteData, iTakeFromTrack[t], r, iStartIndex, iEndIndex )
 			tempNoteDataOut.SetTapNote(t, r, tempNoteData.GetTapNote(iTakeFromTrack[t], r));
 
 	if( tt == super_shuffle )
@@ -788,8 +836,7 @@ void NoteDataUtil::Backwards( NoteData &in )
 void NoteDataUtil::SwapSides( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		for( int t=0; t<in.GetNumTracks()/2; t++ )
 		{
@@ -811,11 +858,10 @@ void NoteDataUtil::Little(NoteData &in, float fStartBeat, float fEndBeat)
 	int i;
 
 	// filter out all non-quarter notes
-	int max_row = in.GetLastRow();
-	for( i=0; i<=max_row; i+=1 ) 
-		if( i % ROWS_PER_BEAT != 0 )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
+		if( r % ROWS_PER_BEAT != 0 )
 			for( int c=0; c<in.GetNumTracks(); c++ ) 
-				in.SetTapNote( c, i, TAP_EMPTY );
+				in.SetTapNote( c, r, TAP_EMPTY );
 
 	for( i=in.GetNumHoldNotes()-1; i>=0; i-- )
 		if( fmodf(in.GetHoldNote(i).GetStartBeat(),1) != 0 )	// doesn't start on a beat
@@ -1308,8 +1354,7 @@ void NoteDataUtil::SnapToNearestNoteType( NoteData &in, NoteType nt1, NoteType n
 void NoteDataUtil::CopyLeftToRight( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		for( int t=0; t<in.GetNumTracks()/2; t++ )
 		{
@@ -1329,8 +1374,7 @@ void NoteDataUtil::CopyLeftToRight( NoteData &in )
 void NoteDataUtil::CopyRightToLeft( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		for( int t=0; t<in.GetNumTracks()/2; t++ )
 		{
@@ -1350,8 +1394,7 @@ void NoteDataUtil::CopyRightToLeft( NoteData &in )
 void NoteDataUtil::ClearLeft( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 		for( int t=0; t<in.GetNumTracks()/2; t++ )
 			in.SetTapNote(t, r, TAP_EMPTY);
 	in.Convert4sToHoldNotes();
@@ -1360,8 +1403,7 @@ void NoteDataUtil::ClearLeft( NoteData &in )
 void NoteDataUtil::ClearRight( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 		for( int t=(in.GetNumTracks()+1)/2; t<in.GetNumTracks(); t++ )
 			in.SetTapNote(t, r, TAP_EMPTY);
 	in.Convert4sToHoldNotes();
@@ -1370,8 +1412,7 @@ void NoteDataUtil::ClearRight( NoteData &in )
 void NoteDataUtil::CollapseToOne( NoteData &in )
 {
 	in.ConvertHoldNotesTo2sAnd3s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 		for( int t=0; t<in.GetNumTracks(); t++ )
 			if( in.GetTapNote(t,r).type != TapNote::empty )
 			{
@@ -1385,8 +1426,7 @@ void NoteDataUtil::CollapseToOne( NoteData &in )
 void NoteDataUtil::CollapseLeft( NoteData &in )
 {
 	in.ConvertHoldNotesTo2sAnd3s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		int iNumTracksFilled = 0;
 		for( int t=0; t<in.GetNumTracks(); t++ )
@@ -1404,8 +1444,7 @@ void NoteDataUtil::CollapseLeft( NoteData &in )
 void NoteDataUtil::ShiftLeft( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		for( int t=0; t<in.GetNumTracks()-1; t++ )	// in.GetNumTracks()-1 times
 		{
@@ -1425,8 +1464,7 @@ void NoteDataUtil::ShiftLeft( NoteData &in )
 void NoteDataUtil::ShiftRight( NoteData &in )
 {
 	in.ConvertHoldNotesTo4s();
-	int max_row = in.GetLastRow();
-	for( int r=0; r<=max_row; r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		for( int t=in.GetNumTracks()-1; t>0; t-- )	// in.GetNumTracks()-1 times
 		{
@@ -1473,7 +1511,7 @@ void NoteDataUtil::FixImpossibleRows( NoteData &in, StepsType st )
 		return;
 
 	// each row must pass at least one valid mask
-	for( int r=0; r<in.GetNumRows(); r++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS( in, r )
 	{
 		// only check rows with jumps
 		if( in.GetNumTapNonEmptyTracks(r) < 2 )
@@ -1508,8 +1546,8 @@ bool NoteDataUtil::RowPassesValidMask( NoteData &in, int row, const bool bValidM
 
 void NoteDataUtil::ConvertAdditionsToRegular( NoteData &in )
 {
-	for( int r=0; r<=in.GetLastRow(); r++ )
-		for( int t=0; t<in.GetNumTracks(); t++ )
+	for( int t=0; t<in.GetNumTracks(); t++ )
+		FOREACH_NONEMPTY_ROW_IN_TRACK( in, t, r )
 			if( in.GetTapNote(t,r).source == TapNote::addition )
 			{
 				TapNote tn = in.GetTapNote(t,r);
@@ -17,7 +17,7 @@ struct RadarValues;
 namespace NoteDataUtil
 {
 	NoteType GetSmallestNoteTypeForMeasure( const NoteData &n, int iMeasureIndex );
-	void LoadFromSMNoteDataString( NoteData &out, CString sSMNoteData, const CString &sSMAttackData );
+	void LoadFromSMNoteDataString( NoteData &out, const CString &sSMNoteData, const CString &sSMAttackData );
 	void GetSMNoteDataString( const NoteData &in, CString &notes_out, CString &attacks_out );
 	void LoadTransformedSlidingWindow( const NoteData &in, NoteData &out, int iNewNumTracks );
 	void LoadOverlapped( const NoteData &in, NoteData &out, int iNewNumTracks );
@@ -26,14 +26,14 @@ int NoteDataWithScoring::GetNumTapNotesWithScore( TapNoteScore tns, const float
 	if(fEndBeat == -1)
 		fEndBeat = GetNumBeats()+1;
 
-	unsigned iStartIndex = BeatToNoteRow( fStartBeat );
-	unsigned iEndIndex = BeatToNoteRow( fEndBeat );
+	int iStartIndex = BeatToNoteRow( fStartBeat );
+	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	for( unsigned i=iStartIndex; i<min(float(iEndIndex), float(m_TapNoteScores[0].size())); i++ )
+	for( int t=0; t<GetNumTracks(); t++ )
 	{
-		for( int t=0; t<GetNumTracks(); t++ )
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( *this, t, i, iStartIndex, iEndIndex-1 )
 		{
-			if( this->GetTapNote(t, i).type != TapNote::empty && GetTapNoteScore(t, i) >= tns )
+			if( GetTapNoteScore(t, i) >= tns )
 				iNumSuccessfulTapNotes++;
 		}
 	}
@@ -49,11 +49,8 @@ int NoteDataWithScoring::GetNumNWithScore( TapNoteScore tns, int MinTaps, const
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-
 	int iNumSuccessfulDoubles = 0;
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 	{
 		int iNumNotesThisIndex = 0;
 		TapNoteScore minTapNoteScore = TNS_MARVELOUS;
@@ -104,13 +101,10 @@ int NoteDataWithScoring::GetSuccessfulMines( float fStartBeat, float fEndBeat )
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-
 	int iNumSuccessfulMinesNotes = 0;
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	for( int t=0; t<GetNumTracks(); t++ )
 	{
-		for( int t=0; t<GetNumTracks(); t++ )
+		FOREACH_NONEMPTY_ROW_IN_TRACK_RANGE( *this, t, i, iStartIndex, iEndIndex )
 		{
 			if( this->GetTapNote(t,i).type == TapNote::mine  &&  GetTapNoteScore(t, i) != TNS_HIT_MINE )
 				iNumSuccessfulMinesNotes++;
@@ -129,12 +123,8 @@ int NoteDataWithScoring::GetSuccessfulHands( float fStartBeat, float fEndBeat )
 	int iStartIndex = BeatToNoteRow( fStartBeat );
 	int iEndIndex = BeatToNoteRow( fEndBeat );
 
-	/* Clamp to known-good ranges. */
-	iStartIndex = max( iStartIndex, 0 );
-	iEndIndex = min( iEndIndex, GetNumRows()-1 );
-
 	int iNum = 0;
-	for( int i=iStartIndex; i<=iEndIndex; i++ )
+	FOREACH_NONEMPTY_ROW_ALL_TRACKS_RANGE( *this, i, iStartIndex, iEndIndex )
 	{
 		if( !RowNeedsHands(i) )
 			continue;
@@ -142,7 +132,7 @@ int NoteDataWithScoring::GetSuccessfulHands( float fStartBeat, float fEndBeat )
 		bool Missed = false;
 		for( int t=0; t<GetNumTracks(); t++ )
 		{
-			TapNote tn = GetTapNoteX(t, i);
+			TapNote tn = GetTapNote(t, i);
 			if( tn.type == TapNote::empty )
 				continue;
 			if( tn.type == TapNote::mine ) // mines don't count
@@ -550,12 +550,34 @@ Actor* NoteDisplay::GetHoldTailActor( float fNoteBeat, bool bIsBeingHeld )
 	return pActorOut;
 }
 
-static float ArrowGetAlphaOrGlow( bool bGlow, PlayerNumber pn, int iCol, float fYOffset, float fPercentFadeToFail, float fYReverseOffsetPixels )
+/* The wavy parts are drawn as a strip of vertex pairs, one pair every fYStep
+ * pixels from fYStart, always ending exactly on fYStop.  Fill in the Y position
+ * of each pair and evaluate the arrow effects for all of them at once.  Returns
+ * the number of pairs. */
+static float g_fYPos[size/2], g_fYOffset[size/2], g_fX[size/2], g_fZ[size/2], g_fAlpha[size/2];
+static int GetWavyPartPoints( PlayerNumber pn, int iCol, float fYStart, float fYStop, int fYStep, float fPercentFadeToFail, float fYReverseOffsetPixels, bool bGlow )
 {
+	int iCount = 0;
+	bool bLast = false;
+	for( float fY = fYStart; !bLast && iCount < size/2; fY += fYStep )
+	{
+		if( fY >= fYStop )
+		{
+			fY = fYStop;
+			bLast = true;
+		}
+		g_fYPos[iCount++] = fY;
+	}
+
+	ArrowGetYOffsetsFromYPos( pn, iCol, g_fYPos, g_fYOffset, iCount, fYReverseOffsetPixels );
+	ArrowGetXPositions( pn, iCol, g_fYOffset, g_fX, iCount );
+	ArrowGetZPositions( pn, g_fYOffset, g_fZ, iCount );
 	if( bGlow )
-		return ArrowGetGlow( pn, iCol, fYOffset, fPercentFadeToFail, fYReverseOffsetPixels );
+		ArrowGetGlows( pn, iCol, g_fYOffset, g_fAlpha, iCount, fPercentFadeToFail );
 	else
-		return ArrowGetAlpha( pn, iCol, fYOffset, fPercentFadeToFail, fYReverseOffsetPixels );
+		ArrowGetAlphas( pn, iCol, g_fYOffset, g_fAlpha, iCount, fPercentFadeToFail );
+
+	return iCount;
 }
 
 void NoteDisplay::DrawHoldTopCap( const HoldNote& hn, const bool bIsBeingHeld, float fYHead, float fYTail, int fYStep, int iCol, float fPercentFadeToFail, float fColorScale, bool bGlow )
@@ -586,28 +608,21 @@ void NoteDisplay::DrawHoldTopCap( const HoldNote& hn, const bool bIsBeingHeld, f
 		fColorScale = 1;
 
 	bool bAllAreTransparent = true;
-	bool bLast = false;
 	// don't draw any part of the head that is after the middle of the tail
-	float fY = fYCapTop;
-	float fYStop = min(fYTail,fYCapBottom);
-	for( ; !bLast; fY+=fYStep )
+	const float fYStop = min(fYTail,fYCapBottom);
+	const int iCount = GetWavyPartPoints( m_PlayerNumber, iCol, fYCapTop, fYStop, fYStep, fPercentFadeToFail, m_fYReverseOffsetPixels, bGlow );
+	for( int i = 0; i < iCount; ++i )
 	{
-		if( fY >= fYStop )
-		{
-			fY = fYStop;
-			bLast = true;
-		}
-
-		const float fYOffset				= ArrowGetYOffsetFromYPos( m_PlayerNumber, iCol, fY, m_fYReverseOffsetPixels );
-		const float fZ						= ArrowGetZPos(	m_PlayerNumber, fYOffset );
-		const float fX						= ArrowGetXPos( m_PlayerNumber, iCol, fYOffset );
+		const float fY						= g_fYPos[i];
+		const float fZ						= g_fZ[i];
+		const float fX						= g_fX[i];
 		const float fXLeft					= fX - fFrameWidth*0.5f;
 		const float fXRight					= fX + fFrameWidth*0.5f;
 		const float fTopDistFromHeadTop		= fY - fYCapTop;
 		const float fTexCoordTop			= SCALE( fTopDistFromHeadTop, 0, fFrameHeight, pRect->top, pRect->bottom );
 		const float fTexCoordLeft			= pRect->left;
 		const float fTexCoordRight			= pRect->right;
-		const float	fAlpha					= ArrowGetAlphaOrGlow( bGlow, m_PlayerNumber, iCol, fYOffset, fPercentFadeToFail, m_fYReverseOffsetPixels );
+		const float	fAlpha					= g_fAlpha[i];
 		const RageColor color				= RageColor(fColorScale,fColorScale,fColorScale,fAlpha);
 		const RageVColor vcolor				= (RageVColor)color;
 
@@ -617,8 +632,6 @@ void NoteDisplay::DrawHoldTopCap( const HoldNote& hn, const bool bIsBeingHeld, f
 		v[0].p = RageVector3(fXLeft,  fY, fZ); v[0].c = vcolor; v[0].t = RageVector2(fTexCoordLeft,  fTexCoordTop),
 		v[1].p = RageVector3(fXRight, fY, fZ); v[1].c = vcolor; v[1].t = RageVector2(fTexCoordRight, fTexCoordTop);
 		v+=2;
-		if( v-queue >= size )
-			break;
 	}
 	if( !bAllAreTransparent )
 		DISPLAY->DrawQuadStrip( queue, v-queue );
@@ -657,18 +670,12 @@ void NoteDisplay::DrawHoldBody( const HoldNote& hn, const bool bIsBeingHeld, flo
 
 	// top to bottom
 	bool bAllAreTransparent = true;
-	bool bLast = false;
-	for( float fY = fYBodyTop; !bLast; fY += fYStep )
+	const int iCount = GetWavyPartPoints( m_PlayerNumber, iCol, fYBodyTop, fYBodyBottom, fYStep, fPercentFadeToFail, m_fYReverseOffsetPixels, bGlow );
+	for( int i = 0; i < iCount; ++i )
 	{
-		if( fY >= fYBodyBottom )
-		{
-			fY = fYBodyBottom;
-			bLast = true;
-		}
-
-		const float fYOffset			= ArrowGetYOffsetFromYPos( m_PlayerNumber, iCol, fY, m_fYReverseOffsetPixels );
-		const float fZ					= ArrowGetZPos(	m_PlayerNumber, fYOffset );
-		const float fX					= ArrowGetXPos( m_PlayerNumber, iCol, fYOffset );
+		const float fY					= g_fYPos[i];
+		const float fZ					= g_fZ[i];
+		const float fX					= g_fX[i];
 		const float fXLeft				= fX - fFrameWidth*0.5f;
 		const float fXRight				= fX + fFrameWidth*0.5f;
 		const float fDistFromBodyBottom	= fYBodyBottom - fY;
@@ -676,7 +683,7 @@ void NoteDisplay::DrawHoldBody( const HoldNote& hn, const bool bIsBeingHeld, flo
 		const float fTexCoordTop		= SCALE( bAnchorToBottom ? fDistFromBodyTop : fDistFromBodyBottom,    0, fFrameHeight, pRect->bottom, pRect->top );
 		const float fTexCoordLeft		= pRect->left;
 		const float fTexCoordRight		= pRect->right;
-		const float	fAlpha				= ArrowGetAlphaOrGlow( bGlow, m_PlayerNumber, iCol, fYOffset, fPercentFadeToFail, m_fYReverseOffsetPixels );
+		const float	fAlpha				= g_fAlpha[i];
 		const RageColor color			= RageColor(fColorScale,fColorScale,fColorScale,fAlpha);
 		const RageVColor vcolor			= (RageVColor)color;
 
@@ -686,8 +693,6 @@ void NoteDisplay::DrawHoldBody( const HoldNote& hn, const bool bIsBeingHeld, flo
 		v[0].p = RageVector3(fXLeft,  fY, fZ);	v[0].c = vcolor; v[0].t = RageVector2(fTexCoordLeft,  fTexCoordTop);
 		v[1].p = RageVector3(fXRight, fY, fZ);	v[1].c = vcolor; v[1].t = RageVector2(fTexCoordRight, fTexCoordTop);
 		v+=2;
-		if( v-queue >= size )
-			break;
 	}
 
 	if( !bAllAreTransparent )
@@ -722,27 +727,21 @@ void NoteDisplay::DrawHoldBottomCap( const HoldNote& hn, const bool bIsBeingHeld
 		fColorScale = 1;
 
 	bool bAllAreTransparent = true;
-	bool bLast = false;
 	// don't draw any part of the tail that is before the middle of the head
-	float fY=max( fYCapTop, fYHead );
-	for( ; !bLast; fY += fYStep )
+	const float fYStart = max( fYCapTop, fYHead );
+	const int iCount = GetWavyPartPoints( m_PlayerNumber, iCol, fYStart, fYCapBottom, fYStep, fPercentFadeToFail, m_fYReverseOffsetPixels, bGlow );
+	for( int i = 0; i < iCount; ++i )
 	{
-		if( fY >= fYCapBottom )
-		{
-			fY = fYCapBottom;
-			bLast = true;
-		}
-
-		const float fYOffset				= ArrowGetYOffsetFromYPos( m_PlayerNumber, iCol, fY, m_fYReverseOffsetPixels );
-		const float fZ						= ArrowGetZPos(	m_PlayerNumber, fYOffset );
-		const float fX						= ArrowGetXPos( m_PlayerNumber, iCol, fYOffset );
+		const float fY						= g_fYPos[i];
+		const float fZ						= g_fZ[i];
+		const float fX						= g_fX[i];
 		const float fXLeft					= fX - fFrameWidth*0.5f;
 		const float fXRight					= fX + fFrameWidth*0.5f;
 		const float fTopDistFromTail		= fY - fYCapTop;
 		const float fTexCoordTop			= SCALE( fTopDistFromTail,    0, fFrameHeight, pRect->top, pRect->bottom );
 		const float fTexCoordLeft			= pRect->left;
 		const float fTexCoordRight			= pRect->right;
-		const float	fAlpha					= ArrowGetAlphaOrGlow( bGlow, m_PlayerNumber, iCol, fYOffset, fPercentFadeToFail, m_fYReverseOffsetPixels );
+		const float	fAlpha					= g_fAlpha[i];
 		const RageColor color				= RageColor(fColorScale,fColorScale,fColorScale,fAlpha);
 		const RageVColor vcolor				= (RageVColor)color;
 
@@ -752,8 +751,6 @@ void NoteDisplay::DrawHoldBottomCap( const HoldNote& hn, const bool bIsBeingHeld
 		v[0].p = RageVector3(fXLeft,  fY, fZ);	v[0].c = vcolor; v[0].t = RageVector2(fTexCoordLeft,  fTexCoordTop),
 		v[1].p = RageVector3(fXRight, fY, fZ);	v[1].c = vcolor; v[1].t = RageVector2(fTexCoordRight, fTexCoordTop);
 		v+=2;
-		if( v-queue >= size )
-			break;
 	}
 	if( !bAllAreTransparent )
 		DISPLAY->DrawQuadStrip( queue, v-queue );
@@ -926,23 +923,17 @@ void NoteDisplay::DrawHold( const HoldNote& hn, bool bIsBeingHeld, bool bIsActiv
 		DrawHold( hn, bIsBeingHeld, bIsActive, Result, fPercentFadeToFail, true, fReverseOffsetPixels );
 }
 
-void NoteDisplay::DrawActor( Actor* pActor, int iCol, float fBeat, float fPercentFadeToFail, float fLife, float fReverseOffsetPixels, bool bUseLighting )
+void NoteDisplay::DrawActor( Actor* pActor, float fBeat, const Placement &pos, float fLife, bool bUseLighting )
 {
-	const float fYOffset		= ArrowGetYOffset(	m_PlayerNumber, iCol, fBeat );
-	const float fYPos			= ArrowGetYPos(		m_PlayerNumber, iCol, fYOffset, fReverseOffsetPixels );
 	const float fRotation		= ArrowGetRotation(	m_PlayerNumber, fBeat );
-	const float fXPos			= ArrowGetXPos(		m_PlayerNumber, iCol, fYOffset );
-	const float fZPos			= ArrowGetZPos(		m_PlayerNumber, fYOffset );
-	const float fAlpha			= ArrowGetAlpha(	m_PlayerNumber, iCol, fYOffset, fPercentFadeToFail, m_fYReverseOffsetPixels );
-	const float fGlow			= ArrowGetGlow(		m_PlayerNumber, iCol, fYOffset, fPercentFadeToFail, m_fYReverseOffsetPixels );
 	const float fColorScale		= ArrowGetBrightness( m_PlayerNumber, fBeat ) * SCALE(fLife,0,1,0.2f,1);
 	const float fZoom			= ArrowGetZoom(		m_PlayerNumber );
-	const RageColor diffuse		= RageColor(fColorScale,fColorScale,fColorScale,fAlpha);
-	const RageColor glow		= RageColor(1,1,1,fGlow);
+	const RageColor diffuse		= RageColor(fColorScale,fColorScale,fColorScale,pos.fAlpha);
+	const RageColor glow		= RageColor(1,1,1,pos.fGlow);
 
 	pActor->SetRotationZ( fRotation );
-	pActor->SetXY( fXPos, fYPos );
-	pActor->SetZ( fZPos );
+	pActor->SetXY( pos.fXPos, pos.fYPos );
+	pActor->SetZ( pos.fZPos );
 	pActor->SetDiffuse( diffuse );
 	pActor->SetGlow( glow );
 	pActor->SetZoom( fZoom );
@@ -966,7 +957,7 @@ void NoteDisplay::DrawActor( Actor* pActor, int iCol, float fBeat, float fPercen
 	}
 }
 
-void NoteDisplay::DrawTap( int iCol, float fBeat, bool bOnSameRowAsHoldStart, bool bIsAddition, bool bIsMine, float fPercentFadeToFail, float fLife, float fReverseOffsetPixels )
+void NoteDisplay::DrawTap( float fBeat, const Placement &pos, bool bOnSameRowAsHoldStart, bool bIsAddition, bool bIsMine, float fLife )
 {
 	Actor* pActor = NULL;
 	bool bUseLighting = false;
@@ -991,7 +982,7 @@ void NoteDisplay::DrawTap( int iCol, float fBeat, bool bOnSameRowAsHoldStart, bo
 		bUseLighting = cache->m_bTapNoteUseLighting;
 	}
 
-	DrawActor( pActor, iCol, fBeat, fPercentFadeToFail, fLife, fReverseOffsetPixels, bUseLighting );
+	DrawActor( pActor, fBeat, pos, fLife, bUseLighting );
 }
 
 /*
@@ -21,8 +21,15 @@ public:
 
 	static void Update( float fDeltaTime );
 
-	void DrawActor( Actor* pActor, int iCol, float fBeat, float fPercentFadeToFail, float fLife, float fReverseOffsetPixels, bool bUseLighting );
-	void DrawTap( int iCol, float fBeat, bool bOnSameRowAsHoldStart, bool bIsAddition, bool bIsMine, float fPercentFadeToFail, float fLife, float fReverseOffsetPixels );
+	/* Where an arrow goes and how visible it is; the caller evaluates these
+	 * for many arrows at once with the ArrowEffects batch functions. */
+	struct Placement
+	{
+		float fXPos, fYPos, fZPos;
+		float fAlpha, fGlow;
+	};
+	void DrawActor( Actor* pActor, float fBeat, const Placement &pos, float fLife, bool bUseLighting );
+	void DrawTap( float fBeat, const Placement &pos, bool bOnSameRowAsHoldStart, bool bIsAddition, bool bIsMine, float fLife );
 	void DrawHold( const HoldNote& hn, bool bIsBeingHeld, bool bIsActive, const HoldNoteResult &Result, float fPercentFadeToFail, bool bDrawGlowOnly, float fReverseOffsetPixels );
 
 protected:
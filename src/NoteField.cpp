@@ -84,10 +84,8 @@ void NoteField::Load( const NoteData* pNoteData, PlayerNumber pn, int iFirstPixe
 
 	NoteDataWithScoring::Init();
 
-	m_HeldHoldNotes.clear();
-	m_ActiveHoldNotes.clear();
-
 	this->CopyAll( pNoteData );
+	ClearHoldNoteFlags();
 	ASSERT( GetNumTracks() == GAMESTATE->GetCurrentStyle()->m_iColsPerPlayer );
 
 	CacheAllUsedNoteSkins();
@@ -398,6 +396,8 @@ void NoteField::DrawPrimitives()
 	/* This should be filled in on the first update. */
 	ASSERT( !m_BeatToNoteDisplays.empty() );
 
+	ArrowEffectsUpdate( m_PlayerNumber );
+
 	NoteDisplayCols *cur = SearchForSongBeat();
 	cur->m_ReceptorArrowRow.Draw();
 
@@ -527,37 +527,45 @@ void NoteField::DrawPrimitives()
 		NDMap::iterator CurDisplay = m_BeatToNoteDisplays.begin();
 		ASSERT( CurDisplay != m_BeatToNoteDisplays.end() );
 		NDMap::iterator NextDisplay = CurDisplay; ++NextDisplay;
-		for( i=0; i < GetNumHoldNotes(); i++ )
+		// Only look at the holds in this column that are at least partly on the screen.
+		static vector<int> viHolds;
+		static vector<float> vfHoldStartBeats, vfHoldEndBeats, vfHoldStartYOffsets, vfHoldEndYOffsets;
+		viHolds.clear();
+		GetHoldNotesInRange( c, iFirstIndexToDraw, iLastIndexToDraw, viHolds );
+
+		// Get the offsets of both ends of every hold at once.
+		vfHoldStartBeats.resize( viHolds.size() );
+		vfHoldEndBeats.resize( viHolds.size() );
+		vfHoldStartYOffsets.resize( viHolds.size() );
+		vfHoldEndYOffsets.resize( viHolds.size() );
+		for( unsigned h=0; h < viHolds.size(); h++ )
 		{
-			const HoldNote &hn = GetHoldNote(i);
-			if( hn.iTrack != c )	// this HoldNote doesn't belong to this column
-				continue;
-
-#if 0
-			const HoldNoteResult Result = GetHoldNoteResult( hn );
-			if( Result.hns == HNS_OK )	// if this HoldNote was completed
-				continue;	// don't draw anything
+			const HoldNote &hn = GetHoldNote( viHolds[h] );
+			vfHoldStartBeats[h] = NoteRowToBeat( hn.iStartRow );
+			vfHoldEndBeats[h] = NoteRowToBeat( hn.iEndRow );
+		}
+		if( !viHolds.empty() )
+		{
+			ArrowGetYOffsets( m_PlayerNumber, &vfHoldStartBeats[0], &vfHoldStartYOffsets[0], viHolds.size() );
+			ArrowGetYOffsets( m_PlayerNumber, &vfHoldEndBeats[0], &vfHoldEndYOffsets[0], viHolds.size() );
+		}
 
-			// If no part of this HoldNote is on the screen, skip it
-			if( !hn.RangeOverlaps(iFirstIndexToDraw, iLastIndexToDraw) )
-				continue;	// skip
-#else
-			// If no part of this HoldNote is on the screen, skip it
-			if( !hn.RangeOverlaps(iFirstIndexToDraw, iLastIndexToDraw) )
-				continue;	// skip
+		for( unsigned h=0; h < viHolds.size(); h++ )
+		{
+			const int iHold = viHolds[h];
+			const HoldNote &hn = GetHoldNote(iHold);
 
 			const HoldNoteResult Result = GetHoldNoteResult( hn );
 			if( Result.hns == HNS_OK )	// if this HoldNote was completed
 				continue;	// don't draw anything
-#endif
 
-			const float fStartBeat = NoteRowToBeat(hn.iStartRow);
+			const float fStartBeat = vfHoldStartBeats[h];
 
 			// TRICKY: If boomerang is on, then all notes in the range 
 			// [iFirstIndexToDraw,iLastIndexToDraw] aren't necessarily visible.
 			// Test every note to make sure it's on screen before drawing
-			float fYStartOffset = ArrowGetYOffset( m_PlayerNumber, 0, fStartBeat );
-			float fYEndOffset = ArrowGetYOffset( m_PlayerNumber, 0, NoteRowToBeat(hn.iEndRow) );
+			float fYStartOffset = vfHoldStartYOffsets[h];
+			float fYEndOffset = vfHoldEndYOffsets[h];
 			if( !( (iFirstPixelToDraw <= fYEndOffset && fYEndOffset <= iLastPixelToDraw)  ||
 				(iFirstPixelToDraw <= fYStartOffset  && fYStartOffset <= iLastPixelToDraw)  ||
 				(fYStartOffset < iFirstPixelToDraw   && fYEndOffset > iLastPixelToDraw) ) )
@@ -565,8 +573,8 @@ void NoteField::DrawPrimitives()
 				continue;	// skip
 			}
 
-			const bool bIsActive = m_ActiveHoldNotes[hn];
-			const bool bIsHoldingNote = m_HeldHoldNotes[hn];
+			const bool bIsActive = iHold < (int) m_bActiveHoldNotes.size() && m_bActiveHoldNotes[iHold];
+			const bool bIsHoldingNote = iHold < (int) m_bHeldHoldNotes.size() && m_bHeldHoldNotes[iHold];
 			if( bIsActive )
 				SearchForSongBeat()->m_GhostArrowRow.SetHoldIsActive( hn.iTrack );
 			
@@ -587,6 +595,12 @@ void NoteField::DrawPrimitives()
 		CurDisplay = m_BeatToNoteDisplays.begin();
 		NextDisplay = CurDisplay; ++NextDisplay;
 
+		// Find the rows to draw, and get all of their offsets at once.
+		static vector<int> viRows;
+		static vector<float> vfBeats, vfYOffsets, vfYPos, vfX, vfZ, vfAlpha, vfGlow;
+		viRows.clear();
+		vfBeats.clear();
+
 		// draw notes from furthest to closest
 		for( i=iLastIndexToDraw; i>=iFirstIndexToDraw; --i )	//	 for each row
 		{	
@@ -597,16 +611,54 @@ void NoteField::DrawPrimitives()
 			if( tn.type == TapNote::hold_head )	// this is a HoldNote begin marker.  Grade it, but don't draw
 				continue;	// skip
 
-			const float fBeat = NoteRowToBeat(i);
+			viRows.push_back( i );
+			vfBeats.push_back( NoteRowToBeat(i) );
+		}
 
-			// TRICKY: If boomerang is on, then all notes in the range 
-			// [iFirstIndexToDraw,iLastIndexToDraw] aren't necessarily visible.
-			// Test every note to make sure it's on screen before drawing
-			float fYOffset = ArrowGetYOffset( m_PlayerNumber, 0, fBeat );
+		vfYOffsets.resize( vfBeats.size() );
+		if( !vfBeats.empty() )
+			ArrowGetYOffsets( m_PlayerNumber, &vfBeats[0], &vfYOffsets[0], vfBeats.size() );
+
+		// TRICKY: If boomerang is on, then all notes in the range 
+		// [iFirstIndexToDraw,iLastIndexToDraw] aren't necessarily visible.
+		// Test every note to make sure it's on screen before drawing
+		unsigned iVisible = 0;
+		for( unsigned r=0; r<viRows.size(); r++ )
+		{
+			const float fYOffset = vfYOffsets[r];
 			if( fYOffset > iLastPixelToDraw )	// off screen
 				continue;	// skip
 			if( fYOffset < iFirstPixelToDraw )	// off screen
 				continue;	// skip
+			viRows[iVisible] = viRows[r];
+			vfBeats[iVisible] = vfBeats[r];
+			vfYOffsets[iVisible] = fYOffset;
+			++iVisible;
+		}
+		viRows.resize( iVisible );
+		vfBeats.resize( iVisible );
+		vfYOffsets.resize( iVisible );
+
+		// Place all of the visible arrows at once.
+		vfYPos.resize( iVisible );
+		vfX.resize( iVisible );
+		vfZ.resize( iVisible );
+		vfAlpha.resize( iVisible );
+		vfGlow.resize( iVisible );
+		if( iVisible )
+		{
+			ArrowGetYPositions( m_PlayerNumber, c, &vfYOffsets[0], &vfYPos[0], iVisible, m_fYReverseOffsetPixels );
+			ArrowGetXPositions( m_PlayerNumber, c, &vfYOffsets[0], &vfX[0], iVisible );
+			ArrowGetZPositions( m_PlayerNumber, &vfYOffsets[0], &vfZ[0], iVisible );
+			ArrowGetAlphas( m_PlayerNumber, c, &vfYOffsets[0], &vfAlpha[0], iVisible, m_fPercentFadeToFail );
+			ArrowGetGlows( m_PlayerNumber, c, &vfYOffsets[0], &vfGlow[0], iVisible, m_fPercentFadeToFail );
+		}
+
+		for( unsigned r=0; r<viRows.size(); r++ )
+		{
+			i = viRows[r];
+			TapNote tn = GetTapNote(c, i);
+			const float fBeat = vfBeats[r];
 
 			// See if there is a hold step that begins on this index.
 			bool bHoldNoteBeginsOnThisBeat = false;
@@ -623,6 +675,18 @@ void NoteField::DrawPrimitives()
 			if( m_fBeginMarker!=-1 && m_fEndMarker!=-1 )
 				bIsInSelectionRange = m_fBeginMarker<=fBeat && fBeat<=m_fEndMarker;
 
+			NoteDisplay::Placement pos;
+			pos.fXPos = vfX[r];
+			pos.fYPos = vfYPos[r];
+			pos.fZPos = vfZ[r];
+			pos.fAlpha = vfAlpha[r];
+			pos.fGlow = vfGlow[r];
+			if( bIsInSelectionRange )
+			{
+				ArrowGetAlphas( m_PlayerNumber, c, &vfYOffsets[r], &pos.fAlpha, 1, fSelectedRangeGlow );
+				ArrowGetGlows( m_PlayerNumber, c, &vfYOffsets[r], &pos.fGlow, 1, fSelectedRangeGlow );
+			}
+
 			bool bIsAddition = (tn.source == TapNote::addition);
 			bool bIsMine = (tn.type == TapNote::mine);
 			bool bIsAttack = (tn.type == TapNote::attack);
@@ -635,11 +699,11 @@ void NoteField::DrawPrimitives()
 				Sprite sprite;
 				sprite.Load( THEME->GetPathToG("NoteField attack "+attack.sModifier) );
 				SearchForBeat( CurDisplay, NextDisplay, fBeat );
-				CurDisplay->second->display[c].DrawActor( &sprite, c, fBeat, bIsInSelectionRange ? fSelectedRangeGlow : m_fPercentFadeToFail, 1, m_fYReverseOffsetPixels, false );
+				CurDisplay->second->display[c].DrawActor( &sprite, fBeat, pos, 1, false );
 			}
 			else
 			{
-				CurDisplay->second->display[c].DrawTap( c, fBeat, bHoldNoteBeginsOnThisBeat, bIsAddition, bIsMine, bIsInSelectionRange ? fSelectedRangeGlow : m_fPercentFadeToFail, 1, m_fYReverseOffsetPixels );
+				CurDisplay->second->display[c].DrawTap( fBeat, pos, bHoldNoteBeginsOnThisBeat, bIsAddition, bIsMine, 1 );
 			}
 		}
 
@@ -650,6 +714,30 @@ void NoteField::DrawPrimitives()
 	cur->m_GhostArrowRow.Draw();
 }
 
+void NoteField::ClearHoldNoteFlags()
+{
+	m_bHeldHoldNotes.assign( GetNumHoldNotes(), false );
+	m_bActiveHoldNotes.assign( GetNumHoldNotes(), false );
+}
+
+void NoteField::SetHoldNoteFlags( const HoldNote &hn, bool bHeld, bool bActive )
+{
+	/* Player's holds aren't necessarily in the same order as ours after a
+	 * transform, so find our copy by track and end row. */
+	static vector<int> viHolds;
+	viHolds.clear();
+	GetHoldNotesInRange( hn.iTrack, hn.iEndRow, hn.iEndRow, viHolds );
+	for( unsigned i=0; i<viHolds.size(); i++ )
+	{
+		const int iHold = viHolds[i];
+		if( GetHoldNote(iHold).iEndRow != hn.iEndRow || iHold >= (int) m_bHeldHoldNotes.size() )
+			continue;
+		m_bHeldHoldNotes[iHold] = bHeld;
+		m_bActiveHoldNotes[iHold] = bActive;
+		return;
+	}
+}
+
 void NoteField::RemoveTapNoteRow( int iIndex )
 {
 	for( int c=0; c<GetNumTracks(); c++ )
@@ -28,8 +28,10 @@ public:
 	virtual void Unload();
 	void RemoveTapNoteRow( int iIndex );
 
-	map<RowTrack,bool> m_HeldHoldNotes;	// true if button is being held down
-	map<RowTrack,bool> m_ActiveHoldNotes;	// true if hold has life > 0
+	/* Set hold flags so NoteField can do intelligent drawing.  Player clears
+	 * them and sets the ones for holds in progress on every update. */
+	void ClearHoldNoteFlags();
+	void SetHoldNoteFlags( const HoldNote &hn, bool bHeld, bool bActive );
 
 	float	m_fBeginMarker, m_fEndMarker;	// only used with MODE_EDIT
 
@@ -61,6 +63,10 @@ protected:
 	int				m_iEndDrawingPixel;	// this should be a positive number
 	float			m_fYReverseOffsetPixels;
 
+	/* Indexed like GetHoldNote. */
+	vector<bool>	m_bHeldHoldNotes;	// true if button is being held down
+	vector<bool>	m_bActiveHoldNotes;	// true if hold has life > 0
+
 	// color arrows
 	struct NoteDisplayCols
 	{
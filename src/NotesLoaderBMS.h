@@ -15,6 +15,7 @@ class BMSLoader: public NotesLoader
 	void PushTrackNumForMagic( int iTrackNum );
 	StepsType CheckTracksMagic();
 	void ResetTracksMagic();
+	int m_iTracks[MAX_NOTE_TRACKS];	/* number of notes seen in each BMS track */
 
 	void SlideDuplicateDifficulties( Song &p );
 
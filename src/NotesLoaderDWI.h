@@ -5,6 +5,7 @@
 
 #include "GameInput.h"
 #include "NotesLoader.h"
+#include <map>
 
 class Song;
 class Steps;
@@ -24,6 +25,7 @@ class DWILoader: public NotesLoader
 	static float ParseBrokenDWITimestamp(const CString &arg1, const CString &arg2, const CString &arg3);
 	static bool Is192( const CString &str, int pos );
 	CString m_sLoadingFile;
+	map<int,int> m_mapDanceNoteToNoteDataColumn;
 
 public:
 	void GetApplicableFiles( const CString &sPath, CStringArray &out );
@@ -352,6 +352,10 @@ bool SMLoader::LoadFromSMFile( const CString &sPath, Song &out )
 				sParams[1], sParams[2], sParams[3], sParams[4], sParams[5], sParams[6], (iNumParams>=8)?sParams[7]:CString(""),
 				*pNewNotes);
 
+			/* Remember where this tag is, so Steps::Decompress can reload it alone. */
+			if( FromCache )
+				pNewNotes->SetFileRange( sParams.iOffset, sParams.iLength );
+
 			out.AddSteps( pNewNotes );
 		}
 		else if( 0==stricmp(sValueName,"OFFSET") || 0==stricmp(sValueName,"BPMS") ||
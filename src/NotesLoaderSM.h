@@ -11,6 +11,9 @@ class MsdFile;
 
 class SMLoader: public NotesLoader
 {
+	bool FromCache;
+
+public:
 	static void LoadFromSMTokens( 
 		CString sStepsType, 
 		CString sDescription,
@@ -21,9 +24,6 @@ class SMLoader: public NotesLoader
 		const CString &sAttackData,		
 		Steps &out);
 
-	bool FromCache;
-
-public:
 	SMLoader() { FromCache = false; }
 	bool LoadFromSMFile( const CString &sPath, Song &out );
 	bool LoadFromSMFile( const CString &sPath, Song &out, bool cache )
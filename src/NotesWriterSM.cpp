@@ -212,7 +212,7 @@ bool NotesWriterSM::Write(CString sPath, const Song &out, bool bSavingCache)
 	const vector<Steps*>& vpSteps = out.GetAllSteps();
 	for( i=0; i<vpSteps.size(); i++ ) 
 	{
-		const Steps* pSteps = vpSteps[i];
+		Steps* pSteps = vpSteps[i];
 		if( pSteps->IsAutogen() )
 			continue; /* don't write autogen notes */
 
@@ -220,7 +220,13 @@ bool NotesWriterSM::Write(CString sPath, const Song &out, bool bSavingCache)
 		if( pSteps->WasLoadedFromProfile() )
 			continue;
 
+		const int iStart = f.Tell();
 		WriteSMNotesTag( *pSteps, f, bSavingCache );
+
+		/* Record where the tag went, so Steps::Decompress can read it back
+		 * without parsing the whole cache file. */
+		if( bSavingCache )
+			pSteps->SetFileRange( iStart, f.Tell() - iStart );
 	}
 
 	return true;
@@ -191,6 +191,10 @@ void PlayerMinus::Load( PlayerNumber pn, const NoteData* pNoteData, LifeMeter* p
 	m_pNoteField->SetY( fNoteFieldMidde );
 	m_fNoteFieldHeight = GRAY_ARROWS_Y_REVERSE-GRAY_ARROWS_Y_STANDARD;
 	m_pNoteField->Load( this, pn, iStartDrawingAtPixels, iStopDrawingAtPixels, m_fNoteFieldHeight );
+
+	/* Notes that have already gone by when we're loaded are never judged. */
+	for( int t=0; t<MAX_NOTE_TRACKS; t++ )
+		m_iFirstUnjudgedRow[t] = max( 0, m_iRowLastCrossed+1 );
 	m_ArrowBackdrop.SetPlayer( pn );
 
 	const bool bReverse = GAMESTATE->m_PlayerOptions[pn].GetReversePercentForColumn(0) == 1;
@@ -321,14 +325,12 @@ void PlayerMinus::Update( float fDeltaTime )
 	//
 	const float fAdjustedWindowOK = 1.0f / ADJUSTED_WINDOW(OK);
 	const int iMaxProTimingError = MAX_PRO_TIMING_ERROR;
+	m_pNoteField->ClearHoldNoteFlags();
 	for( int i=0; i < GetNumHoldNotes(); i++ )		// for each HoldNote
 	{
 		const HoldNote &hn = GetHoldNote(i);
 		HoldNoteScore hns = GetHoldNoteScore(hn);
 
-		m_pNoteField->m_HeldHoldNotes[hn] = false;	// set hold flag so NoteField can do intelligent drawing
-		m_pNoteField->m_ActiveHoldNotes[hn] = false;	// set hold flag so NoteField can do intelligent drawing
-
 
 		if( hns != HNS_NONE )	// if this HoldNote already has a result
 			continue;	// we don't need to update the logic for this one
@@ -354,8 +356,7 @@ void PlayerMinus::Update( float fDeltaTime )
 				bIsHoldingButton = true;
 
 			// set hold flag so NoteField can do intelligent drawing
-			m_pNoteField->m_HeldHoldNotes[hn] = bIsHoldingButton && bSteppedOnTapNote;
-			m_pNoteField->m_ActiveHoldNotes[hn] = bSteppedOnTapNote;
+			m_pNoteField->SetHoldNoteFlags( hn, bIsHoldingButton && bSteppedOnTapNote, bSteppedOnTapNote );
 
 			if( bSteppedOnTapNote )
 			{
@@ -486,6 +487,7 @@ void PlayerMinus::ApplyWaitingTransforms()
 
 		NoteDataUtil::TransformNoteData( *this, po, GAMESTATE->GetCurrentStyle()->m_StepsType, fStartBeat, fEndBeat );
 		m_pNoteField->CopyRange( this, BeatToNoteRow(fStartBeat), BeatToNoteRow(fEndBeat), BeatToNoteRow(fStartBeat) );
+		RewindMissCursors( BeatToNoteRow(fStartBeat) );
 	}
 	GAMESTATE->m_ModsToApply[m_PlayerNumber].clear();
 }
@@ -600,16 +602,30 @@ int PlayerMinus::GetClosestNoteDirectional( int col, float fBeat, float fMaxBeat
 	 * sure we always round up. */
 	const int iNumElementsToExamine = BeatToNoteRow( fMaxBeatsDistance + 1 );
 
-	// Start at iIndexStartLookingAt and search outward.
-	for( int delta=0; delta < iNumElementsToExamine; delta++ )
+	/* Start at iIndexStartLookingAt and search outward.  Only visit rows that
+	 * have a note in this column; empty rows aren't stored. */
+	const TrackMap &tm = GetTrack( col );
+	if( iDirection > 0 )
 	{
-		int iCurrentIndex = iIndexStartLookingAt + (iDirection * delta);
-
-		if( iCurrentIndex < 0) continue;
-		if( GetTapNote(col, iCurrentIndex).type == TapNote::empty) continue; /* no note here */
-		if( GetTapNoteScore(col, iCurrentIndex) != TNS_NONE ) continue;	/* this note has a score already */
-
-		return iCurrentIndex;
+		const int iEnd = iIndexStartLookingAt + iNumElementsToExamine;
+		TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), iIndexStartLookingAt );
+		for( ; it != tm.end() && it->iRow < iEnd; ++it )
+		{
+			if( GetTapNoteScore(col, it->iRow) != TNS_NONE ) continue;	/* this note has a score already */
+			return it->iRow;
+		}
+	}
+	else
+	{
+		const int iEnd = iIndexStartLookingAt - iNumElementsToExamine;
+		TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), iIndexStartLookingAt+1 );
+		while( it != tm.begin() )
+		{
+			--it;
+			if( it->iRow <= iEnd ) break;
+			if( GetTapNoteScore(col, it->iRow) != TNS_NONE ) continue;	/* this note has a score already */
+			return it->iRow;
+		}
 	}
 
 	return -1;
@@ -1002,47 +1018,54 @@ void PlayerMinus::UpdateTapNotesMissedOlderThan( float fMissIfOlderThanSeconds )
 		}
 	}
 
-	// Since this is being called every frame, let's not check the whole array every time.
-	// Instead, only check 10 elements back.  Even 10 is overkill.
-	const int iStartCheckingAt = max( 0, iMissIfOlderThanThisIndex-10 );
-
-	//LOG->Trace( "iStartCheckingAt: %d   iMissIfOlderThanThisIndex:  %d", iStartCheckingAt, iMissIfOlderThanThisIndex );
-
-	int iNumMissesFound = 0;
-	for( int r=iStartCheckingAt; r<iMissIfOlderThanThisIndex; r++ )
+	/* Since this is being called every frame, don't rescan rows.  Each column
+	 * resumes at its first unjudged tap, and only rows with notes are visited,
+	 * so each note is looked at here about once. */
+	vector<int> aMissedRows;
+	for( int t=0; t<GetNumTracks(); t++ )
 	{
-		bool MissedNoteOnThisRow = false;
-		for( int t=0; t<GetNumTracks(); t++ )
+		const TrackMap &tm = GetTrack( t );
+		TrackMap::const_iterator it = lower_bound( tm.begin(), tm.end(), m_iFirstUnjudgedRow[t] );
+		for( ; it != tm.end() && it->iRow < iMissIfOlderThanThisIndex; ++it )
 		{
-			switch( GetTapNote(t, r).type )
+			switch( it->tn.type )
 			{
-			case TapNote::empty:
 			case TapNote::attack:
-				continue; /* no note here */
+			case TapNote::mine:
+				continue; /* never missed */
 			}
 
-			if( GetTapNoteScore(t, r) != TNS_NONE ) /* note here is already hit */
+			if( GetTapNoteScore(t, it->iRow) != TNS_NONE ) /* note here is already hit */
 				continue; 
 			
-			if( GetTapNote(t, r).type != TapNote::mine )
-			{
-				// A normal note.  Penalize for not stepping on it.
-				MissedNoteOnThisRow = true;
-				SetTapNoteScore(t, r, TNS_MISS);
-				g_CurStageStats.iTotalError[m_PlayerNumber] += MAX_PRO_TIMING_ERROR;
-				m_ProTimingDisplay.SetJudgment( MAX_PRO_TIMING_ERROR, TNS_MISS );
-			}
+			// A normal note.  Penalize for not stepping on it.
+			aMissedRows.push_back( it->iRow );
+			SetTapNoteScore(t, it->iRow, TNS_MISS);
+			g_CurStageStats.iTotalError[m_PlayerNumber] += MAX_PRO_TIMING_ERROR;
+			m_ProTimingDisplay.SetJudgment( MAX_PRO_TIMING_ERROR, TNS_MISS );
 		}
 
-		if( MissedNoteOnThisRow )
-		{
-			iNumMissesFound++;
-			HandleTapRowScore( r );
-		}
+		/* Everything before here is judged now. */
+		m_iFirstUnjudgedRow[t] = max( m_iFirstUnjudgedRow[t], iMissIfOlderThanThisIndex );
 	}
 
-	if( iNumMissesFound > 0 )
-		m_Judgment.SetJudgment( TNS_MISS );
+	if( aMissedRows.empty() )
+		return;
+
+	/* Score each row once, in order. */
+	sort( aMissedRows.begin(), aMissedRows.end() );
+	aMissedRows.erase( unique(aMissedRows.begin(), aMissedRows.end()), aMissedRows.end() );
+	for( unsigned i=0; i<aMissedRows.size(); i++ )
+		HandleTapRowScore( aMissedRows[i] );
+
+	m_Judgment.SetJudgment( TNS_MISS );
+}
+
+void PlayerMinus::RewindMissCursors( int iRow )
+{
+	iRow = max( iRow, 0 );
+	for( int t=0; t<MAX_NOTE_TRACKS; t++ )
+		m_iFirstUnjudgedRow[t] = min( m_iFirstUnjudgedRow[t], iRow );
 }
 
 
@@ -1112,14 +1135,9 @@ void PlayerMinus::RandomiseNotes( int iNoteRow )
 			continue;
 
 		/* Make sure the destination row isn't in the middle of a hold. */
-		bool bSkip = false;
-		for( int i = 0; !bSkip && i < GetNumHoldNotes(); ++i )
-		{
-			const HoldNote &hn = GetHoldNote(i);
-			if( hn.iTrack == iSwapWith && hn.RowIsInRange(iNewNoteRow) )
-				bSkip = true;
-		}
-		if( bSkip )
+		vector<int> viHolds;
+		GetHoldNotesInRange( iSwapWith, iNewNoteRow, iNewNoteRow, viHolds );
+		if( !viHolds.empty() )
 			continue;
 		
 		SetTapNote( t, iNewNoteRow, t2 );
@@ -1129,6 +1147,9 @@ void PlayerMinus::RandomiseNotes( int iNoteRow )
 		const TapNote nft2 = m_pNoteField->GetTapNote( iSwapWith, iNewNoteRow );
 		m_pNoteField->SetTapNote( t, iNewNoteRow, nft2 );
 		m_pNoteField->SetTapNote( iSwapWith, iNewNoteRow, nft1 );
+
+		/* With a fast scroll speed, this row may already be behind us. */
+		RewindMissCursors( iNewNoteRow );
 	}
 }
 
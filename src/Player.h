@@ -62,6 +62,9 @@ protected:
 	int GetClosestNoteDirectional( int col, float fBeat, float fMaxBeatsAhead, int iDirection ) const;
 	int GetClosestNote( int col, float fBeat, float fMaxBeatsAhead, float fMaxBeatsBehind ) const;
 
+	/* Call when notes at or after iRow may have changed, so they're checked for misses again. */
+	void RewindMissCursors( int iRow );
+
 	PlayerNumber	m_PlayerNumber;
 	float			m_fNoteFieldHeight;
 
@@ -92,6 +95,10 @@ protected:
 	int				m_iRowLastCrossed;
 	int				m_iMineRowLastCrossed;
 
+	/* For each column, every tap before this row has been judged, so
+	 * UpdateTapNotesMissedOlderThan never looks at it again. */
+	int				m_iFirstUnjudgedRow[MAX_NOTE_TRACKS];
+
 	RageSound		m_soundMine;
 	RageSound		m_soundAttackLaunch;
 	RageSound		m_soundAttackEnding;
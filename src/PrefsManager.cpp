@@ -263,11 +263,13 @@ void PrefsManager::Init()
 	 * specify numbers directly.) This is purely a troubleshooting option
 	 * and is not honored by all sound drivers. */
 	m_iSoundWriteAhead = 0;
+	m_sSoundDrivers = "";	// default
 	m_fSoundVolume = DEFAULT_SOUND_VOLUME;
 
 	// StepMania.cpp sets these on first run:
 	m_iCpuClock = 333;
 
+	m_sVideoRenderers = "";	// default
 	m_bAllowUnacceleratedRenderer = false;
 	m_bThreadedInput = true;
 	m_bThreadedMovieDecode = true;
@@ -283,6 +285,7 @@ void PrefsManager::Init()
 	m_bLogToDisk = true;
 #endif
 	m_bForceLogFlush = false;
+	m_bLogDropOnOverflow = false;
 #ifdef DEBUG
 	m_bShowLogOutput = true;
 #else
@@ -442,6 +445,7 @@ void PrefsManager::ReadPrefsFromFile( const CString &sIni )
 	ini.GetValue( "Options", "FastLoad",						m_bFastLoad );
 	ini.GetValue( "Options", "MusicWheelUsesSections",			(int&)m_MusicWheelUsesSections );
 	ini.GetValue( "Options", "MusicWheelSwitchSpeed",			m_iMusicWheelSwitchSpeed );
+	ini.GetValue( "Options", "SoundDrivers",					m_sSoundDrivers );
 	ini.GetValue( "Options", "SoundWriteAhead",					m_iSoundWriteAhead );
 	ini.GetValue( "Options", "EasterEggs",						m_bEasterEggs );
 	ini.GetValue( "Options", "MarvelousTiming",					(int&)m_iMarvelousTiming );
@@ -457,6 +461,7 @@ void PrefsManager::ReadPrefsFromFile( const CString &sIni )
 	ini.GetValue( "Options", "LongVerSeconds",					m_fLongVerSongSeconds );
 	ini.GetValue( "Options", "MarathonVerSeconds",				m_fMarathonVerSongSeconds );
 	ini.GetValue( "Options", "ShowSongOptions",					(int&)m_ShowSongOptions );
+	ini.GetValue( "Options", "VideoRenderers",					m_sVideoRenderers );
 	ini.GetValue( "Options", "AllowUnacceleratedRenderer",		m_bAllowUnacceleratedRenderer );
 	ini.GetValue( "Options", "ThreadedInput",					m_bThreadedInput );
 	ini.GetValue( "Options", "ThreadedMovieDecode",				m_bThreadedMovieDecode );
@@ -528,6 +533,7 @@ void PrefsManager::ReadPrefsFromFile( const CString &sIni )
 
 	ini.GetValue( "Debug", "LogToDisk",							m_bLogToDisk );
 	ini.GetValue( "Debug", "ForceLogFlush",						m_bForceLogFlush );
+	ini.GetValue( "Debug", "LogDropOnOverflow",					m_bLogDropOnOverflow );
 	ini.GetValue( "Debug", "ShowLogOutput",						m_bShowLogOutput );
 	ini.GetValue( "Debug", "Timestamping",						m_bTimestamping );
 	ini.GetValue( "Debug", "LogSkips",							m_bLogSkips );
@@ -669,6 +675,7 @@ void PrefsManager::SaveGlobalPrefsToDisk() const
 	ini.SetValue( "Options", "LongVerSeconds",					m_fLongVerSongSeconds );
 	ini.SetValue( "Options", "MarathonVerSeconds",				m_fMarathonVerSongSeconds );
 	ini.SetValue( "Options", "ShowSongOptions",					m_ShowSongOptions );
+	ini.SetValue( "Options", "VideoRenderers",					m_sVideoRenderers );
 	ini.SetValue( "Options", "AllowUnacceleratedRenderer",		m_bAllowUnacceleratedRenderer );
 	ini.SetValue( "Options", "ThreadedInput",					m_bThreadedInput );
 	ini.SetValue( "Options", "ThreadedMovieDecode",				m_bThreadedMovieDecode );
@@ -731,6 +738,7 @@ void PrefsManager::SaveGlobalPrefsToDisk() const
 	ini.SetValue( "Options", "AnisotropicFiltering",			m_bAnisotropicFiltering );
 	ini.SetValue( "Options", "AutoRestart",						g_bAutoRestart );
 	
+	ini.SetValue( "Options", "SoundDrivers",					m_sSoundDrivers );
 	ini.SetValue( "Options", "SoundWriteAhead",					m_iSoundWriteAhead );
 
 	/* Only write these if they aren't the default.  This ensures that we can change
@@ -744,6 +752,7 @@ void PrefsManager::SaveGlobalPrefsToDisk() const
 
 	ini.SetValue( "Debug", "LogToDisk",							m_bLogToDisk );
 	ini.SetValue( "Debug", "ForceLogFlush",						m_bForceLogFlush );
+	ini.SetValue( "Debug", "LogDropOnOverflow",					m_bLogDropOnOverflow );
 	ini.SetValue( "Debug", "ShowLogOutput",						m_bShowLogOutput );
 	ini.SetValue( "Debug", "Timestamping",						m_bTimestamping );
 	ini.SetValue( "Debug", "LogSkips",							m_bLogSkips );
@@ -763,6 +772,20 @@ int PrefsManager::GetCoinMode()
 		return m_iCoinMode; 
 }
 
+CString PrefsManager::GetSoundDrivers()
+{
+	if( m_sSoundDrivers.empty() )
+		return DEFAULT_SOUND_DRIVER_LIST;
+	return m_sSoundDrivers;
+}
+
+CString PrefsManager::GetVideoRenderers()
+{
+	if( m_sVideoRenderers.empty() )
+		return DEFAULT_VIDEO_RENDERER_LIST;
+	return m_sVideoRenderers;
+}
+
 PrefsManager::Premium PrefsManager::GetPremium() 
 { 
 	if(m_bEventMode) 
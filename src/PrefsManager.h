@@ -227,6 +227,11 @@ public:
 private:
 	CString			m_sSoundDrivers;
 public:
+	CString			GetSoundDrivers();
+private:
+	CString			m_sVideoRenderers;
+public:
+	CString			GetVideoRenderers();
 	int				m_iSoundWriteAhead;
 	float			m_fSoundVolume;
 	bool			m_bAllowUnacceleratedRenderer;
@@ -242,6 +247,7 @@ public:
 	/* Debug: */
 	bool			m_bLogToDisk;
 	bool			m_bForceLogFlush;
+	bool			m_bLogDropOnOverflow;	// drop log lines instead of waiting when the log queue is full
 	bool			m_bShowLogOutput;
 	bool			m_bTimestamping;
 	bool			m_bLogSkips;
@@ -21,6 +21,9 @@
 #include "Foreach.h"
 #include "CatalogXml.h"
 #include "Bookkeeper.h"
+#include "SongUtil.h"
+#include "ProfileJournal.h"
+#include "Preference.h"
 
 //
 // Old file versions for backward compatibility
@@ -39,6 +42,10 @@
 	* 10 /* HighScores per Steps */		\
 	* 1024 /* size in bytes of a HighScores XNode */
 
+/* Once the journal grows past this, the next save rewrites Stats.xml and starts
+ * a new journal.  0 disables the journal; every save writes Stats.xml. */
+static Preference<int> PROFILE_JOURNAL_COMPACT_KB( Options, "ProfileJournalCompactKB", 256 );
+
 #if defined(WIN32)
 #pragma warning (disable : 4706) // assignment within conditional expression
 #endif
@@ -108,14 +115,21 @@ void Profile::InitGeneralData()
 	ZERO( m_iNumStagesPassedByGrade );
 }
 
+/* Wholesale changes can't be journaled; clearing m_sJournalDir makes the next
+ * save write all of Stats.xml. */
 void Profile::InitSongScores()
 {
 	m_SongHighScores.clear();
+	m_DirtyStepsScores.clear();
+	m_sJournalDir = "";
+	SongUtil::InvalidateAllGradeSortKeys();
 }
 
 void Profile::InitCourseScores()
 {
 	m_CourseHighScores.clear();
+	m_DirtyTrailScores.clear();
+	m_sJournalDir = "";
 }
 
 void Profile::InitCategoryScores()
@@ -123,26 +137,36 @@ void Profile::InitCategoryScores()
 	for( int st=0; st<NUM_STEPS_TYPES; st++ )
 		for( int rc=0; rc<NUM_RANKING_CATEGORIES; rc++ )
 			m_CategoryHighScores[st][rc].Init();
+	m_bDirtyCategoryScores = false;
+	m_sJournalDir = "";
 }
 
 void Profile::InitScreenshotData()
 {
 	m_vScreenshots.clear();
+	m_iJournaledScreenshots = 0;
+	m_sJournalDir = "";
 }
 
 void Profile::InitCalorieData()
 {
 	m_mapDayToCaloriesBurned.clear();
+	m_bDirtyCalorieData = false;
+	m_sJournalDir = "";
 }
 
 void Profile::InitRecentSongScores()
 {
 	m_vRecentStepsScores.clear();
+	m_iJournaledRecentSongScores = 0;
+	m_sJournalDir = "";
 }
 
 void Profile::InitRecentCourseScores()
 {
 	m_vRecentCourseScores.clear();
+	m_iJournaledRecentCourseScores = 0;
+	m_sJournalDir = "";
 }
 
 CString Profile::GetDisplayName() const
@@ -396,9 +420,20 @@ int Profile::GetSongNumTimesPlayed( const SongID& songID ) const
 //
 // Steps high scores
 //
+static pair<SongID,StepsID> GetStepsScoresKey( const Song* pSong, const Steps* pSteps )
+{
+	pair<SongID,StepsID> key;
+	key.first.FromSong( pSong );
+	key.second.FromSteps( pSteps );
+	return key;
+}
+
 void Profile::AddStepsHighScore( const Song* pSong, const Steps* pSteps, HighScore hs, int &iIndexOut )
 {
 	GetStepsHighScoreList(pSong,pSteps).AddHighScore( hs, iIndexOut, IsMachine() );
+	m_DirtyStepsScores.insert( GetStepsScoresKey(pSong,pSteps) );
+	if( IsMachine() )
+		SongUtil::InvalidateGradeSortKeys( pSong );
 }
 
 const HighScoreList& Profile::GetStepsHighScoreList( const Song* pSong, const Steps* pSteps ) const
@@ -428,6 +463,7 @@ int Profile::GetStepsNumTimesPlayed( const Song* pSong, const Steps* pSteps ) co
 void Profile::IncrementStepsPlayCount( const Song* pSong, const Steps* pSteps )
 {
 	GetStepsHighScoreList(pSong,pSteps).iNumTimesPlayed++;
+	m_DirtyStepsScores.insert( GetStepsScoresKey(pSong,pSteps) );
 }
 
 void Profile::GetGrades( const Song* pSong, StepsType st, int iCounts[NUM_GRADES] ) const
@@ -460,9 +496,18 @@ void Profile::GetGrades( const Song* pSong, StepsType st, int iCounts[NUM_GRADES
 //
 // Course high scores
 //
+static pair<CourseID,TrailID> GetTrailScoresKey( const Course* pCourse, const Trail* pTrail )
+{
+	pair<CourseID,TrailID> key;
+	key.first.FromCourse( pCourse );
+	key.second.FromTrail( pTrail );
+	return key;
+}
+
 void Profile::AddCourseHighScore( const Course* pCourse, const Trail* pTrail, HighScore hs, int &iIndexOut )
 {
 	GetCourseHighScoreList(pCourse,pTrail).AddHighScore( hs, iIndexOut, IsMachine() );
+	m_DirtyTrailScores.insert( GetTrailScoresKey(pCourse,pTrail) );
 }
 
 const HighScoreList& Profile::GetCourseHighScoreList( const Course* pCourse, const Trail* pTrail ) const
@@ -513,6 +558,7 @@ int Profile::GetCourseNumTimesPlayed( const CourseID &courseID ) const
 void Profile::IncrementCoursePlayCount( const Course* pCourse, const Trail* pTrail )
 {
 	GetCourseHighScoreList(pCourse,pTrail).iNumTimesPlayed++;
+	m_DirtyTrailScores.insert( GetTrailScoresKey(pCourse,pTrail) );
 }
 
 //
@@ -521,6 +567,7 @@ void Profile::IncrementCoursePlayCount( const Course* pCourse, const Trail* pTra
 void Profile::AddCategoryHighScore( StepsType st, RankingCategory rc, HighScore hs, int &iIndexOut )
 {
 	m_CategoryHighScores[st][rc].AddHighScore( hs, iIndexOut, IsMachine() );
+	m_bDirtyCategoryScores = true;
 }
 
 const HighScoreList& Profile::GetCategoryHighScoreList( StepsType st, RankingCategory rc ) const
@@ -544,6 +591,7 @@ int Profile::GetCategoryNumTimesPlayed( StepsType st ) const
 void Profile::IncrementCategoryPlayCount( StepsType st, RankingCategory rc )
 {
 	m_CategoryHighScores[st][rc].iNumTimesPlayed++;
+	m_bDirtyCategoryScores = true;
 }
 
 
@@ -578,6 +626,7 @@ bool Profile::LoadAllFromDir( CString sDir )
 	LoadEditableDataFromDir( sDir );
 	
 	// Read stats.xml
+	int iGeneration = 0;
 	FOR_ONCE
 	{
 		CString fn = sDir + STATS_XML;
@@ -622,11 +671,111 @@ bool Profile::LoadAllFromDir( CString sDir )
 		LOAD_NODE( CalorieData );
 		LOAD_NODE( RecentSongScores );
 		LOAD_NODE( RecentCourseScores );
+
+		xml.GetAttrValue( "JournalGeneration", iGeneration );
 	}
+
+	// Stats.xml files written without a journal have no generation.
+	if( iGeneration > 0 )
+		LoadJournalFromDir( sDir, iGeneration );
 		
 	return true;	// FIXME?  Investigate what happens if we always return true.
 }
 
+void Profile::LoadJournalFromDir( CString sDir, int iGeneration )
+{
+	CString fn = sDir + STATS_JOURNAL;
+
+	if( !IsMachine() && FILEMAN->GetFileSizeInBytes(fn) > MAX_PLAYER_STATS_XML_SIZE_BYTES )
+	{
+		LOG->Warn( "The file '%s' is unreasonably large.  It won't be loaded.", fn.c_str() );
+		return;
+	}
+
+	// A missing journal, or one left over from an older Stats.xml, is ignored;
+	// the next save will write Stats.xml and start a new one.
+	vector<XNode*> vRecords;
+	bool bTorn;
+	if( !ProfileJournal::Read(fn, iGeneration, vRecords, bTorn) )
+		return;
+
+	LOG->Trace( "Replaying %u records from %s", unsigned(vRecords.size()), fn.c_str() );
+
+	// Score lists are collected and loaded like the Stats.xml sections; later
+	// records for the same list replace earlier ones.
+	XNode SongScores;
+	SongScores.name = "SongScores";
+	XNode CourseScores;
+	CourseScores.name = "CourseScores";
+
+	for( unsigned i=0; i<vRecords.size(); i++ )
+	{
+		XNode *pRecord = vRecords[i];
+		if( pRecord->name == "Song" )
+		{
+			SongScores.AppendChild( pRecord );
+			continue;
+		}
+		if( pRecord->name == "Course" )
+		{
+			CourseScores.AppendChild( pRecord );
+			continue;
+		}
+
+		if( pRecord->name == "GeneralData" )
+		{
+			InitGeneralData();
+			LoadGeneralDataFromNode( pRecord );
+		}
+		else if( pRecord->name == "CategoryScores" )
+		{
+			InitCategoryScores();
+			LoadCategoryScoresFromNode( pRecord );
+		}
+		else if( pRecord->name == "CalorieData" )
+		{
+			InitCalorieData();
+			LoadCalorieDataFromNode( pRecord );
+		}
+		else if( pRecord->name == "Screenshot" )
+		{
+			Screenshot ss;
+			ss.LoadFromNode( pRecord );
+			m_vScreenshots.push_back( ss );
+		}
+		else if( pRecord->name == "HighScoreForASongAndSteps" )
+		{
+			HighScoreForASongAndSteps h;
+			h.LoadFromNode( pRecord );
+			m_vRecentStepsScores.push_back( h );
+		}
+		else if( pRecord->name == "HighScoreForACourseAndTrail" )
+		{
+			HighScoreForACourseAndTrail h;
+			h.LoadFromNode( pRecord );
+			m_vRecentCourseScores.push_back( h );
+		}
+		else
+			WARN_M( pRecord->name );
+
+		delete pRecord;
+	}
+
+	if( !SongScores.childs.empty() )
+		LoadSongScoresFromNode( &SongScores );
+	if( !CourseScores.childs.empty() )
+		LoadCourseScoresFromNode( &CourseScores );
+
+	// Don't append after a damaged record; it'd hide everything we write.
+	if( bTorn )
+		return;
+
+	m_sJournalDir = sDir;
+	m_iJournalGeneration = iGeneration;
+	m_iJournalBytes = FILEMAN->GetFileSizeInBytes( fn );
+	ClearJournalDirtyState();
+}
+
 bool Profile::SaveAllToDir( CString sDir ) const
 {
 	m_sLastPlayedMachineGuid = PROFILEMAN->GetMachineProfile()->m_sGuid;
@@ -635,11 +784,33 @@ bool Profile::SaveAllToDir( CString sDir ) const
 	// Save editable.xml
 	SaveEditableDataToDir( sDir );
 
+	// Append just what changed to the journal if it belongs to this dir and
+	// isn't due for compaction; otherwise write all of stats.xml.  The stats
+	// web page (stats.xml viewed through the stylesheets, and the catalog) is
+	// only brought up to date by a full write, so it lags behind while
+	// changes are being journaled.
+	const bool bUseJournal = 
+		PROFILE_JOURNAL_COMPACT_KB > 0 &&
+		m_sJournalDir == sDir &&
+		m_iJournalBytes <= PROFILE_JOURNAL_COMPACT_KB*1024;
+	if( bUseJournal && AppendJournalToDir(sDir) )
+		return true;
+
+	return SaveStatsXmlToDir( sDir );
+}
+
+bool Profile::SaveStatsXmlToDir( CString sDir ) const
+{
 	// Save stats.xml
 	CString fn = sDir + STATS_XML;
 
+	// Tag stats.xml with a new generation, so any existing journal no longer
+	// applies to it.
+	const int iGeneration = m_iJournalGeneration + 1;
+
 	XNode xml;
 	xml.name = "Stats";
+	xml.AppendAttr( "JournalGeneration", ssprintf("%i",iGeneration) );
 	xml.AppendChild( SaveGeneralDataCreateNode() );
 	xml.AppendChild( SaveSongScoresCreateNode() );
 	xml.AppendChild( SaveCourseScoresCreateNode() );
@@ -655,6 +826,25 @@ bool Profile::SaveAllToDir( CString sDir ) const
 	opts.stylesheet = STATS_XSL;
 	opts.write_tabs = false;
 	bool bSaved = xml.SaveToFile(fn, &opts);
+
+	if( bSaved )
+	{
+		m_iJournalGeneration = iGeneration;
+		m_sJournalDir = "";
+
+		CString sJournal = sDir + STATS_JOURNAL;
+		if( PROFILE_JOURNAL_COMPACT_KB > 0 && ProfileJournal::Reset(sJournal, iGeneration) )
+		{
+			m_sJournalDir = sDir;
+			m_iJournalBytes = 0;
+		}
+		else if( IsAFile(sJournal) )
+		{
+			FILEMAN->Remove( sJournal );
+		}
+
+		ClearJournalDirtyState();
+	}
 	
 	// Update file cache, or else IsAFile in CryptManager won't see this new file.
 	FILEMAN->FlushDirCache( sDir );
@@ -668,6 +858,119 @@ bool Profile::SaveAllToDir( CString sDir ) const
 	return bSaved;
 }
 
+static bool HasRankingToFillIn( const HighScoreList &hsl )
+{
+	for( unsigned i=0; i<hsl.vHighScores.size(); i++ )
+		if( IsRankingToFillIn(hsl.vHighScores[i].sName) )
+			return true;
+	return false;
+}
+
+bool Profile::AppendJournalToDir( CString sDir ) const
+{
+	vector<XNode*> vNodes;
+
+	for( set< pair<SongID,StepsID> >::const_iterator it = m_DirtyStepsScores.begin(); it != m_DirtyStepsScores.end(); ++it )
+	{
+		const HighScoresForASong *hsSong = GetHighScoresForASong( it->first );
+		if( hsSong == NULL )
+			continue;
+		std::map<StepsID,HighScoresForASteps>::const_iterator j = hsSong->m_StepsHighScores.find( it->second );
+		if( j == hsSong->m_StepsHighScores.end() )
+			continue;
+
+		// Same shape as one Song in SongScores, holding only the changed Steps.
+		XNode* pSongNode = it->first.CreateNode();
+		XNode* pStepsNode = pSongNode->AppendChild( it->second.CreateNode() );
+		pStepsNode->AppendChild( j->second.hs.CreateNode() );
+		vNodes.push_back( pSongNode );
+	}
+
+	for( set< pair<CourseID,TrailID> >::const_iterator it = m_DirtyTrailScores.begin(); it != m_DirtyTrailScores.end(); ++it )
+	{
+		const HighScoresForACourse *hsCourse = GetHighScoresForACourse( it->first );
+		if( hsCourse == NULL )
+			continue;
+		std::map<TrailID,HighScoresForATrail>::const_iterator j = hsCourse->m_TrailHighScores.find( it->second );
+		if( j == hsCourse->m_TrailHighScores.end() )
+			continue;
+
+		XNode* pCourseNode = it->first.CreateNode();
+		XNode* pTrailNode = pCourseNode->AppendChild( it->second.CreateNode() );
+		pTrailNode->AppendChild( j->second.hs.CreateNode() );
+		vNodes.push_back( pCourseNode );
+	}
+
+	// General data is changed directly through public members, so always save it.
+	vNodes.push_back( SaveGeneralDataCreateNode() );
+	if( m_bDirtyCategoryScores )
+		vNodes.push_back( SaveCategoryScoresCreateNode() );
+	if( m_bDirtyCalorieData )
+		vNodes.push_back( SaveCalorieDataCreateNode() );
+
+	for( unsigned i=m_iJournaledScreenshots; i<m_vScreenshots.size(); i++ )
+		vNodes.push_back( m_vScreenshots[i].CreateNode() );
+	const unsigned uNumRecentSongScores = min( m_vRecentStepsScores.size(), (unsigned)MAX_RECENT_SCORES_TO_SAVE );
+	for( unsigned i=m_iJournaledRecentSongScores; i<uNumRecentSongScores; i++ )
+		vNodes.push_back( m_vRecentStepsScores[i].CreateNode() );
+	const unsigned uNumRecentCourseScores = min( m_vRecentCourseScores.size(), (unsigned)MAX_RECENT_SCORES_TO_SAVE );
+	for( unsigned i=m_iJournaledRecentCourseScores; i<uNumRecentCourseScores; i++ )
+		vNodes.push_back( m_vRecentCourseScores[i].CreateNode() );
+
+	vector<const XNode*> vRecords( vNodes.begin(), vNodes.end() );
+	int iBytes;
+	bool bSaved = ProfileJournal::Append( sDir + STATS_JOURNAL, vRecords, iBytes );
+	for( unsigned i=0; i<vNodes.size(); i++ )
+		delete vNodes[i];
+
+	if( !bSaved )
+		return false;
+
+	m_iJournalBytes += iBytes;
+	ClearJournalDirtyState();
+	return true;
+}
+
+/* Everything has been saved.  Lists holding a ranking name that hasn't been
+ * entered yet stay dirty, so the name is saved once it's filled in. */
+void Profile::ClearJournalDirtyState() const
+{
+	for( set< pair<SongID,StepsID> >::iterator it = m_DirtyStepsScores.begin(); it != m_DirtyStepsScores.end(); )
+	{
+		const HighScoresForASong *hsSong = GetHighScoresForASong( it->first );
+		std::map<StepsID,HighScoresForASteps>::const_iterator j;
+		if( hsSong != NULL &&
+			(j = hsSong->m_StepsHighScores.find(it->second)) != hsSong->m_StepsHighScores.end() &&
+			HasRankingToFillIn(j->second.hs) )
+			++it;
+		else
+			m_DirtyStepsScores.erase( it++ );
+	}
+
+	for( set< pair<CourseID,TrailID> >::iterator it = m_DirtyTrailScores.begin(); it != m_DirtyTrailScores.end(); )
+	{
+		const HighScoresForACourse *hsCourse = GetHighScoresForACourse( it->first );
+		std::map<TrailID,HighScoresForATrail>::const_iterator j;
+		if( hsCourse != NULL &&
+			(j = hsCourse->m_TrailHighScores.find(it->second)) != hsCourse->m_TrailHighScores.end() &&
+			HasRankingToFillIn(j->second.hs) )
+			++it;
+		else
+			m_DirtyTrailScores.erase( it++ );
+	}
+
+	m_bDirtyCategoryScores = false;
+	for( int st=0; st<NUM_STEPS_TYPES; st++ )
+		for( int rc=0; rc<NUM_RANKING_CATEGORIES; rc++ )
+			if( HasRankingToFillIn(m_CategoryHighScores[st][rc]) )
+				m_bDirtyCategoryScores = true;
+
+	m_bDirtyCalorieData = false;
+	m_iJournaledScreenshots = m_vScreenshots.size();
+	m_iJournaledRecentSongScores = min( m_vRecentStepsScores.size(), (unsigned)MAX_RECENT_SCORES_TO_SAVE );
+	m_iJournaledRecentCourseScores = min( m_vRecentCourseScores.size(), (unsigned)MAX_RECENT_SCORES_TO_SAVE );
+}
+
 void Profile::SaveEditableDataToDir( CString sDir ) const
 {
 	IniFile ini;
@@ -951,6 +1254,7 @@ void Profile::AddStepTotals( int iTotalTapsAndHolds, int iTotalJumps, int iTotal
 
 		DateTime date = DateTime::GetNowDate();
 		m_mapDayToCaloriesBurned[date] += fCals;
+		m_bDirtyCalorieData = true;
 	}
 }
 
@@ -1004,6 +1308,7 @@ void Profile::LoadSongScoresFromNode( const XNode* pNode )
 	CHECKPOINT;
 
 	ASSERT( pNode->name == "SongScores" );
+	SongUtil::InvalidateAllGradeSortKeys();
 
 	FOREACH_CONST( XNode*, pNode->childs, song )
 	{
@@ -22,6 +22,9 @@ struct XNode;
 //
 #define STATS_XML "Stats.xml"
 
+// Changes made since Stats.xml was last written; see ProfileJournal.
+#define STATS_JOURNAL "Stats.journal"
+
 #define EDITABLE_INI "Editable.ini"
 // Editable data is an INI because the default INI file association on Windows 
 // systems will open the ini file in an editor.  The default association for 
@@ -42,6 +45,8 @@ class Profile
 public:
 	Profile()
 	{
+		m_iJournalGeneration = 0;
+		m_iJournalBytes = 0;
 		InitAll();
 	}
 
@@ -252,6 +257,8 @@ public:
 	//
 	bool LoadAllFromDir( CString sDir );	// return false on error
 	bool SaveAllToDir( CString sDir ) const;
+	bool SaveStatsXmlToDir( CString sDir ) const;
+	bool AppendJournalToDir( CString sDir ) const;
 
 	void LoadEditableDataFromDir( CString sDir );
 	void LoadGeneralDataFromNode( const XNode* pNode );
@@ -281,6 +288,24 @@ public:
 private:
 	const HighScoresForASong *GetHighScoresForASong( const SongID& songID ) const;
 	const HighScoresForACourse *GetHighScoresForACourse( const CourseID& courseID ) const;
+
+	void LoadJournalFromDir( CString sDir, int iGeneration );
+	void ClearJournalDirtyState() const;
+
+	//
+	// Journal state.  Everything changed since the last save is recorded here,
+	// so a save only has to append those changes to the journal.
+	//
+	mutable set< pair<SongID,StepsID> > m_DirtyStepsScores;
+	mutable set< pair<CourseID,TrailID> > m_DirtyTrailScores;
+	mutable bool m_bDirtyCategoryScores;
+	mutable bool m_bDirtyCalorieData;
+	mutable unsigned m_iJournaledScreenshots;
+	mutable unsigned m_iJournaledRecentSongScores;
+	mutable unsigned m_iJournaledRecentCourseScores;
+	mutable CString m_sJournalDir;	// dir whose Stats.xml and journal match us; empty forces a full save
+	mutable int m_iJournalGeneration;
+	mutable int m_iJournalBytes;
 };
 
 
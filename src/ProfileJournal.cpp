@@ -0,0 +1,250 @@
+#include "global.h"
+#include "ProfileJournal.h"
+#include "XmlFile.h"
+#include "RageFile.h"
+#include "RageUtil.h"
+#include "RageLog.h"
+
+/*
+ * File layout (all integers little-endian):
+ *
+ *   header:  magic, version, generation                  (3 x uint32)
+ *   record:  payload length, CRC32 of payload (2 x uint32), payload
+ *
+ * A payload is one node: name, value, attributes, then children, with every
+ * string and count stored as a 7-bit variable-length integer.  A record whose
+ * length or CRC doesn't match ends the journal; that's what a crash in the
+ * middle of an append leaves behind.
+ */
+static const unsigned JOURNAL_MAGIC = 0x4A504D53;	/* "SMPJ" */
+static const unsigned JOURNAL_VERSION = 1;
+static const int HEADER_SIZE = 12;
+static const int RECORD_HEADER_SIZE = 8;
+static const int MAX_NODE_DEPTH = 32;
+
+static void PutUint32( CString &sOut, unsigned i )
+{
+	sOut += char( i & 0xFF );
+	sOut += char( (i >> 8) & 0xFF );
+	sOut += char( (i >> 16) & 0xFF );
+	sOut += char( (i >> 24) & 0xFF );
+}
+
+static unsigned GetUint32( const char *p )
+{
+	const unsigned char *u = (const unsigned char *) p;
+	return u[0] | (u[1] << 8) | (u[2] << 16) | (u[3] << 24);
+}
+
+static void PutVarint( CString &sOut, unsigned i )
+{
+	while( i >= 0x80 )
+	{
+		sOut += char( (i & 0x7F) | 0x80 );
+		i >>= 7;
+	}
+	sOut += char( i );
+}
+
+static void PutString( CString &sOut, const CString &s )
+{
+	PutVarint( sOut, s.size() );
+	sOut.append( s.data(), s.size() );
+}
+
+static void PutNode( CString &sOut, const XNode *pNode )
+{
+	PutString( sOut, pNode->name );
+	PutString( sOut, pNode->value );
+
+	PutVarint( sOut, pNode->attrs.size() );
+	for( unsigned i = 0; i < pNode->attrs.size(); ++i )
+	{
+		PutString( sOut, pNode->attrs[i]->name );
+		PutString( sOut, pNode->attrs[i]->value );
+	}
+
+	PutVarint( sOut, pNode->childs.size() );
+	for( unsigned i = 0; i < pNode->childs.size(); ++i )
+		PutNode( sOut, pNode->childs[i] );
+}
+
+/* Decoding; every Get* returns false if it would run past pEnd. */
+static bool GetVarint( const char *&p, const char *pEnd, unsigned &iOut )
+{
+	iOut = 0;
+	for( int iShift = 0; iShift < 32; iShift += 7 )
+	{
+		if( p == pEnd )
+			return false;
+		const unsigned char c = *p++;
+		iOut |= (c & 0x7F) << iShift;
+		if( !(c & 0x80) )
+			return true;
+	}
+	return false;
+}
+
+static bool GetString( const char *&p, const char *pEnd, CString &sOut )
+{
+	unsigned iSize;
+	if( !GetVarint(p, pEnd, iSize) || iSize > unsigned(pEnd - p) )
+		return false;
+	sOut.assign( p, iSize );
+	p += iSize;
+	return true;
+}
+
+static bool GetNode( const char *&p, const char *pEnd, XNode *pNode, int iDepth )
+{
+	if( iDepth > MAX_NODE_DEPTH )
+		return false;
+	if( !GetString(p, pEnd, pNode->name) || !GetString(p, pEnd, pNode->value) )
+		return false;
+
+	unsigned iCount;
+	if( !GetVarint(p, pEnd, iCount) )
+		return false;
+	for( unsigned i = 0; i < iCount; ++i )
+	{
+		CString sName, sValue;
+		if( !GetString(p, pEnd, sName) || !GetString(p, pEnd, sValue) )
+			return false;
+		pNode->AppendAttr( sName.c_str(), sValue.c_str() );
+	}
+
+	if( !GetVarint(p, pEnd, iCount) )
+		return false;
+	for( unsigned i = 0; i < iCount; ++i )
+	{
+		XNode *pChild = pNode->AppendChild( new XNode );
+		if( !GetNode(p, pEnd, pChild, iDepth+1) )
+			return false;
+	}
+
+	return true;
+}
+
+bool ProfileJournal::Reset( const CString &sPath, int iGeneration )
+{
+	CString sHeader;
+	PutUint32( sHeader, JOURNAL_MAGIC );
+	PutUint32( sHeader, JOURNAL_VERSION );
+	PutUint32( sHeader, iGeneration );
+
+	RageFile f;
+	if( !f.Open(sPath, RageFile::WRITE) )
+	{
+		LOG->Warn( "Couldn't open %s for writing: %s", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+
+	if( f.Write(sHeader) == -1 || f.Flush() == -1 )
+	{
+		LOG->Warn( "Error writing %s: %s", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+
+	return true;
+}
+
+bool ProfileJournal::Append( const CString &sPath, const vector<const XNode*> &vRecords, int &iBytesOut )
+{
+	iBytesOut = 0;
+
+	/* Build everything first, so the records go out in a single write. */
+	CString sOut, sPayload;
+	for( unsigned i = 0; i < vRecords.size(); ++i )
+	{
+		sPayload = "";
+		PutNode( sPayload, vRecords[i] );
+
+		PutUint32( sOut, sPayload.size() );
+		PutUint32( sOut, GetHashForString(sPayload) );
+		sOut += sPayload;
+	}
+
+	if( sOut.empty() )
+		return true;
+
+	RageFile f;
+	if( !f.Open(sPath, RageFile::WRITE|RageFile::APPEND) )
+	{
+		LOG->Warn( "Couldn't open %s for appending: %s", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+
+	if( f.Write(sOut) == -1 || f.Flush() == -1 )
+	{
+		LOG->Warn( "Error writing %s: %s", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+
+	iBytesOut = sOut.size();
+	return true;
+}
+
+bool ProfileJournal::Read( const CString &sPath, int iGeneration, vector<XNode*> &vRecordsOut, bool &bTornOut )
+{
+	bTornOut = false;
+
+	RageFile f;
+	if( !f.Open(sPath, RageFile::READ) )
+		return false;
+
+	CString sData;
+	if( f.Read(sData) == -1 )
+	{
+		LOG->Warn( "Error reading %s: %s", sPath.c_str(), f.GetError().c_str() );
+		return false;
+	}
+
+	if( (int) sData.size() < HEADER_SIZE )
+		return false;
+
+	const char *p = sData.data();
+	const char *pEnd = p + sData.size();
+	if( GetUint32(p) != JOURNAL_MAGIC || GetUint32(p+4) != JOURNAL_VERSION )
+	{
+		LOG->Warn( "%s isn't a profile journal; ignored", sPath.c_str() );
+		return false;
+	}
+	if( (int) GetUint32(p+8) != iGeneration )
+		return false;
+	p += HEADER_SIZE;
+
+	while( p != pEnd )
+	{
+		if( pEnd - p < RECORD_HEADER_SIZE )
+		{
+			bTornOut = true;
+			break;
+		}
+
+		const unsigned iSize = GetUint32( p );
+		const unsigned iCRC = GetUint32( p+4 );
+		p += RECORD_HEADER_SIZE;
+		if( iSize > unsigned(pEnd - p) || GetHashForString(CString(p, iSize)) != iCRC )
+		{
+			bTornOut = true;
+			break;
+		}
+
+		const char *pRecord = p;
+		p += iSize;
+
+		XNode *pNode = new XNode;
+		if( !GetNode(pRecord, p, pNode, 0) || pRecord != p )
+		{
+			delete pNode;
+			bTornOut = true;
+			break;
+		}
+		vRecordsOut.push_back( pNode );
+	}
+
+	if( bTornOut )
+		LOG->Warn( "%s is damaged after %u records; the rest was ignored", sPath.c_str(), unsigned(vRecordsOut.size()) );
+
+	return true;
+}
@@ -0,0 +1,29 @@
+/* ProfileJournal - Append-only binary log of profile changes made since Stats.xml was last written. */
+
+#ifndef PROFILE_JOURNAL_H
+#define PROFILE_JOURNAL_H
+
+struct XNode;
+
+/*
+ * Each record is one XNode tree, as created by the Profile's own CreateNode
+ * functions, stored in a compact binary form (no text escaping or parsing).
+ * The journal header carries a generation number; it's only valid on top of
+ * a Stats.xml that was written with the same generation.
+ */
+namespace ProfileJournal
+{
+	/* Replace the journal at sPath with an empty one for iGeneration. */
+	bool Reset( const CString &sPath, int iGeneration );
+
+	/* Append records to the journal.  iBytesOut is the number of bytes written. */
+	bool Append( const CString &sPath, const vector<const XNode*> &vRecords, int &iBytesOut );
+
+	/* Read every intact record from the journal.  Returns false if the journal
+	 * doesn't exist or belongs to a different generation.  bTornOut is set if
+	 * reading stopped at a damaged or partially-written record.  The caller owns
+	 * the returned nodes. */
+	bool Read( const CString &sPath, int iGeneration, vector<XNode*> &vRecordsOut, bool &bTornOut );
+}
+
+#endif
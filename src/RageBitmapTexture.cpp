@@ -9,6 +9,7 @@
 #include "arch/Dialog/Dialog.h"
 #include "RageSurface.h"
 #include "RageSurfaceUtils.h"
+#include "RageTextureCache.h"
 
 #include "SDL_rotozoom.h"
 #include "SDL_dither.h"
@@ -36,6 +37,7 @@ RageBitmapTexture::RageBitmapTexture( RageTextureID name ) :
 	RageTexture( name )
 {
 //	LOG->Trace( "RageBitmapTexture::RageBitmapTexture()" );
+	m_iTextureBytes = 0;
 	Create();
 }
 
@@ -64,10 +66,124 @@ void RageBitmapTexture::Create()
 {
 	RageTextureID actualID = GetID();
 
+	/* Use the converted image from the texture cache if it's there, and
+	 * otherwise decode and convert it, and cache the result. */
+	RageTextureCache::TextureInfo info;
+	RageSurface *img = RageTextureCache::Load( GetID(), info );
+	const bool bFromCache = img != NULL;
+	if( bFromCache )
+	{
+		m_iSourceWidth = info.iSourceWidth;
+		m_iSourceHeight = info.iSourceHeight;
+		m_iImageWidth = info.iImageWidth;
+		m_iImageHeight = info.iImageHeight;
+		m_iTextureWidth = info.iTextureWidth;
+		m_iTextureHeight = info.iTextureHeight;
+		actualID.iAlphaBits = info.iAlphaBits;
+		actualID.bStretch = !!info.bStretch;
+		actualID.bDither = !!info.bDither;
+		actualID.bMipMaps = !!info.bMipMaps;
+	}
+	else
+	{
+		bool bCacheable;
+		img = CreateImg( actualID, info.iPixelFormat, bCacheable );
+
+		if( bCacheable )
+		{
+			info.iSourceWidth = m_iSourceWidth;
+			info.iSourceHeight = m_iSourceHeight;
+			info.iImageWidth = m_iImageWidth;
+			info.iImageHeight = m_iImageHeight;
+			info.iTextureWidth = m_iTextureWidth;
+			info.iTextureHeight = m_iTextureHeight;
+			info.iAlphaBits = actualID.iAlphaBits;
+			info.bStretch = actualID.bStretch;
+			info.bDither = actualID.bDither;
+			info.bMipMaps = actualID.bMipMaps;
+			RageTextureCache::Save( GetID(), info, img );
+		}
+	}
+
+	const RageDisplay::PixelFormat pixfmt = (RageDisplay::PixelFormat) info.iPixelFormat;
+	m_uTexHandle = DISPLAY->CreateTexture( pixfmt, img, actualID.bMipMaps );
+
+	m_iTextureBytes = m_iTextureWidth * m_iTextureHeight * DISPLAY->GetPixelFormatDesc(pixfmt)->bpp / 8;
+	if( pixfmt == RageDisplay::FMT_PAL )
+		m_iTextureBytes += 256 * 4;
+	if( actualID.bMipMaps )
+		m_iTextureBytes += m_iTextureBytes / 3;
+
+	CreateFrameRects();
+
+
+	//
+	// Enforce frames in the image have even dimensions.  Otherwise, 
+	// pixel/texel alignment will be off.
+	//
+	bool bRunCheck = true;
+	
+	 // Don't check if the artist intentionally blanked the image by making it very tiny.
+	if( this->GetSourceWidth()<=2 || this->GetSourceHeight()<=2 )
+		 bRunCheck = false;
+	
+	// HACK: Don't check song graphics.  Many of them are weird dimensions.
+	if( !TEXTUREMAN->GetOddDimensionWarning() )
+		 bRunCheck = false;
+
+	if( bRunCheck  )
+	{
+		float fFrameWidth = this->GetSourceWidth() / (float)this->GetFramesWide();
+		float fFrameHeight = this->GetSourceHeight() / (float)this->GetFramesHigh();
+		float fBetterFrameWidth = roundf((fFrameWidth+0.99f)*0.5f)*2;
+		float fBetterFrameHeight = roundf((fFrameHeight+0.99f)*0.5f)*2;
+		float fBetterSourceWidth = this->GetFramesWide() * fBetterFrameWidth;
+		float fBetterSourceHeight = this->GetFramesHigh() * fBetterFrameHeight;
+		if( fFrameWidth!=fBetterFrameWidth || fFrameHeight!=fBetterFrameHeight )
+		{
+			CString sWarning = ssprintf(
+				"The graphic '%s' has frame dimensions that aren't even numbers.\n\n"
+				"The entire image is %dx%d and frame size is %.1fx%.1f.\n\n"
+				"Image quality will be much improved if you resize the graphic to %.0fx%.0f, which is a frame size of %.0fx%.0f.", 
+				actualID.filename.c_str(), 
+				this->GetSourceWidth(), this->GetSourceHeight(), 
+				fFrameWidth, fFrameHeight,
+				fBetterSourceWidth, fBetterSourceHeight,
+				fBetterFrameWidth, fBetterFrameHeight );
+			LOG->Warn( sWarning );
+			Dialog::OK( sWarning, "FRAME_DIMENSIONS_WARNING" );
+		}
+	}
+
+
+
+	delete img;
+
+	/* See if the apparent "size" is being overridden. */
+	GetResolutionFromFileName(actualID.filename, m_iSourceWidth, m_iSourceHeight);
+
+
+	CString props;
+	props += RageDisplay::PixelFormatToString( pixfmt ) + " ";
+	if(actualID.iAlphaBits == 0) props += "opaque ";
+	if(actualID.iAlphaBits == 1) props += "matte ";
+	if(actualID.bStretch) props += "stretch ";
+	if(actualID.bDither) props += "dither ";
+	if(bFromCache) props += "cached ";
+	props.erase(props.size()-1);
+	LOG->Trace( "RageBitmapTexture: Loaded '%s' (%ux%u); %s, source %d,%d;  image %d,%d.", 
+		actualID.filename.c_str(), GetTextureWidth(), GetTextureHeight(),
+		props.c_str(), m_iSourceWidth, m_iSourceHeight,
+		m_iImageWidth,	m_iImageHeight);
+}
+
+RageSurface *RageBitmapTexture::CreateImg( RageTextureID &actualID, int &iPixFmtOut, bool &bCacheableOut )
+{
 	/* Create (and return) a surface ready to be loaded to OpenGL */
 	/* Load the image into a RageSurface. */
 	CString error;
 	RageSurface *img = RageSurfaceUtils::LoadFile( actualID.filename, error );
+	bCacheableOut = true;
 
 	/* Tolerate corrupt/unknown images. */
 	if( img == NULL )
@@ -75,6 +191,7 @@ void RageBitmapTexture::Create()
 		LOG->Warn( "RageBitmapTexture: Couldn't load %s: %s", actualID.filename.c_str(), error.c_str() );
 		img = RageSurfaceUtils::MakeDummySurface( 64, 64 );
 		ASSERT( img != NULL );
+		bCacheableOut = false;
 	}
 
 	if( actualID.bHotPinkColorKey )
@@ -237,69 +354,9 @@ void RageBitmapTexture::Create()
 	const RageDisplay::PixelFormatDesc *pfd = DISPLAY->GetPixelFormatDesc(pixfmt);
 	RageSurfaceUtils::ConvertSurface( img, m_iTextureWidth, m_iTextureHeight,
 		pfd->bpp, pfd->masks[0], pfd->masks[1], pfd->masks[2], pfd->masks[3] );
-	
-	m_uTexHandle = DISPLAY->CreateTexture( pixfmt, img, actualID.bMipMaps );
-
-	CreateFrameRects();
-
-
-	//
-	// Enforce frames in the image have even dimensions.  Otherwise, 
-	// pixel/texel alignment will be off.
-	//
-	bool bRunCheck = true;
-	
-	 // Don't check if the artist intentionally blanked the image by making it very tiny.
-	if( this->GetSourceWidth()<=2 || this->GetSourceHeight()<=2 )
-		 bRunCheck = false;
-	
-	// HACK: Don't check song graphics.  Many of them are weird dimensions.
-	if( !TEXTUREMAN->GetOddDimensionWarning() )
-		 bRunCheck = false;
-
-	if( bRunCheck  )
-	{
-		float fFrameWidth = this->GetSourceWidth() / (float)this->GetFramesWide();
-		float fFrameHeight = this->GetSourceHeight() / (float)this->GetFramesHigh();
-		float fBetterFrameWidth = roundf((fFrameWidth+0.99f)*0.5f)*2;
-		float fBetterFrameHeight = roundf((fFrameHeight+0.99f)*0.5f)*2;
-		float fBetterSourceWidth = this->GetFramesWide() * fBetterFrameWidth;
-		float fBetterSourceHeight = this->GetFramesHigh() * fBetterFrameHeight;
-		if( fFrameWidth!=fBetterFrameWidth || fFrameHeight!=fBetterFrameHeight )
-		{
-			CString sWarning = ssprintf(
-				"The graphic '%s' has frame dimensions that aren't even numbers.\n\n"
-				"The entire image is %dx%d and frame size is %.1fx%.1f.\n\n"
-				"Image quality will be much improved if you resize the graphic to %.0fx%.0f, which is a frame size of %.0fx%.0f.", 
-				actualID.filename.c_str(), 
-				this->GetSourceWidth(), this->GetSourceHeight(), 
-				fFrameWidth, fFrameHeight,
-				fBetterSourceWidth, fBetterSourceHeight,
-				fBetterFrameWidth, fBetterFrameHeight );
-			LOG->Warn( sWarning );
-			Dialog::OK( sWarning, "FRAME_DIMENSIONS_WARNING" );
-		}
-	}
-
-
 
-	delete img;
-
-	/* See if the apparent "size" is being overridden. */
-	GetResolutionFromFileName(actualID.filename, m_iSourceWidth, m_iSourceHeight);
-
-
-	CString props;
-	props += RageDisplay::PixelFormatToString( pixfmt ) + " ";
-	if(actualID.iAlphaBits == 0) props += "opaque ";
-	if(actualID.iAlphaBits == 1) props += "matte ";
-	if(actualID.bStretch) props += "stretch ";
-	if(actualID.bDither) props += "dither ";
-	props.erase(props.size()-1);
-	LOG->Trace( "RageBitmapTexture: Loaded '%s' (%ux%u); %s, source %d,%d;  image %d,%d.", 
-		actualID.filename.c_str(), GetTextureWidth(), GetTextureHeight(),
-		props.c_str(), m_iSourceWidth, m_iSourceHeight,
-		m_iImageWidth,	m_iImageHeight);
+	iPixFmtOut = pixfmt;
+	return img;
 }
 
 void RageBitmapTexture::Destroy()
@@ -6,7 +6,7 @@
 #define RAGEBITMAPTEXTURE_H
 
 #include "RageTexture.h"
-struct SDL_Surface;
+struct RageSurface;
 
 class RageBitmapTexture : public RageTexture
 {
@@ -17,13 +17,16 @@ public:
 	virtual void Invalidate() { m_uTexHandle = 0; /* don't Destroy() */}
 	virtual void Reload();
 	virtual unsigned GetTexHandle() const { return m_uTexHandle; }	// accessed by RageDisplay
+	virtual int GetTextureBytes() const { return m_iTextureBytes; }
 
 private:
 	void Create();	// called by constructor and Reload
 	void Destroy();
 	unsigned m_uTexHandle;	// treat as unsigned in OpenGL, ID3D8Texture* for D3D
+	int m_iTextureBytes;
 
-	SDL_Surface *CreateImg(int &pixfmt);
+	/* Decode and convert the image; bCacheableOut is false if it couldn't be loaded. */
+	RageSurface *CreateImg( RageTextureID &actualID, int &iPixFmtOut, bool &bCacheableOut );
 };
 
 #endif
@@ -0,0 +1,360 @@
+#include "global.h"
+#include "RageDisplay.h"
+#include "RageDisplay_Null.h"
+#include "RageUtil.h"
+#include "RageLog.h"
+#include "RageMath.h"
+#include "RageTexture.h"
+#include "RageSurface.h"
+#include "Preference.h"
+
+/* Log every frame's counters.  This is a lot of output; it's meant for
+ * scripted runs, not for playing. */
+static Preference<bool> LOG_DISPLAY_STATS( Debug, "LogDisplayStats", false );
+
+static const RageDisplay::PixelFormatDesc PIXEL_FORMAT_DESC[RageDisplay::NUM_PIX_FORMATS] = {
+	{
+		/* A8B8G8R8 */
+		32,
+		{ 0x000000FF,
+		  0x0000FF00,
+		  0x00FF0000,
+		  0xFF000000 }
+	}, {
+		/* A4R4G4B4 */
+		16,
+		{ 0x000F,
+		  0x00F0,
+		  0x0F00,
+		  0xF000 },
+	}, {
+		/* A1B5G5R5 */
+		16,
+		{ 0x001F,
+		  0x03E0,
+		  0x7C00,
+		  0x8000 },
+	}, {
+		/* X1R5G5R5 */
+		16,
+		{ 0x001F,
+		  0x03E0,
+		  0x7C00,
+		  0x0000 },
+	}, {
+		/* B8G8R8 */
+		24,
+		{ 0x0000FF,
+		  0x00FF00,
+		  0xFF0000,
+		  0x000000 }
+	}, {
+		/* Paletted */
+		8,
+		{ 0,0,0,0 } /* N/A */
+	}, {
+		/* BGR (N/A; OpenGL only) */
+		0, { 0,0,0,0 }
+	}, {
+		/* ABGR (N/A; OpenGL only) */
+		0, { 0,0,0,0 }
+	}
+};
+
+void RageDisplayNullStats::Reset()
+{
+	iDrawCalls = iVertices = 0;
+	iTextureBinds = iTextureUploads = iMatrixUploads = 0;
+	iBlendChanges = iCullChanges = iZChanges = iOtherStateChanges = 0;
+	iRedundantStateSets = 0;
+}
+
+void RageDisplayNullStats::Add( const RageDisplayNullStats &other )
+{
+	iDrawCalls += other.iDrawCalls;
+	iVertices += other.iVertices;
+	iTextureBinds += other.iTextureBinds;
+	iTextureUploads += other.iTextureUploads;
+	iMatrixUploads += other.iMatrixUploads;
+	iBlendChanges += other.iBlendChanges;
+	iCullChanges += other.iCullChanges;
+	iZChanges += other.iZChanges;
+	iOtherStateChanges += other.iOtherStateChanges;
+	iRedundantStateSets += other.iRedundantStateSets;
+}
+
+void RageDisplayNullStats::Divide( int iFrames )
+{
+	if( iFrames == 0 )
+		return;
+
+	iDrawCalls /= iFrames;
+	iVertices /= iFrames;
+	iTextureBinds /= iFrames;
+	iTextureUploads /= iFrames;
+	iMatrixUploads /= iFrames;
+	iBlendChanges /= iFrames;
+	iCullChanges /= iFrames;
+	iZChanges /= iFrames;
+	iOtherStateChanges /= iFrames;
+	iRedundantStateSets /= iFrames;
+}
+
+CString RageDisplayNullStats::ToString() const
+{
+	return ssprintf( "draws %d, verts %d, binds %d, uploads %d, matrices %d, blend %d, cull %d, z %d, other %d, redundant %d",
+		iDrawCalls, iVertices, iTextureBinds, iTextureUploads, iMatrixUploads,
+		iBlendChanges, iCullChanges, iZChanges, iOtherStateChanges, iRedundantStateSets );
+}
+
+/* Record a state set: count it as a change if it changed, and as redundant
+ * if it didn't. */
+template<class T>
+static void SetState( T &current, const T &value, int &iChanges, RageDisplayNullStats &stats )
+{
+	if( current == value )
+	{
+		++stats.iRedundantStateSets;
+		return;
+	}
+
+	current = value;
+	++iChanges;
+}
+
+RageDisplay_Null::RageDisplay_Null( VideoModeParams p )
+{
+	LOG->Trace( "RageDisplay_Null::RageDisplay_Null()" );
+	LOG->MapLog( "renderer", "Current renderer: null" );
+
+	m_BlendMode = BLEND_NORMAL;
+	m_CullMode = CULL_NONE;
+	m_ZTestMode = ZTEST_OFF;
+	m_bZWrite = false;
+	m_bAlphaTest = true;
+	m_bLighting = false;
+	m_bTextureWrapping = false;
+	m_TextureMode = TEXMODE_MODULATE;
+	m_uBoundTexture = 0;
+	m_uNextTexHandle = 1;
+	m_iFramesSinceLastCheck = 0;
+
+	SetVideoMode( p );
+}
+
+RageDisplay_Null::~RageDisplay_Null()
+{
+	LOG->Trace( "RageDisplay_Null::~RageDisplay()" );
+}
+
+CString RageDisplay_Null::TryVideoMode( VideoModeParams p, bool &bNewDeviceOut )
+{
+	m_Params = p;
+	bNewDeviceOut = false;
+
+	this->SetDefaultRenderStates();
+
+	return "";	// successfully set mode
+}
+
+const RageDisplay::PixelFormatDesc *RageDisplay_Null::GetPixelFormatDesc( PixelFormat pf ) const
+{
+	ASSERT( pf < NUM_PIX_FORMATS );
+	return &PIXEL_FORMAT_DESC[pf];
+}
+
+bool RageDisplay_Null::SupportsTextureFormat( PixelFormat pixfmt, bool realtime )
+{
+	return PIXEL_FORMAT_DESC[pixfmt].bpp != 0;
+}
+
+RageSurface* RageDisplay_Null::CreateScreenshot()
+{
+	const PixelFormatDesc &desc = PIXEL_FORMAT_DESC[FMT_RGBA8];
+	RageSurface *image = CreateSurface( m_Params.width, m_Params.height, desc.bpp,
+		desc.masks[0], desc.masks[1], desc.masks[2], 0 );
+	memset( image->pixels, 0, image->pitch * image->h );
+
+	return image;
+}
+
+bool RageDisplay_Null::BeginFrame()
+{
+	m_CurrentFrame.Reset();
+	return true;
+}
+
+void RageDisplay_Null::EndFrame()
+{
+	m_LastFrame = m_CurrentFrame;
+	if( LOG_DISPLAY_STATS )
+		LOG->Trace( "Frame: %s", m_LastFrame.ToString().c_str() );
+
+	m_SinceLastCheck.Add( m_CurrentFrame );
+	++m_iFramesSinceLastCheck;
+	if( m_LastCheckTimer.PeekDeltaTime() >= 1.0f )	// update averages every 1 sec.
+	{
+		m_LastCheckTimer.GetDeltaTime();
+		m_Average = m_SinceLastCheck;
+		m_Average.Divide( m_iFramesSinceLastCheck );
+		m_SinceLastCheck.Reset();
+		m_iFramesSinceLastCheck = 0;
+	}
+
+	m_CurrentFrame.Reset();
+	ProcessStatsOnFlip();
+}
+
+/* Do the matrix work a real display does before a draw: consume the dirty
+ * flags and build the combined view matrix. */
+void RageDisplay_Null::SendCurrentMatrices()
+{
+	if( UpdateProjectionMatrix() )
+		++m_CurrentFrame.iMatrixUploads;
+
+	if( (UpdateViewMatrix() | UpdateCenteringMatrix()) )
+	{
+		RageMatrix m;
+		RageMatrixMultiply( &m, GetCentering(), GetViewTop() );
+		++m_CurrentFrame.iMatrixUploads;
+	}
+
+	if( UpdateWorldMatrix() )
+		++m_CurrentFrame.iMatrixUploads;
+
+	if( UpdateTextureMatrix() )
+		++m_CurrentFrame.iMatrixUploads;
+}
+
+void RageDisplay_Null::CountDraw( int iNumVerts )
+{
+	SendCurrentMatrices();
+	++m_CurrentFrame.iDrawCalls;
+	m_CurrentFrame.iVertices += iNumVerts;
+}
+
+void RageDisplay_Null::DrawQuadsInternal( const RageSpriteVertex v[], int iNumVerts )		{ CountDraw( iNumVerts ); }
+void RageDisplay_Null::DrawQuadStripInternal( const RageSpriteVertex v[], int iNumVerts )	{ CountDraw( iNumVerts ); }
+void RageDisplay_Null::DrawFanInternal( const RageSpriteVertex v[], int iNumVerts )			{ CountDraw( iNumVerts ); }
+void RageDisplay_Null::DrawStripInternal( const RageSpriteVertex v[], int iNumVerts )		{ CountDraw( iNumVerts ); }
+void RageDisplay_Null::DrawTrianglesInternal( const RageSpriteVertex v[], int iNumVerts )	{ CountDraw( iNumVerts ); }
+
+class RageCompiledGeometryNull : public RageCompiledGeometry
+{
+public:
+	void Allocate( const vector<msMesh> &vMeshes ) {}
+	void Change( const vector<msMesh> &vMeshes ) {}
+	void Draw( int iMeshIndex ) const {}
+
+	int GetVertexCount( int iMeshIndex ) const { return m_vMeshInfo[iMeshIndex].iTriangleCount * 3; }
+};
+
+RageCompiledGeometry* RageDisplay_Null::CreateCompiledGeometry()
+{
+	return new RageCompiledGeometryNull;
+}
+
+void RageDisplay_Null::DeleteCompiledGeometry( RageCompiledGeometry* p )
+{
+	delete p;
+}
+
+void RageDisplay_Null::DrawCompiledGeometryInternal( const RageCompiledGeometry *p, int iMeshIndex )
+{
+	const RageCompiledGeometryNull *pGeom = (const RageCompiledGeometryNull *) p;
+	CountDraw( pGeom->GetVertexCount(iMeshIndex) );
+}
+
+unsigned RageDisplay_Null::CreateTexture(
+	PixelFormat pixfmt,
+	RageSurface* img,
+	bool bGenerateMipMaps )
+{
+	ASSERT( img->w == power_of_two(img->w) && img->h == power_of_two(img->h) );
+	++m_CurrentFrame.iTextureUploads;
+	return m_uNextTexHandle++;
+}
+
+void RageDisplay_Null::UpdateTexture(
+	unsigned uTexHandle,
+	RageSurface* img,
+	int width, int height )
+{
+	++m_CurrentFrame.iTextureUploads;
+}
+
+void RageDisplay_Null::DeleteTexture( unsigned uTexHandle )
+{
+	if( m_uBoundTexture == uTexHandle )
+		m_uBoundTexture = 0;
+}
+
+void RageDisplay_Null::ClearAllTextures()
+{
+	SetState( m_uBoundTexture, 0u, m_CurrentFrame.iTextureBinds, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetTexture( int iTextureUnitIndex, RageTexture* pTexture )
+{
+	const unsigned uHandle = pTexture? pTexture->GetTexHandle(): 0;
+	SetState( m_uBoundTexture, uHandle, m_CurrentFrame.iTextureBinds, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetTextureModeModulate()
+{
+	SetState( m_TextureMode, TEXMODE_MODULATE, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetTextureModeGlow( GlowMode m )
+{
+	SetState( m_TextureMode, TEXMODE_GLOW, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetTextureModeAdd()
+{
+	SetState( m_TextureMode, TEXMODE_ADD, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetTextureWrapping( bool b )
+{
+	SetState( m_bTextureWrapping, b, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetBlendMode( BlendMode mode )
+{
+	SetState( m_BlendMode, mode, m_CurrentFrame.iBlendChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetZWrite( bool b )
+{
+	SetState( m_bZWrite, b, m_CurrentFrame.iZChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetZTestMode( ZTestMode mode )
+{
+	SetState( m_ZTestMode, mode, m_CurrentFrame.iZChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetCullMode( CullMode mode )
+{
+	SetState( m_CullMode, mode, m_CurrentFrame.iCullChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetAlphaTest( bool b )
+{
+	SetState( m_bAlphaTest, b, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::SetLighting( bool b )
+{
+	SetState( m_bLighting, b, m_CurrentFrame.iOtherStateChanges, m_CurrentFrame );
+}
+
+void RageDisplay_Null::GetOrthoMatrix( RageMatrix* pOut, float l, float r, float b, float t, float zn, float zf )
+{
+	*pOut = RageMatrix(
+		2/(r-l),      0,            0,           0,
+		0,            2/(t-b),      0,           0,
+		0,            0,            -2/(zf-zn),   0,
+		-(r+l)/(r-l), -(t+b)/(t-b), -(zf+zn)/(zf-zn),  1 );
+}
@@ -0,0 +1,133 @@
+/* RageDisplay_Null: Headless display; accepts everything, draws nothing, and counts what it was asked to do. */
+
+#ifndef RAGEDISPLAY_NULL_H
+#define RAGEDISPLAY_NULL_H
+
+#include "RageTimer.h"
+
+/* Per-frame counters.  "Changes" count sets that changed the state; sets that
+ * didn't are counted only in iRedundantStateSets. */
+struct RageDisplayNullStats
+{
+	RageDisplayNullStats() { Reset(); }
+	void Reset();
+	void Add( const RageDisplayNullStats &other );
+	void Divide( int iFrames );
+	CString ToString() const;
+
+	int iDrawCalls;
+	int iVertices;
+	int iTextureBinds;
+	int iTextureUploads;
+	int iMatrixUploads;
+	int iBlendChanges;
+	int iCullChanges;
+	int iZChanges;
+	int iOtherStateChanges;	/* alpha test, lighting, texture mode, wrapping */
+	int iRedundantStateSets;
+};
+
+class RageDisplay_Null: public RageDisplay
+{
+public:
+	RageDisplay_Null( VideoModeParams params );
+	virtual ~RageDisplay_Null();
+
+	const PixelFormatDesc *GetPixelFormatDesc( PixelFormat pf ) const;
+
+	bool BeginFrame();
+	void EndFrame();
+	VideoModeParams GetVideoModeParams() const { return m_Params; }
+	void SetBlendMode( BlendMode mode );
+	bool SupportsTextureFormat( PixelFormat pixfmt, bool realtime=false );
+	unsigned CreateTexture(
+		PixelFormat pixfmt,
+		RageSurface* img,
+		bool bGenerateMipMaps );
+	void UpdateTexture(
+		unsigned uTexHandle,
+		RageSurface* img,
+		int width, int height
+		);
+	void DeleteTexture( unsigned uTexHandle );
+	void ClearAllTextures();
+	void SetTexture( int iTextureUnitIndex, RageTexture* pTexture );
+	void SetTextureModeModulate();
+	void SetTextureModeGlow( GlowMode m=GLOW_WHITEN );
+	void SetTextureModeAdd();
+	void SetTextureWrapping( bool b );
+	int GetMaxTextureSize() const { return 512; }
+	void SetTextureFiltering( bool b ) { }
+	bool IsZWriteEnabled() const { return m_bZWrite; }
+	bool IsZTestEnabled() const { return m_ZTestMode != ZTEST_OFF; }
+	void SetZWrite( bool b );
+	void SetZTestMode( ZTestMode mode );
+	void ClearZBuffer() { }
+	void SetCullMode( CullMode mode );
+	void SetAlphaTest( bool b );
+	void SetMaterial(
+		const RageColor &emissive,
+		const RageColor &ambient,
+		const RageColor &diffuse,
+		const RageColor &specular,
+		float shininess
+		) { }
+	void SetLighting( bool b );
+	void SetLightOff() { }
+	void SetLightDirectional(
+		const RageColor &ambient,
+		const RageColor &diffuse,
+		const RageColor &specular,
+		const RageVector3 &dir ) { }
+
+	void SetSphereEnironmentMapping( bool b ) { }
+
+	RageCompiledGeometry* CreateCompiledGeometry();
+	void DeleteCompiledGeometry( RageCompiledGeometry* p );
+
+	/* Counters for the frame in progress, the last complete frame, and the
+	 * per-frame average over the last second (updated like GetVPF). */
+	const RageDisplayNullStats &GetCurrentFrameStats() const { return m_CurrentFrame; }
+	const RageDisplayNullStats &GetLastFrameStats() const { return m_LastFrame; }
+	const RageDisplayNullStats &GetAverageFrameStats() const { return m_Average; }
+	int GetDrawCallsPerFrame() const { return m_Average.iDrawCalls; }
+
+protected:
+	void DrawQuadsInternal( const RageSpriteVertex v[], int iNumVerts );
+	void DrawQuadStripInternal( const RageSpriteVertex v[], int iNumVerts );
+	void DrawFanInternal( const RageSpriteVertex v[], int iNumVerts );
+	void DrawStripInternal( const RageSpriteVertex v[], int iNumVerts );
+	void DrawTrianglesInternal( const RageSpriteVertex v[], int iNumVerts );
+	void DrawCompiledGeometryInternal( const RageCompiledGeometry *p, int iMeshIndex );
+
+	CString TryVideoMode( VideoModeParams params, bool &bNewDeviceOut );
+	RageSurface* CreateScreenshot();
+	void SetViewport( int shift_left, int shift_down ) { }
+	void GetOrthoMatrix( RageMatrix *pOut, float l, float r, float b, float t, float zn, float zf );
+
+private:
+	void SendCurrentMatrices();
+	void CountDraw( int iNumVerts );
+
+	VideoModeParams m_Params;
+
+	/* Current state, to tell changes from redundant sets. */
+	enum TextureMode { TEXMODE_MODULATE, TEXMODE_GLOW, TEXMODE_ADD };
+	BlendMode m_BlendMode;
+	CullMode m_CullMode;
+	ZTestMode m_ZTestMode;
+	bool m_bZWrite;
+	bool m_bAlphaTest;
+	bool m_bLighting;
+	bool m_bTextureWrapping;
+	TextureMode m_TextureMode;
+	unsigned m_uBoundTexture;	/* 0 if none */
+	unsigned m_uNextTexHandle;
+
+	RageDisplayNullStats m_CurrentFrame, m_LastFrame, m_Average;
+	RageDisplayNullStats m_SinceLastCheck;
+	int m_iFramesSinceLastCheck;
+	RageTimer m_LastCheckTimer;
+};
+
+#endif
@@ -426,7 +426,10 @@ int RageFile::Write( const void *buffer, size_t bytes )
 	if( !(m_Mode&WRITE) )
 		RageException::Throw("\"%s\" is not open for writing", GetPath().c_str());
 
-	return m_File->Write( buffer, bytes );
+	int iRet = m_File->Write( buffer, bytes );
+	if( iRet > 0 )
+		m_FilePos += iRet;
+	return iRet;
 }
 
 
@@ -22,7 +22,11 @@ public:
 
 		/* Flush the file to disk on close.  Combined with not streaming, this results
 		 * in very safe writes, but is slow. */
-		SLOW_FLUSH		= 0x8
+		SLOW_FLUSH		= 0x8,
+
+		/* Write to the end of the existing file (creating it if needed) instead
+		 * of replacing it.  Implies STREAMED. */
+		APPEND			= 0x10
 	};
 
     RageFile( int bufferSize = 1024 );
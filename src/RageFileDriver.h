@@ -49,6 +49,7 @@ public:
 	virtual int SeekCur( int offset );
 	virtual int GetFileSize();
 	virtual CString GetDisplayPath() const { return parent.GetRealPath(); }
+	const RageFile &GetParent() const { return parent; }
 
 	/* Raw I/O: */
 	virtual int Read(void *buffer, size_t bytes) = 0;
@@ -89,13 +89,15 @@ RageFileObj *MakeFileObjDirect( const CString &sPath, int mode, RageFile &p, int
 	else
 	{
 		CString out;
-		if( mode & RageFile::STREAMED )
+		if( mode & (RageFile::STREAMED|RageFile::APPEND) )
 			out = sPath;
 		else
 			out = MakeTempFilename(sPath);
 
 		/* Open a temporary file for writing. */
-		fd = DoOpen( out, O_BINARY|O_WRONLY|O_CREAT|O_TRUNC, 0644 );
+		int flags = O_BINARY|O_WRONLY|O_CREAT;
+		flags |= (mode & RageFile::APPEND)? O_APPEND:O_TRUNC;
+		fd = DoOpen( out, flags, 0644 );
 	}
 
 	if( fd < 0 )
@@ -234,7 +236,7 @@ RageFileObjDirect::~RageFileObjDirect()
 	/* If we failed to flush the file properly, something's amiss--don't touch the original file! */
 	if( !failed &&
 		 (parent.GetOpenMode() & RageFile::WRITE) &&
-		!(parent.GetOpenMode() & RageFile::STREAMED) )
+		!(parent.GetOpenMode() & (RageFile::STREAMED|RageFile::APPEND)) )
 	{
 		/*
 		 * We now have path written to MakeTempFilename(path).  Rename the temporary
@@ -2,6 +2,7 @@
 #include "RageFileDriverDirectHelpers.h"
 #include "RageUtil.h"
 #include "RageLog.h"
+#include "Preference.h"
 
 #include <cerrno>
 #include <sys/types.h>
@@ -123,6 +124,32 @@ bool CreateDirectories( const CString &Path )
 	return true;
 }
 
+/* Get the modification time of a directory, in the same form PopulateFileSet
+ * uses for File::hash.  Returns false if it isn't a directory. */
+static bool GetDirHash( CString sPath, int &iHashOut )
+{
+	if( sPath.size() > 1 && sPath.Right(1) == "/" )
+		sPath.erase( sPath.size()-1 );
+	if( sPath == "" )
+		sPath = ".";
+
+#ifdef PSP
+	SceIoStat st;
+	if( sceIoGetstat( sPath, &st ) < 0 || !(st.st_mode & FIO_S_IFDIR) )
+		return false;
+
+	time_t time;
+	sceRtcGetTime_t( (const pspTime*)&st.st_mtime, &time );
+	iHashOut = time;
+#else
+	struct stat st;
+	if( DoStat( sPath, &st ) == -1 || !(st.st_mode & S_IFDIR) )
+		return false;
+	iHashOut = st.st_mtime;
+#endif
+	return true;
+}
+
 DirectFilenameDB::DirectFilenameDB( const CString &root_ )
 {
 	ExpireSeconds = 30;
@@ -131,8 +158,222 @@ DirectFilenameDB::DirectFilenameDB( const CString &root_ )
 		root += '/';
 	if( root == "./" )
 		root = "";
+
+	int iHash;
+	if( GetDirHash(root + "Cache", iHash) )
+	{
+		m_sSnapshotPath = root + "Cache/FileDB.snapshot";
+		LoadSnapshot();
+	}
+}
+
+DirectFilenameDB::~DirectFilenameDB()
+{
+	if( m_sSnapshotPath != "" )
+		SaveSnapshot();
+}
+
+/*
+ * Snapshot layout (all integers little-endian uint32, strings are a length
+ * followed by the characters):
+ *
+ *   magic, version, number of directories
+ *   directory: path, hash, runs unused, number of files
+ *   file: name, dir flag, size, hash
+ */
+static const unsigned SNAPSHOT_MAGIC = 0x53424446;	/* "FDBS" */
+static const unsigned SNAPSHOT_VERSION = 2;
+
+/* Directories that haven't been read for this many runs are dropped, so ones
+ * that were deleted don't stay in the snapshot forever. */
+static const int SNAPSHOT_MAX_RUNS_UNUSED = 8;
+
+/* The snapshot is written when the driver is destroyed, and saved listings are
+ * only used after preferences are loaded; until then this has its default.
+ * When it's off, the snapshot is deleted on exit. */
+static Preference<bool> FILEDB_SNAPSHOT( Options, "FileDBSnapshot", true );
+
+static void PutUint32( CString &sOut, unsigned i )
+{
+	sOut += char( i & 0xFF );
+	sOut += char( (i >> 8) & 0xFF );
+	sOut += char( (i >> 16) & 0xFF );
+	sOut += char( (i >> 24) & 0xFF );
+}
+
+static void PutString( CString &sOut, const CString &s )
+{
+	PutUint32( sOut, s.size() );
+	sOut += s;
 }
 
+/* Every Get* returns false if it would run past pEnd. */
+static bool GetUint32( const char *&p, const char *pEnd, unsigned &iOut )
+{
+	if( pEnd - p < 4 )
+		return false;
+	const unsigned char *u = (const unsigned char *) p;
+	iOut = u[0] | (u[1] << 8) | (u[2] << 16) | (u[3] << 24);
+	p += 4;
+	return true;
+}
+
+static bool GetString( const char *&p, const char *pEnd, CString &sOut )
+{
+	unsigned iSize;
+	if( !GetUint32(p, pEnd, iSize) || iSize > unsigned(pEnd - p) )
+		return false;
+	sOut.assign( p, iSize );
+	p += iSize;
+	return true;
+}
+
+void DirectFilenameDB::LoadSnapshot()
+{
+	int fd = DoOpen( m_sSnapshotPath, O_BINARY|O_RDONLY, 0644 );
+	if( fd < 0 )
+		return;
+
+	CString sData;
+	char buf[4096];
+	int iGot;
+	while( (iGot = read(fd, buf, sizeof(buf))) > 0 )
+		sData.append( buf, iGot );
+	close( fd );
+	if( iGot < 0 )
+		return;
+
+	const char *p = sData.data();
+	const char *pEnd = p + sData.size();
+	unsigned iMagic, iVersion, iNumDirs;
+	if( !GetUint32(p, pEnd, iMagic) || iMagic != SNAPSHOT_MAGIC ||
+		!GetUint32(p, pEnd, iVersion) || iVersion != SNAPSHOT_VERSION ||
+		!GetUint32(p, pEnd, iNumDirs) )
+		return;
+
+	for( unsigned d = 0; d < iNumDirs; ++d )
+	{
+		DirSnapshot snap;
+		unsigned iHash, iRunsUnused, iNumFiles;
+		if( !GetString(p, pEnd, snap.sPath) || !GetUint32(p, pEnd, iHash) ||
+			!GetUint32(p, pEnd, iRunsUnused) || !GetUint32(p, pEnd, iNumFiles) )
+			break;
+		snap.iHash = iHash;
+		snap.iRunsUnused = min( iRunsUnused, (unsigned) SNAPSHOT_MAX_RUNS_UNUSED ) + 1;
+		snap.bLive = false;
+
+		/* Each file takes at least 16 bytes; don't trust a huge count. */
+		if( iNumFiles > unsigned(pEnd - p) / 16 )
+			break;
+		snap.files.resize( iNumFiles );
+
+		bool bOK = true;
+		for( unsigned i = 0; bOK && i < iNumFiles; ++i )
+		{
+			File &f = snap.files[i];
+			CString sName;
+			unsigned iDir, iSize, iFileHash;
+			bOK = GetString(p, pEnd, sName) && GetUint32(p, pEnd, iDir) &&
+				GetUint32(p, pEnd, iSize) && GetUint32(p, pEnd, iFileHash);
+			f.SetName( sName );
+			f.dir = iDir != 0;
+			f.size = iSize;
+			f.hash = iFileHash;
+		}
+		if( !bOK )
+			break;
+
+		CString sKey = snap.sPath == ""? CString("."): snap.sPath;
+		sKey.MakeLower();
+		m_Snapshot[sKey] = snap;
+	}
+
+	if( p != pEnd )
+	{
+		/* Damaged; don't trust any of it. */
+		if( LOG )
+			LOG->Warn( "%s is damaged; ignored", m_sSnapshotPath.c_str() );
+		m_Snapshot.clear();
+	}
+}
+
+void DirectFilenameDB::SaveSnapshot()
+{
+	if( !FILEDB_SNAPSHOT )
+	{
+		remove( m_sSnapshotPath );
+		return;
+	}
+
+	CString sOut;
+	unsigned iNumDirs = 0;
+	for( map<CString, DirSnapshot>::const_iterator it = m_Snapshot.begin(); it != m_Snapshot.end(); ++it )
+	{
+		const DirSnapshot &snap = it->second;
+		if( snap.iHash == -1 )
+			continue;
+		if( !snap.bLive && snap.iRunsUnused >= SNAPSHOT_MAX_RUNS_UNUSED )
+			continue;
+
+		/* A live listing is only current if it's still cached; if it was flushed,
+		 * we don't know what's in it anymore. */
+		const FileSet *pLive = NULL;
+		if( snap.bLive )
+		{
+			map<CString, FileSet *>::const_iterator d = dirs.find( it->first );
+			if( d == dirs.end() )
+				continue;
+			pLive = d->second;
+		}
+
+		PutString( sOut, snap.sPath );
+		PutUint32( sOut, snap.iHash );
+		PutUint32( sOut, snap.bLive? 0:snap.iRunsUnused );
+		if( pLive )
+		{
+			PutUint32( sOut, pLive->files.size() );
+			for( set<File>::const_iterator f = pLive->files.begin(); f != pLive->files.end(); ++f )
+			{
+				PutString( sOut, f->name );
+				PutUint32( sOut, f->dir );
+				PutUint32( sOut, f->size );
+				PutUint32( sOut, f->hash );
+			}
+		}
+		else
+		{
+			PutUint32( sOut, snap.files.size() );
+			for( unsigned i = 0; i < snap.files.size(); ++i )
+			{
+				const File &f = snap.files[i];
+				PutString( sOut, f.name );
+				PutUint32( sOut, f.dir );
+				PutUint32( sOut, f.size );
+				PutUint32( sOut, f.hash );
+			}
+		}
+		++iNumDirs;
+	}
+
+	CString sHeader;
+	PutUint32( sHeader, SNAPSHOT_MAGIC );
+	PutUint32( sHeader, SNAPSHOT_VERSION );
+	PutUint32( sHeader, iNumDirs );
+	sOut.insert( 0, sHeader );
+
+	/* Write to a temporary file and rename it over the old one, so a crash
+	 * never leaves a partial snapshot. */
+	const CString sTemp = m_sSnapshotPath + ".new";
+	int fd = DoOpen( sTemp, O_BINARY|O_WRONLY|O_CREAT|O_TRUNC, 0644 );
+	if( fd < 0 )
+		return;
+	const bool bFailed = write( fd, sOut.data(), sOut.size() ) != (int) sOut.size();
+	close( fd );
+
+	remove( m_sSnapshotPath );
+	if( bFailed || rename(sTemp, m_sSnapshotPath) < 0 )
+		remove( sTemp );
+}
 
 void DirectFilenameDB::PopulateFileSet( FileSet &fs, const CString &path )
 {
@@ -144,6 +385,37 @@ void DirectFilenameDB::PopulateFileSet( FileSet &fs, const CString &path )
 	fs.age.GetDeltaTime(); /* reset */
 	fs.files.clear();
 
+	if( m_sSnapshotPath != "" )
+	{
+		CString sKey = path;
+		sKey.MakeLower();
+
+		/* Get the directory's time before reading it, so a change made while
+		 * we're reading it is seen next time. */
+		int iHash;
+		if( !GetDirHash(root + sPath, iHash) )
+			iHash = -1;
+
+		DirSnapshot &snap = m_Snapshot[sKey];
+		const bool bUseSaved = FILEDB_SNAPSHOT && !snap.bLive && iHash != -1 && snap.iHash == iHash;
+		if( bUseSaved )
+		{
+			for( unsigned i = 0; i < snap.files.size(); ++i )
+				fs.files.insert( snap.files[i] );
+		}
+
+		/* From now on, the listing in "dirs" is the current one.  Saved listings
+		 * are only used once; when a cached directory expires, read it again. */
+		snap.sPath = sPath;
+		snap.iRunsUnused = 0;
+		snap.iHash = iHash;
+		snap.bLive = true;
+		snap.files.clear();
+
+		if( bUseSaved )
+			return;
+	}
+
 #ifdef PSP
 	SceUID d = sceIoDopen( root + sPath );
 	if( d < 0 )
@@ -104,8 +104,30 @@ protected:
 	virtual void PopulateFileSet( FileSet &fs, const CString &sPath );
 	CString root;
 
+	/*
+	 * If the root has a Cache directory, the directories we've read are saved
+	 * there when we're destroyed and loaded when we're created.  A saved
+	 * listing is used in place of reading the directory as long as the
+	 * directory's own modification time hasn't changed.  FAT doesn't always
+	 * update that when files are copied in from a PC, so this can be turned
+	 * off with the FileDBSnapshot preference.
+	 */
+	struct DirSnapshot
+	{
+		CString sPath;		/* real case, relative to root */
+		int iHash;			/* modification time of the directory when it was read */
+		int iRunsUnused;	/* runs since the directory was last read */
+		bool bLive;			/* the listing is in "dirs"; files is unused */
+		vector<File> files;
+	};
+	map<CString, DirSnapshot> m_Snapshot;	/* by lowercase path, as in "dirs" */
+	CString m_sSnapshotPath;
+	void LoadSnapshot();
+	void SaveSnapshot();
+
 public:
 	DirectFilenameDB( const CString &root_ );
+	~DirectFilenameDB();
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include "RageLog.h"
 #include "RageUtil.h"
 #include "RageUtil_FileDB.h"
+#include "Preference.h"
 
 #include <cerrno>
 #include <zlib.h>
@@ -51,6 +52,30 @@ struct end_central_dir_record
 #define STORED		0
 #define DEFLATED	8
 
+/*
+ * Restarting inflate part way through a stream needs the last 32k of output (the
+ * window) and, since deflate blocks aren't byte-aligned, the unused bits of the
+ * previous input byte.  Checkpoints are recorded at block boundaries during the
+ * first forward pass.  This needs Z_BLOCK and inflatePrime (zlib 1.2.3).
+ */
+#if defined(ZLIB_VERNUM) && ZLIB_VERNUM >= 0x1230
+#define ZIP_SEEK_CHECKPOINTS
+#endif
+
+#define WINDOW_SIZE 32768
+
+/* Deflated files record a restart point about this often, so seeking backwards
+ * doesn't have to decompress from the start.  0 disables. */
+static Preference<int> ZIP_SEEK_CHECKPOINT_KB( Options, "ZipSeekCheckpointKB", 1024 );
+
+struct InflateCheckpoint
+{
+	int UFilePos, CFilePos;
+	int bits;	/* bits of the byte before CFilePos that are still unused */
+	int window_size;
+	unsigned char window[WINDOW_SIZE];
+};
+
 class RageFileObjZipDeflated: public RageFileObj
 {
 private:
@@ -62,6 +87,18 @@ private:
 	char decomp_buf[INBUFSIZE], *decomp_buf_ptr;
 	int decomp_buf_avail;
 
+	/* Checkpoints, sorted by UFilePos.  window is the last WINDOW_SIZE bytes of
+	 * output, as a ring; it's only kept if we're recording checkpoints. */
+	vector<InflateCheckpoint *> checkpoints;
+	unsigned char *window;
+	int window_pos, window_fill;
+	int checkpoint_interval;	/* bytes of output; read once, when opened */
+
+	void AddToWindow( const char *buf, int size );
+	void AddCheckpoint();
+	bool RestoreCheckpoint( const InflateCheckpoint &cp );
+	int SkipForward( int bytes );
+
 public:
 	RageFileObjZipDeflated( const RageFile &f, const FileInfo &info, RageFile &p );
 	RageFileObjZipDeflated( const RageFileObjZipDeflated &cpy, RageFile &p );
@@ -463,6 +500,15 @@ RageFileObjZipDeflated::RageFileObjZipDeflated( const RageFile &f, const FileInf
 
 	decomp_buf_ptr = decomp_buf;
 	CFilePos = UFilePos = 0;
+
+	/* Only bother for files big enough to span several checkpoints. */
+	window = NULL;
+	window_pos = window_fill = 0;
+	checkpoint_interval = ZIP_SEEK_CHECKPOINT_KB * 1024;
+#if defined(ZIP_SEEK_CHECKPOINTS)
+	if( checkpoint_interval > 0 && (int) info.uncompr_size > checkpoint_interval*2 )
+		window = new unsigned char[WINDOW_SIZE];
+#endif
 }
 
 RageFileObjZipDeflated::RageFileObjZipDeflated( const RageFileObjZipDeflated &cpy, RageFile &p ):
@@ -495,6 +541,44 @@ RageFileObjZipDeflated::~RageFileObjZipDeflated()
 	int err = inflateEnd( &dstrm );
 	if( err != Z_OK )
 		LOG->Trace( "Huh? inflateEnd() err = %i", err );
+
+	for( unsigned i = 0; i < checkpoints.size(); ++i )
+		delete checkpoints[i];
+	delete [] window;
+}
+
+void RageFileObjZipDeflated::AddToWindow( const char *buf, int size )
+{
+	if( size >= WINDOW_SIZE )
+	{
+		memcpy( window, buf + size - WINDOW_SIZE, WINDOW_SIZE );
+		window_pos = 0;
+		window_fill = WINDOW_SIZE;
+		return;
+	}
+
+	const int first = min( size, WINDOW_SIZE - window_pos );
+	memcpy( window + window_pos, buf, first );
+	memcpy( window, buf + first, size - first );
+	window_pos = (window_pos + size) % WINDOW_SIZE;
+	window_fill = min( window_fill + size, WINDOW_SIZE );
+}
+
+void RageFileObjZipDeflated::AddCheckpoint()
+{
+	InflateCheckpoint *cp = new InflateCheckpoint;
+	cp->UFilePos = UFilePos;
+	cp->CFilePos = CFilePos;
+	cp->bits = dstrm.data_type & 7;
+
+	/* Unroll the ring, oldest byte first. */
+	cp->window_size = window_fill;
+	const int start = (window_pos - window_fill + WINDOW_SIZE) % WINDOW_SIZE;
+	const int first = min( window_fill, WINDOW_SIZE - start );
+	memcpy( cp->window, window + start, first );
+	memcpy( cp->window + first, window, window_fill - first );
+
+	checkpoints.push_back( cp );
 }
 
 int RageFileObjZipDeflated::Read( void *buf, size_t bytes )
@@ -524,8 +608,14 @@ int RageFileObjZipDeflated::Read( void *buf, size_t bytes )
 		dstrm.next_out = (Bytef *) buf;
 		dstrm.avail_out = bytes;
 
+		/* While recording checkpoints, stop at each block boundary. */
+		int flush = Z_PARTIAL_FLUSH;
+#if defined(ZIP_SEEK_CHECKPOINTS)
+		if( window != NULL )
+			flush = Z_BLOCK;
+#endif
 
-		int err = inflate(&dstrm, Z_PARTIAL_FLUSH);
+		int err = inflate(&dstrm, flush);
 		switch( err )
 		{
 		case Z_DATA_ERROR:
@@ -551,6 +641,18 @@ int RageFileObjZipDeflated::Read( void *buf, size_t bytes )
 		const int got = (char *)dstrm.next_out - (char *)buf;
 		UFilePos += got;
 		ret += got;
+
+		if( window != NULL )
+		{
+			AddToWindow( (const char *) buf, got );
+
+			/* At a block boundary that isn't the end of the stream, past the last
+			 * checkpoint by at least one interval? */
+			const int last = checkpoints.empty()? 0: checkpoints.back()->UFilePos;
+			if( (dstrm.data_type & 128) && !(dstrm.data_type & 64) && UFilePos - last >= checkpoint_interval )
+				AddCheckpoint();
+		}
+
 		buf = (char *)buf + got;
 		bytes -= got;
 	}
@@ -567,6 +669,54 @@ void RageFileObjZipDeflated::Rewind()
     zip.Seek( info.data_offset );
 	CFilePos = 0;
 	UFilePos = 0;
+	window_pos = window_fill = 0;
+}
+
+bool RageFileObjZipDeflated::RestoreCheckpoint( const InflateCheckpoint &cp )
+{
+#if defined(ZIP_SEEK_CHECKPOINTS)
+	inflateReset( &dstrm );
+	decomp_buf_ptr = decomp_buf;
+	decomp_buf_avail = 0;
+
+	/* If the checkpoint isn't byte-aligned, feed inflate the leftover bits of
+	 * the previous byte. */
+	zip.Seek( info.data_offset + cp.CFilePos - (cp.bits? 1:0) );
+	if( cp.bits )
+	{
+		unsigned char c;
+		if( zip.Read( &c, 1 ) != 1 )
+			return false;
+		inflatePrime( &dstrm, cp.bits, c >> (8 - cp.bits) );
+	}
+	inflateSetDictionary( &dstrm, cp.window, cp.window_size );
+
+	CFilePos = cp.CFilePos;
+	UFilePos = cp.UFilePos;
+
+	window_pos = window_fill = 0;
+	AddToWindow( (const char *) cp.window, cp.window_size );
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* Decode and discard bytes; returns the new position, or -1 on error. */
+int RageFileObjZipDeflated::SkipForward( int bytes )
+{
+	char buf[1024*4];
+	while( bytes )
+	{
+		int got = Read( buf, min( (int) sizeof(buf), bytes ) );
+		if( got < 0 )
+			return -1;
+		if( got == 0 )
+			break;
+		bytes -= got;
+	}
+
+	return UFilePos;
 }
 
 int RageFileObjZipDeflated::Seek( int offset )
@@ -584,8 +734,27 @@ int RageFileObjZipDeflated::Seek( int offset )
 		return offset;
 	}
 
-	/* Can this be optimized? */
-	return RageFileObj::Seek( offset );
+	/* Find the last checkpoint at or before offset.  Restart from it if we're
+	 * seeking backwards, or if it's further ahead than where we are now.  (Don't
+	 * use RageFileObj::Seek; parent.Tell() is stale once RageFile has dropped its
+	 * read buffer, so it'd skip to the wrong place.) */
+	int cp = -1;
+	for( int i = checkpoints.size()-1; i >= 0; --i )
+	{
+		if( checkpoints[i]->UFilePos <= offset )
+		{
+			cp = i;
+			break;
+		}
+	}
+
+	if( offset < UFilePos || (cp != -1 && checkpoints[cp]->UFilePos > UFilePos) )
+	{
+		if( cp == -1 || !RestoreCheckpoint(*checkpoints[cp]) )
+			Rewind();
+	}
+
+	return SkipForward( offset - UFilePos );
 }
 
 RageFileObjZipStored::RageFileObjZipStored( const RageFile &f, const FileInfo &info_, RageFile &p ):
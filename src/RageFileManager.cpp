@@ -64,6 +64,78 @@ public:
 };
 static RageFileDriverMountpoints *g_Mountpoints = NULL;
 
+/*
+ * Cache of lookups that would otherwise ask every driver in turn: which driver
+ * a path belongs to, and merged directory listings.  Paths are normalized and
+ * lowercase.  Drivers expire their own caches, but this one is only cleared
+ * by things that go through us and can change the answers: mounting,
+ * unmounting, writing, removing and FlushDirCache.
+ */
+struct PathOwner
+{
+	int iDriver;	/* index into g_Drivers, or -1 */
+	RageFileManager::FileType type;
+};
+static map<CString, PathOwner> g_PathOwners;
+static map<CString, CStringArray> g_DirListings;
+
+/* Bound memory use; when a cache fills, it's simply cleared. */
+static const unsigned MAX_CACHED_PATHS = 4096;
+static const unsigned MAX_CACHED_LISTINGS = 256;
+
+static void InvalidatePathIndex()
+{
+	g_PathOwners.clear();
+	g_DirListings.clear();
+}
+
+static void TrimSlashes( CString &s )
+{
+	TrimLeft( s, "/" );
+	TrimRight( s, "/" );
+}
+
+/* Return true if sDir is sFile or one of the directories above it.  Both are lowercase. */
+static bool IsSelfOrAncestor( CString sDir, const CString &sFile )
+{
+	TrimSlashes( sDir );
+	if( sDir.empty() || sDir == sFile )
+		return true;
+	return sFile.size() > sDir.size() && sFile[sDir.size()] == '/' &&
+		!sFile.compare( 0, sDir.size(), sDir );
+}
+
+/* Writing sPath (normalized) can create it and the directories above it, and
+ * changes the listings of those directories; forget just those. */
+static void InvalidatePath( CString sPath )
+{
+	sPath.MakeLower();
+	TrimSlashes( sPath );
+
+	for( map<CString, PathOwner>::iterator it = g_PathOwners.begin(); it != g_PathOwners.end(); )
+	{
+		map<CString, PathOwner>::iterator next = it;
+		++next;
+		if( IsSelfOrAncestor(it->first, sPath) )
+			g_PathOwners.erase( it );
+		it = next;
+	}
+
+	for( map<CString, CStringArray>::iterator it = g_DirListings.begin(); it != g_DirListings.end(); )
+	{
+		map<CString, CStringArray>::iterator next = it;
+		++next;
+
+		/* Skip the flags; the listing is of the directory part of the rest. */
+		const CString sListing = it->first.substr( 2 );
+		const size_t iSlash = sListing.rfind( '/' );
+		const CString sDir = (iSlash == CString::npos)? CString(""): sListing.substr( 0, iSlash );
+		if( IsSelfOrAncestor(sDir, sPath) )
+			g_DirListings.erase( it );
+		it = next;
+	}
+}
+
 static CString GetDirOfExecutable( const CString &argv0 )
 {
 	CString sPath = argv0;
@@ -172,6 +244,38 @@ static void NormalizePath( CString &sPath )
 	CollapsePath( sPath, true );
 }
 
+/* Find the first driver that has sPath.  sPath must be normalized, and g_Mutex held. */
+static PathOwner GetPathOwner( const CString &sPath )
+{
+	CString sKey = sPath;
+	sKey.MakeLower();
+
+	map<CString, PathOwner>::const_iterator it = g_PathOwners.find( sKey );
+	if( it != g_PathOwners.end() )
+		return it->second;
+
+	PathOwner owner;
+	owner.iDriver = -1;
+	owner.type = RageFileManager::TYPE_NONE;
+	for( unsigned i = 0; i < g_Drivers.size(); ++i )
+	{
+		const CString p = g_Drivers[i].GetPath( sPath );
+		if( p.size() == 0 )
+			continue;
+		owner.type = g_Drivers[i].driver->GetFileType( p );
+		if( owner.type != RageFileManager::TYPE_NONE )
+		{
+			owner.iDriver = i;
+			break;
+		}
+	}
+
+	if( g_PathOwners.size() >= MAX_CACHED_PATHS )
+		g_PathOwners.clear();
+	g_PathOwners[sKey] = owner;
+	return owner;
+}
+
 bool ilt( const CString &a, const CString &b ) { return a.CompareNoCase(b) < 0; }
 bool ieq( const CString &a, const CString &b ) { return a.CompareNoCase(b) == 0; }
 void RageFileManager::GetDirListing( CString sPath, CStringArray &AddTo, bool bOnlyDirs, bool bReturnPathToo )
@@ -179,29 +283,52 @@ void RageFileManager::GetDirListing( CString sPath, CStringArray &AddTo, bool bO
 	g_Mutex->Lock();
 
 	NormalizePath( sPath );
-	
-	for( unsigned i = 0; i < g_Drivers.size(); ++i )
+
+	CString sKey = ssprintf( "%i%i", bOnlyDirs, bReturnPathToo ) + sPath;
+	sKey.MakeLower();
+
+	map<CString, CStringArray>::iterator cached = g_DirListings.find( sKey );
+	if( cached == g_DirListings.end() )
 	{
-		LoadedDriver &ld = g_Drivers[i];
-		const CString p = ld.GetPath( sPath );
-		if( p.size() == 0 )
-			continue;
+		CStringArray Listing;
+		for( unsigned i = 0; i < g_Drivers.size(); ++i )
+		{
+			LoadedDriver &ld = g_Drivers[i];
+			const CString p = ld.GetPath( sPath );
+			if( p.size() == 0 )
+				continue;
 
-		const unsigned OldStart = AddTo.size();
-		
-		ld.driver->GetDirListing( p, AddTo, bOnlyDirs, bReturnPathToo );
+			const unsigned OldStart = Listing.size();
+			
+			ld.driver->GetDirListing( p, Listing, bOnlyDirs, bReturnPathToo );
+
+			/* If returning the path, prepend the mountpoint name to the files this driver returned. */
+			if( bReturnPathToo )
+				for( unsigned j = OldStart; j < Listing.size(); ++j )
+					Listing[j] = ld.MountPoint + Listing[j];
+		}
 
-		/* If returning the path, prepend the mountpoint name to the files this driver returned. */
-		if( bReturnPathToo )
-			for( unsigned j = OldStart; j < AddTo.size(); ++j )
-				AddTo[j] = ld.MountPoint + AddTo[j];
+		/* More than one driver might return the same file.  Remove duplicates (case-
+		 * insensitively). */
+		sort( Listing.begin(), Listing.end(), ilt );
+		CStringArray::iterator it = unique( Listing.begin(), Listing.end(), ieq );
+		Listing.erase(it, Listing.end());
+
+		if( g_DirListings.size() >= MAX_CACHED_LISTINGS )
+			g_DirListings.clear();
+		cached = g_DirListings.insert( make_pair(sKey, Listing) ).first;
 	}
 
-	/* More than one driver might return the same file.  Remove duplicates (case-
-	 * insensitively). */
-	sort( AddTo.begin(), AddTo.end(), ilt );
-	CStringArray::iterator it = unique( AddTo.begin(), AddTo.end(), ieq );
-	AddTo.erase(it, AddTo.end());
+	/* The cached listing is already sorted and unique.  If AddTo had something
+	 * in it already, the whole thing is sorted and made unique, as always. */
+	const bool bMerge = !AddTo.empty();
+	AddTo.insert( AddTo.end(), cached->second.begin(), cached->second.end() );
+	if( bMerge )
+	{
+		sort( AddTo.begin(), AddTo.end(), ilt );
+		CStringArray::iterator it = unique( AddTo.begin(), AddTo.end(), ieq );
+		AddTo.erase(it, AddTo.end());
+	}
 
 	g_Mutex->Unlock();
 }
@@ -226,6 +353,8 @@ bool RageFileManager::Remove( CString sPath )
 			Deleted = true;
 	}
 
+	InvalidatePathIndex();
+
 	g_Mutex->Unlock();
 	return Deleted;
 }
@@ -287,6 +416,7 @@ void RageFileManager::Mount( CString Type, CString Root, CString MountPoint )
 
 	CHECKPOINT;
 	g_Mountpoints->LoadFromDrivers( g_Drivers );
+	InvalidatePathIndex();
 	CHECKPOINT;
 
 	g_Mutex->Unlock();
@@ -316,6 +446,7 @@ void RageFileManager::Unmount( CString Type, CString Root, CString MountPoint )
 	}
 
 	g_Mountpoints->LoadFromDrivers( g_Drivers );
+	InvalidatePathIndex();
 
 	g_Mutex->Unlock();
 }
@@ -387,6 +518,8 @@ void RageFileManager::FlushDirCache( CString sPath )
 		}
 	}
 
+	InvalidatePathIndex();
+
 	g_Mutex->Unlock();
 }
 
@@ -397,16 +530,7 @@ RageFileManager::FileType RageFileManager::GetFileType( CString sPath )
 	g_Mutex->Lock();
 
 	NormalizePath( sPath );
-
-	for( unsigned i = 0; i < g_Drivers.size(); ++i )
-	{
-		const CString p = g_Drivers[i].GetPath( sPath );
-		if( p.size() == 0 )
-			continue;
-		ret = g_Drivers[i].driver->GetFileType( p );
-		if( ret != TYPE_NONE )
-			break;
-	}
+	ret = GetPathOwner( sPath ).type;
 
 	g_Mutex->Unlock();
 	return ret;
@@ -421,14 +545,17 @@ int RageFileManager::GetFileSizeInBytes( CString sPath )
 
 	NormalizePath( sPath );
 
-	for( unsigned i = 0; i < g_Drivers.size(); ++i )
+	/* Usually only the driver that owns the file needs to be asked. */
+	const PathOwner owner = GetPathOwner( sPath );
+	if( owner.type == TYPE_FILE )
+		ret = g_Drivers[owner.iDriver].driver->GetFileSizeInBytes( g_Drivers[owner.iDriver].GetPath(sPath) );
+
+	for( unsigned i = 0; ret < 0 && owner.type != TYPE_NONE && i < g_Drivers.size(); ++i )
 	{
 		const CString p = g_Drivers[i].GetPath( sPath );
 		if( p.size() == 0 )
 			continue;
 		ret = g_Drivers[i].driver->GetFileSizeInBytes( p );
-		if( ret >= 0 )
-			break;
 	}
 
 	g_Mutex->Unlock();
@@ -443,14 +570,16 @@ int RageFileManager::GetFileHash( CString sPath )
 
 	NormalizePath( sPath );
 
-	for( unsigned i = 0; i < g_Drivers.size(); ++i )
+	const PathOwner owner = GetPathOwner( sPath );
+	if( owner.type == TYPE_FILE )
+		ret = g_Drivers[owner.iDriver].driver->GetFileHash( g_Drivers[owner.iDriver].GetPath(sPath) );
+
+	for( unsigned i = 0; ret < 0 && owner.type != TYPE_NONE && i < g_Drivers.size(); ++i )
 	{
 		const CString p = g_Drivers[i].GetPath( sPath );
 		if( p.size() == 0 )
 			continue;
 		ret = g_Drivers[i].driver->GetFileHash( p );
-		if( ret >= 0 )
-			break;
 	}
 
 	g_Mutex->Unlock();
@@ -530,6 +659,22 @@ RageFileObj *RageFileManager::Open( CString sPath, int mode, RageFile &p, int &e
 
 	NormalizePath( sPath );
 
+	/* Try the driver that owns the file first.  If that fails, or we don't know
+	 * of one, ask everyone; a driver may be able to open a file it hasn't seen. */
+	const PathOwner owner = GetPathOwner( sPath );
+	if( owner.type == TYPE_FILE )
+	{
+		LoadedDriver &ld = g_Drivers[owner.iDriver];
+		int error;
+		ret = ld.driver->Open( ld.GetPath(sPath), mode, p, error );
+		if( ret )
+		{
+			AddReference( ret, ld.driver );
+			g_Mutex->Unlock();
+			return ret;
+		}
+	}
+
 	for( unsigned i = 0; i < g_Drivers.size(); ++i )
 	{
 		LoadedDriver &ld = g_Drivers[i];
@@ -626,6 +771,8 @@ RageFileObj *RageFileManager::OpenForWriting( CString sPath, int mode, RageFile
 		RageFileObj *ret = ld.driver->Open( path, mode, p, error );
 		if( ret )
 		{
+			/* The file (or the driver's temporary file) may have just appeared. */
+			InvalidatePath( sPath );
 			AddReference( ret, ld.driver );
 			g_Mutex->Unlock();
 			return ret;
@@ -649,8 +796,20 @@ void RageFileManager::Close( RageFileObj *obj )
 	if( obj == NULL )
 		return;
 
+	const bool bWriting = !!(obj->GetParent().GetOpenMode() & RageFile::WRITE);
+	CString sPath = obj->GetParent().GetRealPath();
+
 	RemoveReference( obj );
 	delete obj;
+
+	/* Drivers may write to a temporary file and only rename it into place when
+	 * the object is deleted. */
+	if( bWriting )
+	{
+		NormalizePath( sPath );
+		LockMut( *g_Mutex );
+		InvalidatePath( sPath );
+	}
 }
 
 bool RageFileManager::IsAFile( const CString &sPath ) { return GetFileType(sPath) == TYPE_FILE; }
@@ -59,9 +59,41 @@ map<CString, CString> LogMaps;
 
 static RageFile *g_fileLog = NULL, *g_fileInfo = NULL;
 
-/* Mutex writes to the files.  Writing to files is not thread-aware, and this is the
- * only place we write to the same file from multiple threads. */
+/* Lines aren't written to disk by the thread that logs them.  Write() formats
+ * them into a ring buffer, and a writer thread drains the ring to the files.
+ * Callers only wait for a memcpy, never for file I/O.  (The PSP has no atomic
+ * compare-and-swap, so the ring is guarded by g_Mutex rather than being
+ * lock-free; it's never held across I/O.)
+ *
+ * g_Mutex guards the ring and the static crash buffers below.  g_FileMutex
+ * serializes writes to the files; whoever holds it writes lines in ring order. */
 RageMutex *g_Mutex = NULL;
+static RageMutex *g_FileMutex = NULL;
+static RageSemaphore *g_LogQueueSema = NULL;
+static RageThread g_WriterThread;
+static bool g_bWriterShutdown = false;
+
+/* Destinations of a queued line. */
+enum {
+	DEST_LOG	= 0x01,	/* log.txt */
+	DEST_INFO	= 0x02,	/* info.txt */
+	DEST_STDOUT	= 0x04,
+	DEST_FLUSH	= 0x08	/* flush the files after writing this */
+};
+
+struct QueuedLine
+{
+	int iDest;
+	int iLength;	/* -1 marks the end of the ring; the next line is at 0 */
+};
+
+static const int LOG_QUEUE_SIZE = 1024*32;
+static char g_LogQueue[LOG_QUEUE_SIZE];
+static int g_iQueueRead = 0, g_iQueueWrite = 0, g_iQueueUsed = 0;
+static int g_iDroppedLinesReported = 0;
+
+/* Keep headers aligned. */
+static inline int QueuedSize( int iLength ) { return (sizeof(QueuedLine) + iLength + 3) & ~3; }
 
 /* staticlog gets info.txt
  * crashlog gets log.txt */
@@ -80,15 +112,23 @@ RageLog::RageLog()
 	g_fileInfo = new RageFile;
 	
 	g_Mutex = new RageMutex("Log");
+	g_FileMutex = new RageMutex("LogFile");
+	g_LogQueueSema = new RageSemaphore("LogQueue");
 
 	m_bLogToDisk = false;
 	m_bInfoToDisk = false;
 	m_bFlush = false;
 	m_bShowLogOutput = false;
+	m_OverflowPolicy = OVERFLOW_BLOCK;
+	m_iDroppedLines = 0;
 
 	// delete old log files
 	remove( LOG_PATH );
 	remove( INFO_PATH );
+
+	g_bWriterShutdown = false;
+	g_WriterThread.SetName( "Log writer" );
+	g_WriterThread.Create( WriterThread_start, this );
 }
 
 RageLog::~RageLog()
@@ -104,11 +144,19 @@ RageLog::~RageLog()
 		this->Info( "%s", AdditionalLogLines[i].c_str() );
 	}
 
+	g_bWriterShutdown = true;
+	g_LogQueueSema->Post();
+	g_WriterThread.Wait();
+
 	Flush();
 	SetShowLogOutput( false );
 	g_fileLog->Close();
 	g_fileInfo->Close();
 
+	delete g_LogQueueSema;
+	g_LogQueueSema = NULL;
+	delete g_FileMutex;
+	g_FileMutex = NULL;
 	delete g_Mutex;
 	g_Mutex = NULL;
 
@@ -125,6 +173,7 @@ void RageLog::SetLogToDisk( bool b )
 
 	m_bLogToDisk = b;
 
+	LockMut( *g_FileMutex );
 	if( !m_bLogToDisk )
 	{
 		if( g_fileLog->IsOpen() )
@@ -143,6 +192,7 @@ void RageLog::SetInfoToDisk( bool b )
 
 	m_bInfoToDisk = b;
 
+	LockMut( *g_FileMutex );
 	if( !m_bInfoToDisk )
 	{
 		if( g_fileInfo->IsOpen() )
@@ -217,10 +267,10 @@ void RageLog::Write( int where, const CString &line )
 
 	vector<CString> lines;
 	split( line, "\n", lines, false );
-	if( m_bLogToDisk && g_fileLog->IsOpen() && (where & WRITE_LOUD) )
-		g_fileLog->PutLine( "/////////////////////////////////////////" );
+	if( m_bLogToDisk && (where & WRITE_LOUD) )
+		Queue( DEST_LOG, "/////////////////////////////////////////" );
 	if( where & WRITE_LOUD )
-		fprintf( stdout, "/////////////////////////////////////////\n" );
+		Queue( DEST_STDOUT, "/////////////////////////////////////////" );
 
 	CString sTimestamp = SecondsToMMSSMsMsMs(RageTimer::GetTimeSinceStart()) + ": ";
 	CString sWarning;
@@ -235,36 +285,176 @@ void RageLog::Write( int where, const CString &line )
 			str.insert( 0, sWarning );
 
 		if( m_bShowLogOutput || where != 0 )
-			fprintf( stdout, "%s\n", str.c_str() );
+			Queue( DEST_STDOUT, str );
 		if( where & WRITE_TO_INFO )
 			AddToInfo( str );
-		if( m_bLogToDisk && (where&WRITE_TO_INFO) && g_fileInfo->IsOpen() )
-			g_fileInfo->PutLine( str );
+		if( m_bLogToDisk && (where&WRITE_TO_INFO) )
+			Queue( DEST_INFO, str );
 
 		/* Add a timestamp to log.txt and RecentLogs, but not the rest of info.txt
 		 * and stdout. */
 		str.insert( 0, sTimestamp );
 
+		/* RecentLogs is for crash handlers, so keep it up to date here rather
+		 * than in the writer. */
 		AddToRecentLogs( str );
 		
-		if( m_bLogToDisk && g_fileLog->IsOpen() )
-			g_fileLog->PutLine( str );
+		if( m_bLogToDisk )
+			Queue( DEST_LOG, str );
 	}
 
-	if( m_bLogToDisk && g_fileLog->IsOpen() && (where & WRITE_LOUD) )
-		g_fileLog->PutLine( "/////////////////////////////////////////" );
+	if( m_bLogToDisk && (where & WRITE_LOUD) )
+		Queue( DEST_LOG, "/////////////////////////////////////////" );
 	if( where & WRITE_LOUD )
-		fprintf( stdout, "/////////////////////////////////////////\n" );
+		Queue( DEST_STDOUT, "/////////////////////////////////////////" );
 
 	if( m_bFlush || (where & WRITE_TO_INFO) )
-		Flush();
+		Queue( DEST_FLUSH, "" );
 
 	g_Mutex->Unlock();
 }
 
+/* Add a line to the ring.  g_Mutex must be held. */
+void RageLog::Queue( int iDest, const CString &str )
+{
+	const int iMaxLength = LOG_QUEUE_SIZE/2 - sizeof(QueuedLine);
+	const int iLength = min( (int) str.size(), iMaxLength );
+	const int iSize = QueuedSize( iLength );
+
+	while( 1 )
+	{
+		/* Start over at the beginning when the ring is empty, so a line never
+		 * needs more than the whole ring. */
+		if( g_iQueueUsed == 0 )
+			g_iQueueRead = g_iQueueWrite = 0;
+
+		/* If the line doesn't fit before the end of the ring, we waste the rest. */
+		const int iToEnd = LOG_QUEUE_SIZE - g_iQueueWrite;
+		const int iNeeded = iSize <= iToEnd? iSize: iToEnd + iSize;
+		if( g_iQueueUsed + iNeeded <= LOG_QUEUE_SIZE )
+			break;
+
+		if( m_OverflowPolicy == OVERFLOW_DROP )
+		{
+			++m_iDroppedLines;
+			return;
+		}
+
+		/* Wait for the writer to make room.  If there's no writer, or we're
+		 * logging from inside a file write, the writer can't run; make room ourself. */
+		g_Mutex->Unlock();
+		if( !g_WriterThread.IsCreated() || g_FileMutex->IsLockedByThisThread() )
+			Drain();
+		else
+		{
+			g_LogQueueSema->Post();
+			usleep( 1000 );
+		}
+		g_Mutex->Lock();
+	}
+
+	const bool bWasEmpty = (g_iQueueUsed == 0);
+
+	const int iToEnd = LOG_QUEUE_SIZE - g_iQueueWrite;
+	if( iSize > iToEnd )
+	{
+		if( iToEnd >= (int) sizeof(QueuedLine) )
+			((QueuedLine *) (g_LogQueue + g_iQueueWrite))->iLength = -1;
+		g_iQueueUsed += iToEnd;
+		g_iQueueWrite = 0;
+	}
+
+	QueuedLine *pLine = (QueuedLine *) (g_LogQueue + g_iQueueWrite);
+	pLine->iDest = iDest;
+	pLine->iLength = iLength;
+	memcpy( pLine+1, str.data(), iLength );
+	g_iQueueUsed += iSize;
+	g_iQueueWrite = (g_iQueueWrite + iSize) % LOG_QUEUE_SIZE;
+
+	/* If the ring was empty, the writer may be asleep. */
+	if( bWasEmpty )
+		g_LogQueueSema->Post();
+}
+
+/* Write out everything in the ring.  Returns false if it was empty. */
+bool RageLog::Drain()
+{
+	LockMut( *g_FileMutex );
+
+	bool bAny = false, bFlush = false;
+	while( 1 )
+	{
+		/* Pop one line. */
+		g_Mutex->Lock();
+		if( g_iQueueUsed == 0 )
+		{
+			g_Mutex->Unlock();
+			break;
+		}
+
+		const int iToEnd = LOG_QUEUE_SIZE - g_iQueueRead;
+		if( iToEnd < (int) sizeof(QueuedLine) || ((QueuedLine *) (g_LogQueue + g_iQueueRead))->iLength == -1 )
+		{
+			g_iQueueUsed -= iToEnd;
+			g_iQueueRead = 0;
+		}
+
+		const QueuedLine *pLine = (const QueuedLine *) (g_LogQueue + g_iQueueRead);
+		const int iDest = pLine->iDest;
+		const CString str( (const char *) (pLine+1), pLine->iLength );
+		const int iSize = QueuedSize( pLine->iLength );
+		g_iQueueUsed -= iSize;
+		g_iQueueRead = (g_iQueueRead + iSize) % LOG_QUEUE_SIZE;
+		g_Mutex->Unlock();
+
+		bAny = true;
+		if( iDest & DEST_STDOUT )
+			fprintf( stdout, "%s\n", str.c_str() );
+		if( (iDest & DEST_LOG) && g_fileLog->IsOpen() )
+			g_fileLog->PutLine( str );
+		if( (iDest & DEST_INFO) && g_fileInfo->IsOpen() )
+			g_fileInfo->PutLine( str );
+		if( iDest & DEST_FLUSH )
+			bFlush = true;
+	}
+
+	if( m_iDroppedLines != g_iDroppedLinesReported )
+	{
+		const CString str = ssprintf( "(%i log lines dropped)", m_iDroppedLines - g_iDroppedLinesReported );
+		g_iDroppedLinesReported = m_iDroppedLines;
+		if( g_fileLog->IsOpen() )
+			g_fileLog->PutLine( str );
+	}
+
+	if( bFlush )
+	{
+		g_fileLog->Flush();
+		g_fileInfo->Flush();
+	}
+
+	return bAny;
+}
+
+int RageLog::WriterThread_start( void *p )
+{
+	((RageLog *) p)->WriterThread();
+	return 0;
+}
+
+void RageLog::WriterThread()
+{
+	while( !g_bWriterShutdown )
+	{
+		g_LogQueueSema->Wait();
+		Drain();
+	}
+}
 
+/* Write everything queued so far, and flush it to disk. */
 void RageLog::Flush()
 {
+	LockMut( *g_FileMutex );
+	Drain();
 	g_fileLog->Flush();
 	g_fileInfo->Flush();
 }
@@ -29,15 +29,27 @@ public:
 	void SetInfoToDisk( bool b );	// enable or disable logging info.txt to file
 	void SetFlushing( bool b );	// enable or disable flushing
 
+	/* What to do when the writer thread falls behind and the queue is full. */
+	enum OverflowPolicy { OVERFLOW_BLOCK, OVERFLOW_DROP };
+	void SetOverflowPolicy( OverflowPolicy p ) { m_OverflowPolicy = p; }
+	int GetDroppedLines() const { return m_iDroppedLines; }
+
 private:
 	bool m_bLogToDisk;
 	bool m_bInfoToDisk;
 	bool m_bFlush;
 	bool m_bShowLogOutput;
+	OverflowPolicy m_OverflowPolicy;
+	int m_iDroppedLines;
 	void Write( int, const CString &str );
 	void UpdateMappedLog();
 	void AddToInfo( const CString &buf );
 	void AddToRecentLogs( const CString &buf );
+
+	void Queue( int iDest, const CString &str );
+	bool Drain();
+	static int WriterThread_start( void *p );
+	void WriterThread();
 };
 
 extern RageLog*	LOG;	// global and accessable from anywhere in our program
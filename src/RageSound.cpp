@@ -179,6 +179,16 @@ bool RageSound::Load( const CString &sSoundFilePath, int precache )
 	m_sFilePath = sSoundFilePath;
 	decode_position = stopped_position = 0;
 
+	m_Mutex.SetName( ssprintf("RageSound (%s)", Basename(sSoundFilePath).c_str() ) );
+
+	/* If another sound already preloaded this file, share its data. */
+	if( precache )
+	{
+		Sample = SoundReader_Preload::FindCached( m_sFilePath );
+		if( Sample != NULL )
+			return true;
+	}
+
 	CString error;
 	Sample = SoundReader_FileReader::OpenFile( m_sFilePath, error );
 	if( Sample == NULL )
@@ -189,7 +199,8 @@ bool RageSound::Load( const CString &sSoundFilePath, int precache )
 		Sample = new RageSoundReader_Silence;
 	}
 
-	const int NeededRate = SOUNDMAN->GetDriverSampleRate( Sample->GetSampleRate() );
+	const int iSourceRate = Sample->GetSampleRate();
+	const int NeededRate = SOUNDMAN->GetDriverSampleRate( iSourceRate );
 	if( NeededRate != Sample->GetSampleRate() )
 	{
 		RageSoundReader_Resample_Fast *Resample = new RageSoundReader_Resample_Fast;
@@ -204,6 +215,7 @@ bool RageSound::Load( const CString &sSoundFilePath, int precache )
 		SoundReader_Preload *Preload = new SoundReader_Preload;
 		if(Preload->Open(Sample)) {
 			Sample = Preload;
+			Preload->AddToCache( m_sFilePath, iSourceRate );
 		} else {
 			/* Preload failed.  It read some data, so we need to rewind the
 			 * reader. */
@@ -212,8 +224,6 @@ bool RageSound::Load( const CString &sSoundFilePath, int precache )
 		}
 	}
 
-	m_Mutex.SetName( ssprintf("RageSound (%s)", Basename(sSoundFilePath).c_str() ) );
-
 	return true;
 }
 
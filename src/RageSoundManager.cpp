@@ -8,6 +8,7 @@
 #include "RageSound.h"
 #include "RageLog.h"
 #include "RageTimer.h"
+#include "RageSoundReader_Preload.h"
 
 #include "arch/arch.h"
 #include "arch/Sound/RageSoundDriver.h"
@@ -73,6 +74,11 @@ RageSoundManager::~RageSoundManager()
 
 	/* Don't lock while deleting the driver (the decoder thread might deadlock). */
 	delete driver;
+
+	int iBytes, iEntries, iHits, iMisses;
+	SoundReader_Preload::GetCacheStats( iBytes, iEntries, iHits, iMisses );
+	LOG->Trace( "Preloaded sound cache: %i sounds, %i bytes; %i hits, %i misses",
+		iEntries, iBytes, iHits, iMisses );
 	
 	EnableWrites(); /* for dtor */
 }
@@ -397,7 +403,8 @@ SoundMixBuffer::SoundMixBuffer()
 {
 	bufsize = used = 0;
 	mixbuf = NULL;
-	SetVolume( SOUNDMAN->GetMixVolume() );
+	/* Drivers may create mix buffers while SOUNDMAN is still being constructed. */
+	SetVolume( SOUNDMAN? SOUNDMAN->GetMixVolume(): 1.0f );
 }
 
 SoundMixBuffer::~SoundMixBuffer()
@@ -4,6 +4,7 @@
 #include "RageSoundReader_MP3.h"
 #include "RageLog.h"
 #include "RageUtil.h"
+#include "RageFileManager.h"
 
 #include <cstdio>
 #include <cerrno>
@@ -59,6 +60,32 @@ static const uint16_t g_SamplePerFrame[4][4] = {
 	{ 0, 1152, 1152, 384 }	// mpeg 1
 };
 
+/*
+ * Finding the length of a VBR file without a Xing header, or seeking far into
+ * any file, means walking every frame header.  Once we've walked the whole file,
+ * keep the total and the seek table in Cache/MP3/, so later opens of the same
+ * file (same path, size and date) know the length and can seek directly.
+ */
+#define MP3_CACHE_DIR "Cache/MP3/"
+static const int MP3_CACHE_MAGIC = 0x4B455343;	/* "CSEK" */
+static const int MP3_CACHE_VERSION = 1;
+
+struct SeekCacheHeader
+{
+	int iMagic;
+	int iVersion;
+	unsigned uSourceHash;
+	int iFilenameLength;	/* followed by the filename, then iTableFill ints */
+	int iTotalSamples;
+	int iTableStep;
+	int iTableFill;
+};
+
+static CString GetSeekCachePath( const CString &sFilename )
+{
+	return ssprintf( MP3_CACHE_DIR "%08x", GetHashForString(sFilename) );
+}
+
 static int GetID3v2TagSize( uint8_t buf[10] )
 {
 	if( (*(uint32_t*)buf & 0x00FFFFFF) == STR_ID3 )
@@ -209,8 +236,79 @@ int RageSoundReader_MP3::GetEncoderDelayAndPadding()
 	return 0;
 }
 
+void RageSoundReader_MP3::LoadSeekCache()
+{
+	seekCacheLoaded = false;
+
+	RageFile f;
+	if( !f.Open( GetSeekCachePath(filename) ) )
+		return;
+
+	SeekCacheHeader h;
+	CString sCachedFilename;
+	if( f.Read( &h, sizeof(h) ) != sizeof(h) ||
+		h.iMagic != MP3_CACHE_MAGIC || h.iVersion != MP3_CACHE_VERSION ||
+		h.uSourceHash != (unsigned) FILEMAN->GetFileHash( filename ) ||
+		h.iFilenameLength != (int) filename.size() ||
+		f.Read( sCachedFilename, h.iFilenameLength ) != h.iFilenameLength ||
+		sCachedFilename != filename ||
+		h.iTableFill < 0 || h.iTableFill > SEEK_TABLE_SIZE || h.iTableStep < 0 || h.iTableStep >= 31 )
+		return;
+
+	/* The table is empty after Open, so read straight into it; this may be on
+	 * a thread with a small stack. */
+	if( f.Read( table.data, sizeof(int) * h.iTableFill ) != (int) sizeof(int) * h.iTableFill )
+	{
+		table.fill = 0;
+		table.step = 0;
+		return;
+	}
+
+	/* A Xing header is authoritative; only fill in what we'd otherwise have to scan for. */
+	if( totalSamples <= 0 )
+		totalSamples = h.iTotalSamples;
+	table.step = h.iTableStep;
+	table.fill = h.iTableFill;
+	seekCacheLoaded = true;
+}
+
+/* Call this once the whole file has been walked, so totalSamples and the table are complete. */
+void RageSoundReader_MP3::SaveSeekCache()
+{
+	if( seekCacheLoaded || totalSamples <= 0 )
+		return;
+
+	/* After a fast CBR seek, frameNum and decodedSamples were estimated from
+	 * the frame size, ignoring padding, so totalSamples isn't exact; it came
+	 * from a full walk only if the table is still valid. */
+	if( table.step < 0 )
+		return;
+	seekCacheLoaded = true;
+
+	const CString sPath = GetSeekCachePath( filename );
+	RageFile f;
+	if( !f.Open( sPath, RageFile::WRITE ) )
+	{
+		LOG->Trace( "Couldn't write MP3 seek cache \"%s\": %s", sPath.c_str(), f.GetError().c_str() );
+		return;
+	}
+
+	SeekCacheHeader h;
+	h.iMagic = MP3_CACHE_MAGIC;
+	h.iVersion = MP3_CACHE_VERSION;
+	h.uSourceHash = FILEMAN->GetFileHash( filename );
+	h.iFilenameLength = filename.size();
+	h.iTotalSamples = totalSamples;
+	h.iTableStep = table.step;
+	h.iTableFill = table.fill;
+	f.Write( &h, sizeof(h) );
+	f.Write( filename );
+	f.Write( table.data, sizeof(int) * h.iTableFill );
+}
+
 RageSoundReader_MP3::RageSoundReader_MP3() : file( 8192 )
 {
+	seekCacheLoaded = false;
 	mixBuffer = NULL;
 	dataBuffer = NULL;
 	codecBuffer = NULL;
@@ -260,6 +358,7 @@ SoundReader_FileReader::OpenResult RageSoundReader_MP3::Open( const CString &fil
 	}
 
 	firstOffset = encoderDelay + MP3_DECODER_DELAY;
+	LoadSeekCache();
 	return OPEN_OK;
 }
 
@@ -284,6 +383,7 @@ SoundReader *RageSoundReader_MP3::Copy() const
 	ret->samplePerFrame = samplePerFrame;
 	ret->bitrate = bitrate;
 	ret->version = version;
+	ret->seekCacheLoaded = seekCacheLoaded;
 
 	if( table.step >= 0 )
 	{
@@ -455,6 +555,7 @@ int RageSoundReader_MP3::Read( char *buf, unsigned len )
 			}
 
 			totalSamples = decodedSamples;
+			SaveSeekCache();
 			break;
 		}
 
@@ -662,6 +763,7 @@ int RageSoundReader_MP3::GetLengthInternal( bool fast )
 		frameNum = origFrameNum;
 		firstOffset = origFirstOffset;
 		file.Seek( origFilePos );
+		SaveSeekCache();
 	}
 
 	return (int)((int64_t)totalSamples * 1000LL / (int64_t)SampleRate);
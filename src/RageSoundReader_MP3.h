@@ -53,6 +53,10 @@ class RageSoundReader_MP3: public SoundReader_FileReader
 	void UpdateSeekTable();
 	int DecodeFrame();
 	int Seek( int sample );
+
+	bool seekCacheLoaded;
+	void LoadSeekCache();
+	void SaveSeekCache();
 #else
     madlib_t *mad;
 
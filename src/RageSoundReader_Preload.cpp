@@ -3,6 +3,11 @@
 
 #include "global.h"
 #include "RageSoundReader_Preload.h"
+#include "RageSoundManager.h"
+#include "RageFileManager.h"
+#include "RageThreads.h"
+#include "RageLog.h"
+#include "Preference.h"
 #include "PrefsManager.h"
 
 #define samplesize (2 * channels) /* 16-bit */
@@ -10,9 +15,18 @@
 /* If a sound is smaller than this, we'll load it entirely into memory. */
 const unsigned max_prebuf_size = 1024*256;
 
+/* How much preloaded sound data the shared cache may keep for sounds that
+ * nobody is using; 0 disables the cache. */
+static Preference<int> PRELOAD_CACHE_KB( Options, "PreloadedSoundCacheKB", 4*1024 );
+
+unsigned SoundReader_Preload::stored_samplesize() const
+{
+	return m_bMonoCollapsed? 2:samplesize;
+}
+
 int SoundReader_Preload::total_samples() const
 {
-	return buf.get().size() / samplesize;
+	return buf.get().size() / stored_samplesize();
 }
 
 bool SoundReader_Preload::Open(SoundReader *source)
@@ -20,6 +34,7 @@ bool SoundReader_Preload::Open(SoundReader *source)
 	ASSERT(source);
 	samplerate = source->GetSampleRate();
 	channels = source->GetNumChannels();
+	m_bMonoCollapsed = false;
 	
 	/* Check the length, and see if we think it'll fit in the buffer. */
 	int len = source->GetLength_Fast();
@@ -53,6 +68,26 @@ bool SoundReader_Preload::Open(SoundReader *source)
 			return false; /* too big */
 	}
 
+	/* Many sounds are mono files decoded to stereo.  If the channels are
+	 * identical, keep one; this halves what we (and the cache) hold. */
+	if( channels == 2 )
+	{
+		string &data = buf.get_owned();
+		const unsigned frames = data.size() / 4;
+		unsigned i;
+		for( i = 0; i < frames; ++i )
+			if( memcmp(&data[i*4], &data[i*4+2], 2) )
+				break;
+
+		if( i == frames )
+		{
+			for( i = 0; i < frames; ++i )
+				memmove( &data[i*2], &data[i*4], 2 );
+			data.resize( frames*2 );
+			m_bMonoCollapsed = true;
+		}
+	}
+
 	position = 0;
 	delete source;
 	return true;
@@ -73,9 +108,10 @@ int SoundReader_Preload::SetPosition_Accurate(int ms)
 	const int sample = int((ms / 1000.0f) * samplerate);
 	position = sample * samplesize;
 
-	if(position >= int(buf.get().size()))
+	const int total_bytes = total_samples() * samplesize;
+	if(position >= total_bytes)
 	{
-		position = buf.get().size();
+		position = total_bytes;
 		return 0;
 	}
 
@@ -89,10 +125,22 @@ int SoundReader_Preload::SetPosition_Fast(int ms)
 
 int SoundReader_Preload::Read(char *buffer, unsigned len)
 {
-	const unsigned bytes_avail = buf.get().size() - position;
+	const unsigned bytes_avail = total_samples() * samplesize - position;
 
 	len = min(len, bytes_avail);
-	memcpy(buffer, buf.get().data()+position, len);
+	if( !m_bMonoCollapsed )
+	{
+		memcpy(buffer, buf.get().data()+position, len);
+	}
+	else
+	{
+		/* Output 16-bit sample n (either channel) is stored sample n/2. */
+		len &= ~1;
+		const char *data = buf.get().data();
+		const unsigned first = position / 2;
+		for( unsigned i = 0; i < len/2; ++i )
+			memcpy( buffer + i*2, data + ((first+i)/2)*2, 2 );
+	}
 	position += len;
 	
 	return len;
@@ -103,6 +151,117 @@ SoundReader *SoundReader_Preload::Copy() const
 	return new SoundReader_Preload(*this);
 }
 
+/*
+ * The shared cache.  Each entry holds a reference to the decoded data, so
+ * sounds loaded from it share one buffer.  Only the cache's own references
+ * count against the budget; when it's exceeded, the least recently used
+ * entries are dropped, and their data is freed once the last sound using it
+ * goes away.
+ */
+struct CachedSound
+{
+	rc_string buf;
+	int iFileHash;
+	int iSourceRate;	/* rate of the file; samplerate may be resampled */
+	int samplerate;
+	unsigned channels;
+	bool m_bMonoCollapsed;
+	unsigned uLastUsed;
+};
+
+static RageMutex g_CacheLock( "PreloadCache" );
+static map<CString, CachedSound> g_Cache;
+static int g_iCacheBytes = 0;
+static unsigned g_uCacheTick = 0;
+static int g_iCacheHits = 0, g_iCacheMisses = 0;
+
+static void RemoveCached( map<CString, CachedSound>::iterator it )
+{
+	g_iCacheBytes -= it->second.buf.get().size();
+	g_Cache.erase( it );
+}
+
+SoundReader_Preload *SoundReader_Preload::FindCached( const CString &sPath )
+{
+	if( PRELOAD_CACHE_KB <= 0 )
+		return NULL;
+
+	LockMut( g_CacheLock );
+	map<CString, CachedSound>::iterator it = g_Cache.find( sPath );
+	if( it == g_Cache.end() )
+	{
+		++g_iCacheMisses;
+		return NULL;
+	}
+
+	CachedSound &cs = it->second;
+	if( cs.iFileHash != FILEMAN->GetFileHash(sPath) ||
+		SOUNDMAN->GetDriverSampleRate(cs.iSourceRate) != cs.samplerate )
+	{
+		RemoveCached( it );
+		++g_iCacheMisses;
+		return NULL;
+	}
+
+	++g_iCacheHits;
+	cs.uLastUsed = ++g_uCacheTick;
+
+	SoundReader_Preload *pRet = new SoundReader_Preload;
+	pRet->buf = cs.buf;
+	pRet->samplerate = cs.samplerate;
+	pRet->channels = cs.channels;
+	pRet->m_bMonoCollapsed = cs.m_bMonoCollapsed;
+	return pRet;
+}
+
+void SoundReader_Preload::AddToCache( const CString &sPath, int iSourceRate ) const
+{
+	const int iBudget = PRELOAD_CACHE_KB * 1024;
+	if( iBudget <= 0 || (int) buf.get().size() > iBudget )
+		return;
+
+	LockMut( g_CacheLock );
+	map<CString, CachedSound>::iterator it = g_Cache.find( sPath );
+	if( it != g_Cache.end() )
+		RemoveCached( it );
+
+	CachedSound cs;
+	cs.buf = buf;
+	cs.iFileHash = FILEMAN->GetFileHash( sPath );
+	cs.iSourceRate = iSourceRate;
+	cs.samplerate = samplerate;
+	cs.channels = channels;
+	cs.m_bMonoCollapsed = m_bMonoCollapsed;
+	cs.uLastUsed = ++g_uCacheTick;
+	g_Cache[sPath] = cs;
+	g_iCacheBytes += buf.get().size();
+
+	while( g_iCacheBytes > iBudget )
+	{
+		map<CString, CachedSound>::iterator oldest = g_Cache.begin();
+		for( it = g_Cache.begin(); it != g_Cache.end(); ++it )
+			if( it->second.uLastUsed < oldest->second.uLastUsed )
+				oldest = it;
+		RemoveCached( oldest );
+	}
+}
+
+void SoundReader_Preload::GetCacheStats( int &iBytes, int &iEntries, int &iHits, int &iMisses )
+{
+	LockMut( g_CacheLock );
+	iBytes = g_iCacheBytes;
+	iEntries = g_Cache.size();
+	iHits = g_iCacheHits;
+	iMisses = g_iCacheMisses;
+}
+
+/* One lock for every rc_string count; they change only on copy and free. */
+static RageMutex &GetRefCountLock()
+{
+	static RageMutex lock( "rc_string" );
+	return lock;
+}
+
 rc_string::rc_string()
 {
 	buf = new string;
@@ -111,23 +270,51 @@ rc_string::rc_string()
 
 rc_string::rc_string(const rc_string &rhs)
 {
+	LockMut( GetRefCountLock() );
 	buf = rhs.buf;
 	cnt = rhs.cnt;
 	(*cnt)++;
 }
 
-rc_string::~rc_string()
+rc_string &rc_string::operator=(const rc_string &rhs)
 {
-	(*cnt)--;
-	if(!*cnt)
+	if( rhs.buf == buf )
+		return *this;
+
+	{
+		LockMut( GetRefCountLock() );
+		(*rhs.cnt)++;
+	}
+	release();
+	buf = rhs.buf;
+	cnt = rhs.cnt;
+	return *this;
+}
+
+void rc_string::release()
+{
+	bool bLast;
+	{
+		LockMut( GetRefCountLock() );
+		(*cnt)--;
+		bLast = !*cnt;
+	}
+
+	if( bLast )
 	{
 		delete buf;
 		delete cnt;
 	}
 }
 
+rc_string::~rc_string()
+{
+	release();
+}
+
 string &rc_string::get_owned()
 {
+	LockMut( GetRefCountLock() );
 	if(*cnt != 1)
 	{
 		(*cnt)--;
@@ -8,15 +8,20 @@
 #include "RageSoundReader.h"
 
 /* Trivial wrapper to refcount strings, since std::string is not always
- * refcounted.  Without this, Copy() is very slow. */
+ * refcounted.  Without this, Copy() is very slow.  Copies may live in
+ * different threads (sounds are copied and freed by the mixer, and the
+ * preload cache holds its own), so the count is locked. */
 class rc_string
 {
 	mutable string *buf;
 	mutable int *cnt;
 
+	void release();
+
 public:
 	rc_string();
 	rc_string(const rc_string &rhs);
+	rc_string &operator=(const rc_string &rhs);
 	~rc_string();
 	string &get_owned();
 	const string &get() const;
@@ -29,6 +34,10 @@ class SoundReader_Preload: public SoundReader
 	/* Bytes: */
 	int position;
 
+	/* If both channels were identical, buf holds only one; Read duplicates it. */
+	bool m_bMonoCollapsed;
+	unsigned stored_samplesize() const;
+
 	int total_samples() const;
 
 	int samplerate;
@@ -39,6 +48,15 @@ public:
 	/* Return true if the sound has been preloaded, in which case source will
 	 * be deleted.  Otherwise, return false. */
 	bool Open(SoundReader *source);
+
+	/* Preloaded sounds are shared by path in a process-wide cache, so loading
+	 * the same sound twice (menu sounds, keysounds) decodes and stores it
+	 * once.  FindCached returns NULL if sPath isn't cached, or changed on disk,
+	 * or was cached for a different output rate. */
+	static SoundReader_Preload *FindCached( const CString &sPath );
+	void AddToCache( const CString &sPath, int iSourceRate ) const;
+	static void GetCacheStats( int &iBytes, int &iEntries, int &iHits, int &iMisses );
+
 	int GetLength() const;
 	int GetLength_Fast() const;
 	int SetPosition_Accurate(int ms);
@@ -49,6 +67,7 @@ public:
 	bool IsStreamingFromDisk() const { return false; }
 
 	SoundReader *Copy() const;
+	SoundReader_Preload() { position = 0; m_bMonoCollapsed = false; }
 	~SoundReader_Preload() { }
 };
 
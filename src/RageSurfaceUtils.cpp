@@ -715,6 +715,11 @@ bool RageSurfaceUtils::SaveSurface( const RageSurface *img, CString file )
 	if( !f.Open( file, RageFile::WRITE ) )
 		return false;
 
+	return SaveSurface( img, f );
+}
+
+bool RageSurfaceUtils::SaveSurface( const RageSurface *img, RageFile &f )
+{
 	SurfaceHeader h;
 	memset( &h, 0, sizeof(h) );
 
@@ -744,8 +749,13 @@ RageSurface *RageSurfaceUtils::LoadSurface( CString file )
 {
 	RageFile f;
 	if( !f.Open( file ) )
-		return false;
+		return NULL;
+
+	return LoadSurface( f );
+}
 
+RageSurface *RageSurfaceUtils::LoadSurface( RageFile &f )
+{
 	SurfaceHeader h;
 	if( f.Read( &h, sizeof(h) ) != sizeof(h) )
 		return NULL;
@@ -771,7 +781,7 @@ RageSurface *RageSurfaceUtils::LoadSurface( CString file )
 	if( h.pitch != img->pitch )
 	{
 		LOG->Trace( "Error loading \"%s\": expected pitch %i, got %i (%ibpp, %i width)",
-				file.c_str(), h.pitch, img->pitch, h.bpp, h.width );
+				f.GetRealPath().c_str(), h.pitch, img->pitch, h.bpp, h.width );
 		delete img;
 		return NULL;
 	}
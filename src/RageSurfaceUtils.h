@@ -7,6 +7,7 @@ struct RageSurfaceColor;
 struct RageSurfacePalette;
 struct RageSurfaceFormat;
 struct RageSurface;
+class RageFile;
 
 namespace RageSurfaceUtils
 {
@@ -51,6 +52,9 @@ namespace RageSurfaceUtils
 
 	bool SaveSurface( const RageSurface *img, CString file );
 	RageSurface *LoadSurface( CString file );
+	/* Write or read a surface at the current position of an open file. */
+	bool SaveSurface( const RageSurface *img, RageFile &f );
+	RageSurface *LoadSurface( RageFile &f );
 
 	/* Quickly palettize to an gray/alpha texture. */
 	RageSurface *PalettizeToGrayscale( const RageSurface *src_surf, int GrayBits, int AlphaBits );
@@ -13,6 +13,8 @@ RageTexture::RageTexture( const RageTextureID &name ):
 
 	m_iRefCount = 1;
 	m_bWasUsed = false;
+	m_bRegistered = false;
+	m_uLastUsed = 0;
 
 //	SetActualID();
 	m_iSourceWidth = m_iSourceHeight = 0;
@@ -25,6 +25,9 @@ public:
 	virtual bool IsPlaying() const { return false; }
 	void SetLooping(bool looping) { }
 
+	/* Approximate memory used by the texture, for RageTextureManager's budget. */
+	virtual int GetTextureBytes() const { return m_iTextureWidth * m_iTextureHeight * 4; }
+
 	int GetSourceWidth() const	{return m_iSourceWidth;}
 	int GetSourceHeight() const {return m_iSourceHeight;}
 	int GetTextureWidth() const {return m_iTextureWidth;}
@@ -55,6 +58,8 @@ public:
 	RageTextureID::TexPolicy &GetPolicy() { return m_ID.Policy; }
 	int		m_iRefCount;
 	bool	m_bWasUsed;
+	bool	m_bRegistered;	/* given to RegisterTexture; can't be reloaded from its ID */
+	unsigned m_uLastUsed;	/* when the texture was last loaded or released */
 
 	/* The ID that we were asked to load: */
 	const RageTextureID &GetID() const { return m_ID; }
@@ -0,0 +1,133 @@
+#include "global.h"
+#include "RageTextureCache.h"
+#include "RageTextureID.h"
+#include "RageDisplay.h"
+#include "RageSurface.h"
+#include "RageSurfaceUtils.h"
+#include "RageFile.h"
+#include "RageFileManager.h"
+#include "RageUtil.h"
+#include "RageLog.h"
+#include "Preference.h"
+
+/*
+ * Each texture is cached in its own file, named by a hash of everything that
+ * affects the converted image: the texture ID and what the display supports.
+ * The file starts with that full description and the source file's hash (size
+ * and date), so hash collisions and edited images are both misses.  A hit is
+ * a single sequential read, with no decoding, resizing or palettizing.
+ *
+ * Cache files are never deleted here; SongCacheIndex empties Cache/ when the
+ * cache version changes.
+ */
+static Preference<bool> TEXTURE_CACHE( Options, "TextureCache", true );
+
+#define TEXTURE_CACHE_DIR "Cache/Textures/"
+static const int TEXTURE_CACHE_MAGIC = 0x58455443;	/* "CTEX" */
+static const int TEXTURE_CACHE_VERSION = 1;
+
+struct TextureCacheHeader
+{
+	int iMagic;
+	int iVersion;
+	unsigned uSourceHash;
+	int iDescriptionLength;	/* followed by the description, then TextureInfo, then the surface */
+};
+
+static RageTextureCache::Stats g_Stats;
+
+static CString GetDescription( const RageTextureID &ID )
+{
+	CString sRet = ssprintf( "%s|%i|%i|%i|%i|%i|%i|%i|%i|%s|%i|",
+		ID.filename.c_str(), ID.iMaxSize, ID.bMipMaps, ID.iAlphaBits, ID.iGrayscaleBits,
+		ID.iColorDepth, ID.bDither, ID.bStretch, ID.bHotPinkColorKey,
+		ID.AdditionalTextureHints.c_str(), DISPLAY->GetMaxTextureSize() );
+
+	for( int i = 0; i < RageDisplay::NUM_PIX_FORMATS; ++i )
+		sRet += DISPLAY->SupportsTextureFormat( (RageDisplay::PixelFormat) i )? '1':'0';
+
+	return sRet;
+}
+
+static CString GetCachePath( const CString &sDescription )
+{
+	return ssprintf( TEXTURE_CACHE_DIR "%08x", GetHashForString(sDescription) );
+}
+
+RageSurface *RageTextureCache::Load( const RageTextureID &ID, TextureInfo &info )
+{
+	if( !TEXTURE_CACHE )
+		return NULL;
+
+	const CString sDescription = GetDescription( ID );
+
+	RageFile f;
+	if( !f.Open( GetCachePath(sDescription) ) )
+	{
+		++g_Stats.iMisses;
+		return NULL;
+	}
+
+	TextureCacheHeader h;
+	CString sCachedDescription;
+	if( f.Read( &h, sizeof(h) ) != sizeof(h) ||
+		h.iMagic != TEXTURE_CACHE_MAGIC || h.iVersion != TEXTURE_CACHE_VERSION ||
+		h.uSourceHash != (unsigned) FILEMAN->GetFileHash( ID.filename ) ||
+		h.iDescriptionLength != (int) sDescription.size() ||
+		f.Read( sCachedDescription, h.iDescriptionLength ) != h.iDescriptionLength ||
+		sCachedDescription != sDescription ||
+		f.Read( &info, sizeof(info) ) != sizeof(info) )
+	{
+		++g_Stats.iMisses;
+		return NULL;
+	}
+
+	RageSurface *img = RageSurfaceUtils::LoadSurface( f );
+	if( img == NULL )
+	{
+		++g_Stats.iMisses;
+		return NULL;
+	}
+
+	++g_Stats.iHits;
+	g_Stats.iBytesRead += f.Tell();
+	return img;
+}
+
+void RageTextureCache::Save( const RageTextureID &ID, const TextureInfo &info, const RageSurface *img )
+{
+	if( !TEXTURE_CACHE )
+		return;
+
+	const CString sDescription = GetDescription( ID );
+	const CString sPath = GetCachePath( sDescription );
+
+	RageFile f;
+	if( !f.Open( sPath, RageFile::WRITE ) )
+	{
+		LOG->Trace( "Couldn't write texture cache \"%s\": %s", sPath.c_str(), f.GetError().c_str() );
+		return;
+	}
+
+	TextureCacheHeader h;
+	h.iMagic = TEXTURE_CACHE_MAGIC;
+	h.iVersion = TEXTURE_CACHE_VERSION;
+	h.uSourceHash = FILEMAN->GetFileHash( ID.filename );
+	h.iDescriptionLength = sDescription.size();
+	f.Write( &h, sizeof(h) );
+	f.Write( sDescription );
+	f.Write( &info, sizeof(info) );
+	RageSurfaceUtils::SaveSurface( img, f );
+
+	++g_Stats.iWrites;
+}
+
+const RageTextureCache::Stats &RageTextureCache::GetStats()
+{
+	return g_Stats;
+}
+
+void RageTextureCache::ResetStats()
+{
+	memset( &g_Stats, 0, sizeof(g_Stats) );
+}
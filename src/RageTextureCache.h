@@ -0,0 +1,41 @@
+/* RageTextureCache - Keeps textures on disk in the form they're uploaded in, so loading them again skips decoding and conversion. */
+
+#ifndef RAGE_TEXTURE_CACHE_H
+#define RAGE_TEXTURE_CACHE_H
+
+struct RageSurface;
+struct RageTextureID;
+
+namespace RageTextureCache
+{
+	/* What RageBitmapTexture worked out while converting the image, besides
+	 * the pixels themselves. */
+	struct TextureInfo
+	{
+		int iSourceWidth, iSourceHeight;
+		int iImageWidth, iImageHeight;
+		int iTextureWidth, iTextureHeight;
+		int iPixelFormat;	/* RageDisplay::PixelFormat */
+		int iAlphaBits;
+		int bStretch, bDither, bMipMaps;
+	};
+
+	/* Return the converted surface cached for ID, or NULL if there isn't one
+	 * or the source file has changed since it was written. */
+	RageSurface *Load( const RageTextureID &ID, TextureInfo &info );
+
+	/* Cache img, the final surface for ID, as it will be passed to CreateTexture. */
+	void Save( const RageTextureID &ID, const TextureInfo &info, const RageSurface *img );
+
+	struct Stats
+	{
+		int iHits;
+		int iMisses;	/* not cached, or cached for an older source file */
+		int iWrites;
+		int iBytesRead;
+	};
+	const Stats &GetStats();
+	void ResetStats();
+};
+
+#endif
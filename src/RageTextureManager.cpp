@@ -24,6 +24,11 @@
  * Permanent: Never delete the texture.
  * 			This is only used for BannerCache=2 mode.
  *
+ * Textures that are kept around after their last reference goes away count
+ * against TextureMemoryBudgetKB.  When the textures we hold go over it, the
+ * least recently used unreferenced ones are freed, whatever their policy
+ * (except PERMANENT); they'll simply be reloaded if they're needed again.
+ *
  * Policy priority is in the order PERMANENT, CACHED, VOLATILE, DEFAULT.  Textures that
  * are loaded DEFAULT can be changed to VOLATILE and CACHED; VOLATILE textures can only
  * be changed to CACHED.  CACHED flags are normally set explicitly on a per-texture
@@ -39,13 +44,21 @@
 #include "RageLog.h"
 #include "RageException.h"
 #include "RageDisplay.h"
+#include "RageTextureCache.h"
+#include "Preference.h"
 
 RageTextureManager*		TEXTUREMAN		= NULL;
 
+/* 0 for no limit. */
+static Preference<int> TEXTURE_MEMORY_BUDGET_KB( Options, "TextureMemoryBudgetKB", 16*1024 );
+
 RageTextureManager::RageTextureManager()
 {
 	m_iNoWarnAboutOddDimensions = 0;
 	m_TexturePolicy = RageTextureID::TEX_DEFAULT;
+	m_iResidentBytes = 0;
+	m_uUseTick = 0;
+	m_iHits = m_iMisses = m_iEvictions = 0;
 }
 
 RageTextureManager::~RageTextureManager()
@@ -98,7 +111,17 @@ void RageTextureManager::RegisterTexture( RageTextureID ID, RageTexture *pTextur
 		/* Oops, found the texture. */
 		RageException::Throw("Custom texture \"%s\" already registered!", ID.filename.c_str());
 
+	pTexture->m_bRegistered = true;
+	AddTexture( ID, pTexture );
+}
+
+void RageTextureManager::AddTexture( const RageTextureID &ID, RageTexture *pTexture )
+{
 	m_mapPathToTexture[ID] = pTexture;
+	pTexture->m_uLastUsed = ++m_uUseTick;
+	m_iResidentBytes += pTexture->GetTextureBytes();
+
+	EvictToBudget( pTexture );
 }
 
 // Load and unload textures from disk.
@@ -115,9 +138,16 @@ RageTexture* RageTextureManager::LoadTextureInternal( RageTextureID ID )
 	{
 		/* Found the texture.  Just increase the refcount and return it. */
 		p->second->m_iRefCount++;
+		p->second->m_uLastUsed = ++m_uUseTick;
+		++m_iHits;
 		return p->second;
 	}
 
+	++m_iMisses;
+
+	/* If we're still over budget from before, make room before we allocate. */
+	EvictToBudget( NULL );
+
 	// The texture is not already loaded.  Load it.
 	RageTexture* pTexture;
 #ifdef SUPPORT_MOVIE
@@ -129,7 +159,7 @@ RageTexture* RageTextureManager::LoadTextureInternal( RageTextureID ID )
 #endif
 		pTexture = new RageBitmapTexture( ID );
 
-	m_mapPathToTexture[ID] = pTexture;
+	AddTexture( ID, pTexture );
 
 	return pTexture;
 }
@@ -175,6 +205,8 @@ void RageTextureManager::UnloadTexture( RageTexture *t )
 	if( t->m_iRefCount )
 		return; /* Can't unload textures that are still referenced. */
 
+	t->m_uLastUsed = ++m_uUseTick;
+
 	if( t->GetPolicy() == RageTextureID::TEX_PERMANENT )
 		return; /* Never unload TEX_PERMANENT textures. */
 	bool bDeleteThis = false;
@@ -198,6 +230,40 @@ void RageTextureManager::UnloadTexture( RageTexture *t )
 	
 	if( bDeleteThis )
 		DeleteTexture( t );
+	else
+		EvictToBudget( t );
+}
+
+void RageTextureManager::EvictToBudget( const RageTexture *pKeep )
+{
+	const int iBudgetBytes = TEXTURE_MEMORY_BUDGET_KB * 1024;
+	if( iBudgetBytes <= 0 )
+		return;
+
+	while( m_iResidentBytes > iBudgetBytes )
+	{
+		RageTexture *pOldest = NULL;
+		for( std::map<RageTextureID, RageTexture*>::iterator i = m_mapPathToTexture.begin();
+			i != m_mapPathToTexture.end(); ++i )
+		{
+			RageTexture *t = i->second;
+			if( t == pKeep || t->m_iRefCount || t->GetPolicy() == RageTextureID::TEX_PERMANENT )
+				continue;
+			/* A volatile texture that hasn't been used yet is about to be (eg. a
+			 * banner just cached by BannerCache), and a registered texture would be
+			 * reloaded as a plain bitmap, if at all. */
+			if( (t->GetPolicy() == RageTextureID::TEX_VOLATILE && !t->m_bWasUsed) || t->m_bRegistered )
+				continue;
+			if( pOldest == NULL || t->m_uLastUsed < pOldest->m_uLastUsed )
+				pOldest = t;
+		}
+
+		if( pOldest == NULL )
+			return;	/* everything left is in use */
+
+		++m_iEvictions;
+		DeleteTexture( pOldest );
+	}
 }
 
 void RageTextureManager::DeleteTexture( RageTexture *t )
@@ -210,6 +276,7 @@ void RageTextureManager::DeleteTexture( RageTexture *t )
 	{
 		if( i->second == t )
 		{
+			m_iResidentBytes -= t->GetTextureBytes();
 			m_mapPathToTexture.erase( i );	// remove map entry
 			SAFE_DELETE( t );	// free the texture
 			return;
@@ -235,7 +302,7 @@ void RageTextureManager::GarbageCollect( GCType type )
 		if( t->m_iRefCount )
 			continue; /* Can't unload textures that are still referenced. */
 		if( t->GetPolicy() == RageTextureID::TEX_PERMANENT )
-			return; /* Never unload TEX_PERMANENT textures. */
+			continue; /* Never unload TEX_PERMANENT textures. */
 
 		bool bDeleteThis = false;
 		if( type==screen_changed )
@@ -278,10 +345,13 @@ void RageTextureManager::ReloadAll()
 	 * ton of cached data that we're not necessarily going to use. */
 	DoDelayedDelete();
 
+	/* Textures may come back a different size. */
+	m_iResidentBytes = 0;
 	for( std::map<RageTextureID, RageTexture*>::iterator i = m_mapPathToTexture.begin();
 		i != m_mapPathToTexture.end(); ++i)
 	{
 		i->second->Reload();
+		m_iResidentBytes += i->second->GetTextureBytes();
 	}
 
 	TEXTUREMAN->EnableOddDimensionWarning();
@@ -340,6 +410,12 @@ void RageTextureManager::DiagnosticOutput() const
 		total += tex->GetTextureHeight() * tex->GetTextureWidth();
 	}
 	LOG->Trace("total %3i texels", total);
+	LOG->Trace( "%i bytes resident (budget %i KB); %i hits, %i misses, %i evictions",
+		m_iResidentBytes, (int) TEXTURE_MEMORY_BUDGET_KB, m_iHits, m_iMisses, m_iEvictions );
+
+	const RageTextureCache::Stats &stats = RageTextureCache::GetStats();
+	LOG->Trace( "texture cache: %i hits, %i misses, %i writes, %i bytes read",
+		stats.iHits, stats.iMisses, stats.iWrites, stats.iBytesRead );
 }
 
 /*
@@ -96,9 +96,19 @@ protected:
 
 	RageTexture* LoadTextureInternal( RageTextureID ID );
 
+	/* Free unreferenced textures, least recently used first, until we're within
+	 * the texture memory budget.  pKeep, volatile textures that haven't been
+	 * used yet and registered textures are never freed. */
+	void EvictToBudget( const RageTexture *pKeep );
+	void AddTexture( const RageTextureID &ID, RageTexture *pTexture );
+
 	std::map<RageTextureID, RageTexture*> m_mapPathToTexture;
 	int m_iNoWarnAboutOddDimensions;
 	RageTextureID::TexPolicy m_TexturePolicy;
+
+	int m_iResidentBytes;	/* sum of GetTextureBytes() of every texture in m_mapPathToTexture */
+	unsigned m_uUseTick;
+	int m_iHits, m_iMisses, m_iEvictions;
 };
 
 extern RageTextureManager*	TEXTUREMAN;	// global and accessable from anywhere in our program
@@ -444,18 +444,23 @@ unsigned int GetHashForString ( const CString &s )
 	static bool initted = false;
 	if(!initted)
 	{
-		initted = true;
 		const unsigned POLY = 0xEDB88320;
 
+		/* Songs may be hashed from more than one thread.  Only ever store
+		 * final values in tab, and set initted last, so a thread racing
+		 * with us never sees a partial entry. */
 		for(int i = 0; i < 256; ++i)
 		{
-			tab[i] = i;
+			unsigned entry = i;
 			for(int j = 0; j < 8; ++j)
 			{
-				if(tab[i] & 1) tab[i] = (tab[i] >> 1) ^ POLY;
-				else tab[i] >>= 1;
+				if(entry & 1) entry = (entry >> 1) ^ POLY;
+				else entry >>= 1;
 			}
+			tab[i] = entry;
 		}
+
+		initted = true;
 	}
 
 	unsigned crc = 0;
@@ -1656,6 +1656,7 @@ void ScreenGameplay::Input( const DeviceInput& DeviceI, const InputEventType typ
 				BPMSegment& seg = GAMESTATE->m_pCurSong->GetBPMSegmentAtBeat( GAMESTATE->m_fSongBeat );
 
 				seg.m_fBPM += fOffsetDelta;
+				GAMESTATE->m_pCurSong->m_Timing.UpdateBreakpoints();
 
 				m_textDebug.SetText( ssprintf("Cur BPM = %.2f", seg.m_fBPM) );
 				m_textDebug.StopTweening();
@@ -24,6 +24,7 @@
 #include "NoteDataUtil.h"
 #include "ProfileManager.h"
 #include "Foreach.h"
+#include "SongUtil.h"
 
 #include "NotesLoaderSM.h"
 #include "NotesLoaderDWI.h"
@@ -33,6 +34,7 @@
 #include "NotesWriterSM.h"
 
 #include "LyricsLoader.h"
+#include "RageThreads.h"
 
 #include <set>
 
@@ -80,6 +82,8 @@ Song::~Song()
 	FOREACH( Steps*, m_vpSteps, s )
 		SAFE_DELETE( *s );
 	m_vpSteps.clear();
+
+	SongUtil::InvalidateSortKeys( this );
 	
 	// It's the responsibility of the owner of this Song to make sure
 	// that all pointers to this Song and its Steps are invalidated.
@@ -97,6 +101,8 @@ void Song::Reset()
 	Song empty;
 	*this = empty;
 
+	SongUtil::InvalidateSortKeys( this );
+
 	// It's the responsibility of the owner of this Song to make sure
 	// that all pointers to this Song and its Steps are invalidated.
 }
@@ -184,10 +190,6 @@ NotesLoader *Song::MakeLoader( const CString &sDir ) const
 	return NULL;
 }
 
-/* Hack: This should be a parameter to TidyUpData, but I don't want to
- * pull in <set> into Song.h, which is heavily used. */
-static set<istring> BlacklistedImages;
-
 /*
  * If PREFSMAN->m_bFastLoad is true, always load from cache if possible. Don't read
  * the contents of sDir if we can avoid it.  That means we can't call HasMusic(),
@@ -248,7 +250,6 @@ bool Song::LoadFromSongDir( const CString &sDir )
 		}
 
 		bool success = ld->LoadFromDir( m_sSongDir, *this );
-		BlacklistedImages = ld->GetBlacklistedImages();
 
 		if(!success)
 		{
@@ -256,7 +257,7 @@ bool Song::LoadFromSongDir( const CString &sDir )
 			return false;
 		}
 
-		TidyUpData();
+		TidyUpData( ld );
 		ld->TidyUpData( *this, false );
 
 		delete ld;
@@ -420,7 +421,9 @@ void FixupPath( CString &path, const CString &sSongPath )
 }
 
 /* Songs in BlacklistImages will never be autodetected as song images. */
-void Song::TidyUpData()
+/* pLoader is the loader that loaded the song, if any; images it blacklists
+ * won't be used as banners and backgrounds. */
+void Song::TidyUpData( const NotesLoader *pLoader )
 {
 	/* We need to do this before calling any of HasMusic, HasHasCDTitle, etc. */
 	ASSERT_M( m_sSongDir.Left(3) != "../", m_sSongDir ); /* meaningless */
@@ -524,6 +527,7 @@ void Song::TidyUpData()
 	/* Make sure the first BPM segment starts at beat 0. */
 	if( m_Timing.m_BPMSegments[0].m_fStartBeat != 0 )
 		m_Timing.m_BPMSegments[0].m_fStartBeat = 0;
+	m_Timing.UpdateBreakpoints();
 
 
 	/* Only automatically set the sample time if there was no sample length
@@ -634,7 +638,7 @@ void Song::TidyUpData()
 		const CString &sImage = arrayImages[i];
 
 		// ignore DWI "-char" graphics
-		if( BlacklistedImages.find( sImage.c_str() ) != BlacklistedImages.end() )
+		if( pLoader != NULL && pLoader->GetBlacklistedImages().count(sImage.c_str()) )
 			continue;	// skip
 		
 		// Skip any image that we've already classified
@@ -777,20 +781,41 @@ void Song::TidyUpData()
 			}
 		}
 	}
+
+	/* Titles and BPMs may have changed. */
+	SongUtil::InvalidateSortKeys( this );
+}
+
+/* Song loader threads share one TitleSubst.  It's created by InitTitleSubst on the
+ * main thread before they start; Subst isn't thread-safe (FontCharAliases
+ * initializes itself lazily), so it's serialized. */
+static TitleSubst *g_pTitleSubst = NULL;
+static RageMutex g_TitleSubstLock( "TitleSubst" );
+
+void Song::InitTitleSubst()
+{
+	LockMut( g_TitleSubstLock );
+	if( g_pTitleSubst == NULL )
+		g_pTitleSubst = new TitleSubst( "songs" );
 }
 
 void Song::TranslateTitles()
 {
-	static TitleSubst tsub("songs");
+	InitTitleSubst();
 
 	TitleFields title;
 	title.LoadFromStrings( m_sMainTitle, m_sSubTitle, m_sArtist, m_sMainTitleTranslit, m_sSubTitleTranslit, m_sArtistTranslit );
-	tsub.Subst( title );
+	{
+		LockMut( g_TitleSubstLock );
+		g_pTitleSubst->Subst( title );
+	}
 	title.SaveToStrings( m_sMainTitle, m_sSubTitle, m_sArtist, m_sMainTitleTranslit, m_sSubTitleTranslit, m_sArtistTranslit );
 }
 
 void Song::ReCalculateRadarValuesAndLastBeat()
 {
+	SongUtil::InvalidateSortKeys( this );
+
 	for( unsigned i=0; i<m_vpSteps.size(); i++ )
 	{
 		/* If it's autogen, radar vals and first/last beat will come from the parent. */
@@ -1269,10 +1294,13 @@ void Song::AddSteps( Steps* pSteps )
 	m_vpSteps.push_back( pSteps );
 	ASSERT_M( pSteps->m_StepsType < NUM_STEPS_TYPES, ssprintf("%i", pSteps->m_StepsType) );
 	m_vpStepsByType[pSteps->m_StepsType].push_back( pSteps );
+	SongUtil::InvalidateSortKeys( this );
 }
 
 void Song::RemoveSteps( const Steps* pSteps )
 {
+	SongUtil::InvalidateSortKeys( this );
+
 	// Avoid any stale Note::parent pointers by removing all AutoGen'd Steps,
 	// then adding them again.
 
@@ -64,9 +64,10 @@ public:
 
 	bool LoadFromSongDir( const CString &sDir );
 
-	void TidyUpData();	// call after loading to clean up invalid data
+	void TidyUpData( const NotesLoader *pLoader = NULL );	// call after loading to clean up invalid data
 	void ReCalculateRadarValuesAndLastBeat();	// called by TidyUpData, and after saving
 	void TranslateTitles();	// called by TidyUpData
+	static void InitTitleSubst();	// call before loading songs on several threads
 
 	void SaveToSMFile( const CString &sPath, bool bSavingCache );
 	void Save();	// saves SM and DWI
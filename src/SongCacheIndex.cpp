@@ -4,6 +4,7 @@
 #include "RageLog.h"
 #include "RageUtil.h"
 #include "RageFileManager.h"
+#include "RageFile.h"
 #include "song.h"
 
 /*
@@ -26,17 +27,45 @@
 #define CACHE_DIR "Cache/"
 #define CACHE_INDEX CACHE_DIR "index.cache"
 
+/*
+ * The index is a small binary file, loaded once at startup and held in memory.
+ * AddCacheIndex only touches the in-memory copy; the file is rewritten by
+ * SaveCacheIndex, which SongManager calls once after loading songs.  While
+ * building a cold cache, we also flush every CACHE_INDEX_FLUSH_INTERVAL new
+ * entries, so a crash part way through doesn't throw away the whole load.
+ */
+static const int CACHE_INDEX_MAGIC = 0x58444943;	/* "CIDX" */
+static const int CACHE_INDEX_FLUSH_INTERVAL = 500;
+
+struct CacheIndexHeader
+{
+	int iMagic;
+	int iCacheVersion;
+	int iNumEntries;
+};
+
+struct CacheIndexRecord
+{
+	unsigned uKey;
+	unsigned uDirHash;
+	int iLastSeenTime;
+	int iPathLength;	/* followed by the path, not NUL-terminated */
+};
+
 
 SongCacheIndex *SONGINDEX = NULL;
 
-SongCacheIndex::SongCacheIndex()
+SongCacheIndex::SongCacheIndex():
+	m_Mutex( "SongCacheIndex" )
 {
+	m_bDirty = false;
+	m_iUnsavedAdds = 0;
 	ReadCacheIndex();
 }
 
 SongCacheIndex::~SongCacheIndex()
 {
-
+	SaveCacheIndex();
 }
 
 static void EmptyDir( const CString &dir )
@@ -52,13 +81,46 @@ static void EmptyDir( const CString &dir )
 	}
 }
 
+/* Returns false if the index is missing, corrupt or from another cache version. */
+bool SongCacheIndex::LoadFromFile()
+{
+	m_Entries.clear();
+
+	RageFile f;
+	if( !f.Open( CACHE_INDEX ) )
+		return false;
+
+	CacheIndexHeader h;
+	if( f.Read( &h, sizeof(h) ) != sizeof(h) )
+		return false;
+	if( h.iMagic != CACHE_INDEX_MAGIC || h.iCacheVersion != FILE_CACHE_VERSION || h.iNumEntries < 0 )
+		return false;
+
+	for( int i = 0; i < h.iNumEntries; ++i )
+	{
+		CacheIndexRecord r;
+		if( f.Read( &r, sizeof(r) ) != sizeof(r) )
+			return false;
+		if( r.iPathLength < 0 || r.iPathLength > 4096 )
+			return false;
+
+		CacheEntry e;
+		if( f.Read( e.sPath, r.iPathLength ) != r.iPathLength )
+			return false;
+		e.uDirHash = r.uDirHash;
+		e.iLastSeenTime = r.iLastSeenTime;
+		m_Entries[r.uKey] = e;
+	}
+
+	return true;
+}
+
 void SongCacheIndex::ReadCacheIndex()
 {
-	CacheIndex.ReadFile( CACHE_INDEX );	// don't care if this fails
+	m_bDirty = false;
+	m_iUnsavedAdds = 0;
 
-	int iCacheVersion = -1;
-	CacheIndex.GetValue( "Cache", "CacheVersion", iCacheVersion );
-	if( iCacheVersion == FILE_CACHE_VERSION )
+	if( LoadFromFile() )
 		return; /* OK */
 
 	LOG->Trace( "Cache format is out of date.  Deleting all cache files." );
@@ -66,36 +128,81 @@ void SongCacheIndex::ReadCacheIndex()
 	EmptyDir( CACHE_DIR "Banners/" );
 	EmptyDir( CACHE_DIR "Songs/" );
 
-	CacheIndex.Reset();
+	m_Entries.clear();
+}
+
+void SongCacheIndex::SaveCacheIndex()
+{
+	LockMut( m_Mutex );
+	if( !m_bDirty )
+		return;
+
+	RageFile f;
+	if( !f.Open( CACHE_INDEX, RageFile::WRITE ) )
+	{
+		LOG->Warn( "Couldn't write cache index \"%s\": %s", CACHE_INDEX, f.GetError().c_str() );
+		return;
+	}
+
+	CacheIndexHeader h;
+	h.iMagic = CACHE_INDEX_MAGIC;
+	h.iCacheVersion = FILE_CACHE_VERSION;
+	h.iNumEntries = m_Entries.size();
+	f.Write( &h, sizeof(h) );
+
+	for( EntryMap::const_iterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+	{
+		const CacheEntry &e = it->second;
+
+		CacheIndexRecord r;
+		r.uKey = it->first;
+		r.uDirHash = e.uDirHash;
+		r.iLastSeenTime = e.iLastSeenTime;
+		r.iPathLength = e.sPath.size();
+		f.Write( &r, sizeof(r) );
+		f.Write( e.sPath );
+	}
+
+	m_bDirty = false;
+	m_iUnsavedAdds = 0;
 }
 
 void SongCacheIndex::AddCacheIndex(const CString &path, unsigned hash)
 {
 	if( hash == 0 )
 		++hash; /* no 0 hash values */
-	CacheIndex.SetValue( "Cache", "CacheVersion", FILE_CACHE_VERSION );
-	CacheIndex.SetValue( "Cache", MangleName(path), hash );
-	CacheIndex.WriteFile( CACHE_INDEX );
+
+	LockMut( m_Mutex );
+	CacheEntry &e = m_Entries[GetHashForString(path)];
+	e.sPath = path;
+	e.uDirHash = hash;
+	e.iLastSeenTime = (int) time(NULL);
+	m_bDirty = true;
+
+	if( ++m_iUnsavedAdds >= CACHE_INDEX_FLUSH_INTERVAL )
+		SaveCacheIndex();
+}
+
+const SongCacheIndex::CacheEntry *SongCacheIndex::GetCacheEntry( const CString &path ) const
+{
+	LockMut( m_Mutex );
+	EntryMap::const_iterator it = m_Entries.find( GetHashForString(path) );
+	if( it == m_Entries.end() || it->second.sPath != path )
+		return NULL;
+	return &it->second;
 }
 
 unsigned SongCacheIndex::GetCacheHash( const CString &path ) const
 {
-	unsigned iDirHash;
-	if( !CacheIndex.GetValue( "Cache", MangleName(path), iDirHash ) )
+	const CacheEntry *pEntry = GetCacheEntry( path );
+	if( pEntry == NULL )
 		return 0;
+	unsigned iDirHash = pEntry->uDirHash;
 	if( iDirHash == 0 )
 		++iDirHash; /* no 0 hash values */
 	return iDirHash;
 }
 
-CString SongCacheIndex::MangleName( const CString &Name )
-{
-	/* We store paths in an INI.  We can't store '='. */
-	CString ret = Name;
-	ret.Replace( "=", "");
-	return ret;
-}
-
 /*
  * (c) 2002-2003 Glenn Maynard
  * All rights reserved.
@@ -1,20 +1,41 @@
 #ifndef SONG_CACHE_INDEX_H
 #define SONG_CACHE_INDEX_H
 
-#include "IniFile.h"
+#include <map>
+#include "RageThreads.h"
 
 class SongCacheIndex
 {
-	IniFile CacheIndex;
-	static CString MangleName( const CString &Name );
-
 public:
+	/* One record per song directory, keyed by GetHashForString(path). */
+	struct CacheEntry
+	{
+		CString sPath;		/* song directory; guards against key collisions */
+		unsigned uDirHash;	/* GetHashForDirectory() when the cache was written */
+		int iLastSeenTime;	/* time() of the last AddCacheIndex */
+	};
+
 	SongCacheIndex();
 	~SongCacheIndex();
 
 	void ReadCacheIndex();
+	void SaveCacheIndex();	/* write the index if it has changed since the last save */
 	void AddCacheIndex( const CString &path, unsigned hash );
 	unsigned GetCacheHash( const CString &path ) const;
+
+	/* Entries are never removed, so the returned pointer stays valid. */
+	const CacheEntry *GetCacheEntry( const CString &path ) const;
+
+private:
+	bool LoadFromFile();
+
+	typedef map<unsigned, CacheEntry> EntryMap;
+	EntryMap m_Entries;
+	bool m_bDirty;
+	int m_iUnsavedAdds;
+
+	/* Songs may be loaded from more than one thread. */
+	mutable RageMutex m_Mutex;
 };
 
 extern SongCacheIndex *SONGINDEX;	// global and accessable from anywhere in our program
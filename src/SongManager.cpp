@@ -5,6 +5,7 @@
 #include "MsdFile.h"
 #include "NotesLoaderDWI.h"
 #include "BannerCache.h"
+#include "SongCacheIndex.h"
 #include "arch/arch.h"
 
 #include "GameState.h"
@@ -30,6 +31,8 @@
 #include "Foreach.h"
 #include "StageStats.h"
 #include "Style.h"
+#include "StepMania.h"
+#include "RageThreads.h"
 
 SongManager*	SONGMAN = NULL;	// global and accessable from anywhere in our program
 
@@ -130,6 +133,7 @@ void SongManager::InitSongsFromDisk( LoadingWindow *ld )
 {
 	RageTimer tm;
 	LoadStepManiaSongDir( SONGS_DIR, ld );
+	SONGINDEX->SaveCacheIndex();
 	LOG->Trace( "Found %d songs in %f seconds.", (int)m_pSongs.size(), tm.GetDeltaTime() );
 }
 
@@ -189,6 +193,137 @@ void SongManager::AddGroup( const CString &sDir, const CString &sGroupDirName )
 	m_sGroupBannerPaths.push_back(sBannerPath);
 }
 
+/* Songs are parsed by this many threads; set it with --threads=N.  With one,
+ * songs are loaded on the calling thread, one at a time. */
+static const int MAX_SONG_LOAD_THREADS = 8;
+
+static int GetNumSongLoadThreads()
+{
+	CString sThreads;
+	if( !GetCommandlineArgument( "threads", &sThreads ) )
+		return 1;
+	return clamp( atoi(sThreads), 1, MAX_SONG_LOAD_THREADS );
+}
+
+struct SongLoadJob
+{
+	CString sGroupDirName;
+	CString sSongDir;
+	Song *pSong;	/* NULL if it didn't load */
+};
+
+static Song *LoadSong( const CString &sSongDir )
+{
+	Song* pNewSong = new Song;
+	if( !pNewSong->LoadFromSongDir( sSongDir ) )
+	{
+		/* The song failed to load. */
+		delete pNewSong;
+		return NULL;
+	}
+	return pNewSong;
+}
+
+static void ShowLoadingSong( LoadingWindow *ld, const SongLoadJob &job )
+{
+	if( ld == NULL )
+		return;
+
+	CString text = ssprintf("Loading songs...\n%s\n%s", Basename(job.sGroupDirName).c_str(), Basename(job.sSongDir).c_str());
+#ifdef PSP
+	sjis_sanitize( text );
+#endif
+	ld->SetText( text );
+	ld->Paint();
+}
+
+/* Shared by the song loading threads.  Each thread takes the next job
+ * until there are none left; results go back into the job, so the order
+ * songs are added in doesn't depend on which thread finishes first. */
+struct SongLoadQueue
+{
+	SongLoadQueue( vector<SongLoadJob> &aJobs ):
+		m_aJobs( aJobs ),
+		m_Mutex( "SongLoadQueue" ),
+		m_Finished( "SongLoadFinished" )
+	{
+		m_iNextJob = 0;
+		m_iLastFinished = 0;
+	}
+
+	vector<SongLoadJob> &m_aJobs;
+	RageMutex m_Mutex;	/* guards m_iNextJob and m_iLastFinished */
+	unsigned m_iNextJob;
+	unsigned m_iLastFinished;
+	RageSemaphore m_Finished;	/* posted once per finished job */
+};
+
+static int SongLoadThread( void *p )
+{
+	SongLoadQueue *pQueue = (SongLoadQueue *) p;
+
+	while( 1 )
+	{
+		pQueue->m_Mutex.Lock();
+		const unsigned iJob = pQueue->m_iNextJob++;
+		pQueue->m_Mutex.Unlock();
+
+		if( iJob >= pQueue->m_aJobs.size() )
+			return 0;
+
+		SongLoadJob &job = pQueue->m_aJobs[iJob];
+		job.pSong = LoadSong( job.sSongDir );
+
+		pQueue->m_Mutex.Lock();
+		pQueue->m_iLastFinished = iJob;
+		pQueue->m_Mutex.Unlock();
+		pQueue->m_Finished.Post();
+	}
+}
+
+static void LoadSongs( vector<SongLoadJob> &aJobs, LoadingWindow *ld )
+{
+	const int iThreads = min( GetNumSongLoadThreads(), (int) aJobs.size() );
+
+	/* Load the title translations here, rather than on whichever thread gets there first. */
+	Song::InitTitleSubst();
+
+	if( iThreads <= 1 )
+	{
+		for( unsigned i = 0; i < aJobs.size(); ++i )
+		{
+			ShowLoadingSong( ld, aJobs[i] );
+			aJobs[i].pSong = LoadSong( aJobs[i].sSongDir );
+		}
+		return;
+	}
+
+	LOG->Trace( "Loading %i songs with %i threads", (int) aJobs.size(), iThreads );
+
+	SongLoadQueue queue( aJobs );
+	RageThread *pThreads = new RageThread[iThreads];
+	for( int i = 0; i < iThreads; ++i )
+	{
+		pThreads[i].SetName( ssprintf("Song loader %i", i) );
+		pThreads[i].Create( SongLoadThread, &queue, 0x20000 );
+	}
+
+	/* The LoadingWindow belongs to this thread; keep it up to date here. */
+	for( unsigned i = 0; i < aJobs.size(); ++i )
+	{
+		queue.m_Finished.Wait();
+
+		queue.m_Mutex.Lock();
+		const unsigned iLastFinished = queue.m_iLastFinished;
+		queue.m_Mutex.Unlock();
+		ShowLoadingSong( ld, aJobs[iLastFinished] );
+	}
+
+	for( int i = 0; i < iThreads; ++i )
+		pThreads[i].Wait();
+	delete [] pThreads;
+}
+
 void SongManager::LoadStepManiaSongDir( CString sDir, LoadingWindow *ld )
 {
 	/* Make sure sDir has a trailing slash. */
@@ -200,6 +335,10 @@ void SongManager::LoadStepManiaSongDir( CString sDir, LoadingWindow *ld )
 	GetDirListing( sDir+"*", arrayGroupDirs, true );
 	SortCStringArray( arrayGroupDirs );
 
+	/* Find every song first, then load them all at once, so they can be
+	 * loaded in parallel. */
+	vector<SongLoadJob> aJobs;
+	CStringArray asGroupsToLoad;
 	for( unsigned i=0; i< arrayGroupDirs.size(); i++ )	// for each dir in /Songs/
 	{
 		const CString &sGroupDirName = arrayGroupDirs[i];
@@ -216,7 +355,7 @@ void SongManager::LoadStepManiaSongDir( CString sDir, LoadingWindow *ld )
 		SortCStringArray( arraySongDirs );
 
 		LOG->Trace("Attempting to load %i songs from \"%s\"", arraySongDirs.size(), sGroupDir.c_str() );
-		int loaded = 0;
+		asGroupsToLoad.push_back( sGroupDirName );
 
 		for( unsigned j=0; j< arraySongDirs.size(); j++ )	// for each song dir
 		{
@@ -226,26 +365,33 @@ void SongManager::LoadStepManiaSongDir( CString sDir, LoadingWindow *ld )
 				continue;		// ignore it
 
 			// this is a song directory.  Load a new song!
-			if( ld ) {
-				CString text = ssprintf("Loading songs...\n%s\n%s", Basename(sGroupDirName).c_str(), Basename(sSongDirName).c_str());
-#ifdef PSP
-				sjis_sanitize( text );
-#endif
-				ld->SetText( text );
-				ld->Paint();
-			}
-			Song* pNewSong = new Song;
-			if( !pNewSong->LoadFromSongDir( sSongDirName ) ) {
-				/* The song failed to load. */
-				delete pNewSong;
+			SongLoadJob job;
+			job.sGroupDirName = sGroupDirName;
+			job.sSongDir = sSongDirName;
+			job.pSong = NULL;
+			aJobs.push_back( job );
+		}
+	}
+
+	LoadSongs( aJobs, ld );
+
+	/* Add the results in the order we found them. */
+	unsigned iJob = 0;
+	for( unsigned i=0; i< asGroupsToLoad.size(); i++ )
+	{
+		const CString &sGroupDirName = asGroupsToLoad[i];
+		int loaded = 0;
+
+		for( ; iJob < aJobs.size() && aJobs[iJob].sGroupDirName == sGroupDirName; ++iJob )
+		{
+			if( aJobs[iJob].pSong == NULL )
 				continue;
-			}
-			
-            m_pSongs.push_back( pNewSong );
+
+			m_pSongs.push_back( aJobs[iJob].pSong );
 			loaded++;
 		}
 
-		LOG->Trace("Loaded %i songs from \"%s\"", loaded, sGroupDir.c_str() );
+		LOG->Trace("Loaded %i songs from \"%s\"", loaded, (sDir+sGroupDirName).c_str() );
 
 		/* Don't add the group name if we didn't load any songs in this group. */
 		if(!loaded) continue;
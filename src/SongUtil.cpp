@@ -8,7 +8,7 @@
 #include "PrefsManager.h"
 #include "SongManager.h"
 #include "XmlFile.h"
-#include "PrefsManager.h"
+#include "RageThreads.h"
 
 
 /////////////////////////////////////
@@ -29,6 +29,126 @@ bool CompareSongPointersBySortValueDescending(const Song *pSong1, const Song *pS
 	return song_sort_val[pSong1] > song_sort_val[pSong2];
 }
 
+/* Everything the sorts and section names need from a song.  Working these out
+ * (MakeSortString, GetStepsByDifficulty, GetGrades) inside the sorts made building
+ * the music wheel slow with large libraries, so they're computed once per song
+ * and kept until the song, its steps or its scores change. */
+struct SongSortKeys
+{
+	SongSortKeys()
+	{
+		bSongKeysValid = false;
+		StepsKeysType = STEPS_TYPE_INVALID;
+		GradeKeysType = STEPS_TYPE_INVALID;
+	}
+
+	/* From the song itself. */
+	bool bSongKeysValid;
+	CString sMainTitle;	/* transliterated; not a sort string */
+	CString sTitleSort, sSubTitleSort, sArtistSort, sDisplayArtistSort;
+	float fMaxBPM;
+
+	/* From the song's steps of StepsKeysType. */
+	StepsType StepsKeysType;
+	int iSortDifficulty;
+	int iMeter[NUM_DIFFICULTIES];	/* -1 if there are no steps */
+	float fNumTapsAndHolds[NUM_DIFFICULTIES];
+
+	/* From the machine profile's scores for GradeKeysType. */
+	StepsType GradeKeysType;
+	int iGradeCounts[NUM_GRADES];
+};
+
+/* Songs are loaded (and so invalidated) from several threads; sorting happens
+ * in the main thread. */
+static RageMutex g_SortKeysLock( "SongSortKeys" );
+static map<const Song*, SongSortKeys> g_SortKeys;
+static int g_iSortKeyGeneration = 0;
+
+static int GetSongSortDifficulty( const Song *pSong, StepsType st );
+
+static const SongSortKeys &GetSortKeys( const Song *pSong )
+{
+	SongSortKeys &k = g_SortKeys[pSong];
+	if( k.bSongKeysValid )
+		return k;
+
+	k.sMainTitle = pSong->GetTranslitMainTitle();
+	k.sTitleSort = SongUtil::MakeSortString( k.sMainTitle );
+	k.sSubTitleSort = SongUtil::MakeSortString( pSong->GetTranslitSubTitle() );
+	k.sArtistSort = SongUtil::MakeSortString( pSong->GetTranslitArtist() );
+	k.sDisplayArtistSort = SongUtil::MakeSortString( pSong->GetDisplayArtist() );
+
+	DisplayBpms bpms;
+	pSong->GetDisplayBpms( bpms );
+	k.fMaxBPM = bpms.GetMax();
+
+	k.bSongKeysValid = true;
+	return k;
+}
+
+static const SongSortKeys &GetStepsSortKeys( const Song *pSong )
+{
+	const StepsType st = GAMESTATE->GetCurrentStyle()->m_StepsType;
+	SongSortKeys &k = const_cast<SongSortKeys &>( GetSortKeys(pSong) );
+	if( k.StepsKeysType == st )
+		return k;
+
+	k.iSortDifficulty = GetSongSortDifficulty( pSong, st );
+	FOREACH_Difficulty( dc )
+	{
+		const Steps* pSteps = pSong->GetStepsByDifficulty( st, dc );
+		k.iMeter[dc] = pSteps? pSteps->GetMeter():-1;
+		k.fNumTapsAndHolds[dc] = pSteps? pSteps->GetRadarValues()[RADAR_NUM_TAPS_AND_HOLDS]:0;
+	}
+
+	k.StepsKeysType = st;
+	return k;
+}
+
+static const SongSortKeys &GetGradeSortKeys( const Song *pSong )
+{
+	const StepsType st = GAMESTATE->GetCurrentStyle()->m_StepsType;
+	SongSortKeys &k = const_cast<SongSortKeys &>( GetSortKeys(pSong) );
+	if( k.GradeKeysType == st )
+		return k;
+
+	PROFILEMAN->GetMachineProfile()->GetGrades( pSong, st, k.iGradeCounts );
+	k.GradeKeysType = st;
+	return k;
+}
+
+void SongUtil::InvalidateSortKeys( const Song *pSong )
+{
+	LockMut( g_SortKeysLock );
+	g_SortKeys.erase( pSong );
+	++g_iSortKeyGeneration;
+}
+
+void SongUtil::InvalidateGradeSortKeys( const Song *pSong )
+{
+	LockMut( g_SortKeysLock );
+	map<const Song*, SongSortKeys>::iterator it = g_SortKeys.find( pSong );
+	if( it == g_SortKeys.end() || it->second.GradeKeysType == STEPS_TYPE_INVALID )
+		return;
+	it->second.GradeKeysType = STEPS_TYPE_INVALID;
+	++g_iSortKeyGeneration;
+}
+
+void SongUtil::InvalidateAllGradeSortKeys()
+{
+	LockMut( g_SortKeysLock );
+	map<const Song*, SongSortKeys>::iterator it;
+	for( it = g_SortKeys.begin(); it != g_SortKeys.end(); ++it )
+		it->second.GradeKeysType = STEPS_TYPE_INVALID;
+	++g_iSortKeyGeneration;
+}
+
+int SongUtil::GetSortKeyGeneration()
+{
+	LockMut( g_SortKeysLock );
+	return g_iSortKeyGeneration;
+}
 
 CString SongUtil::MakeSortString( CString s )
 {
@@ -48,17 +168,13 @@ CString SongUtil::MakeSortString( CString s )
 
 bool CompareSongPointersByTitle(const Song *pSong1, const Song *pSong2)
 {
-	// Prefer transliterations to full titles
-	CString s1 = pSong1->GetTranslitMainTitle();
-	CString s2 = pSong2->GetTranslitMainTitle();
-	if( s1 == s2 )
-	{
-		s1 = pSong1->GetTranslitSubTitle();
-		s2 = pSong2->GetTranslitSubTitle();
-	}
+	const SongSortKeys &k1 = GetSortKeys( pSong1 );
+	const SongSortKeys &k2 = GetSortKeys( pSong2 );
 
-	s1 = SongUtil::MakeSortString(s1);
-	s2 = SongUtil::MakeSortString(s2);
+	// Prefer transliterations to full titles
+	const bool bSameTitle = k1.sMainTitle == k2.sMainTitle;
+	const CString &s1 = bSameTitle? k1.sSubTitleSort:k1.sTitleSort;
+	const CString &s2 = bSameTitle? k2.sSubTitleSort:k2.sTitleSort;
 
 	int ret = s1.CompareNoCase( s2 );
 	if(ret < 0) return true;
@@ -71,13 +187,14 @@ bool CompareSongPointersByTitle(const Song *pSong1, const Song *pSong2)
 
 void SongUtil::SortSongPointerArrayByTitle( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersByTitle );
 }
 
-static int GetSongSortDifficulty(const Song *pSong)
+static int GetSongSortDifficulty( const Song *pSong, StepsType st )
 {
 	vector<Steps*> aNotes;
-	pSong->GetSteps( aNotes, GAMESTATE->GetCurrentStyle()->m_StepsType );
+	pSong->GetSteps( aNotes, st );
 
 	/* Sort by the first difficulty found in the following order: */
 	const Difficulty d[] = { DIFFICULTY_EASY, DIFFICULTY_MEDIUM, DIFFICULTY_HARD,
@@ -99,21 +216,21 @@ static int GetSongSortDifficulty(const Song *pSong)
 
 void SongUtil::SortSongPointerArrayByDifficulty( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	for( unsigned i = 0; i < arraySongPointers.size(); ++i )
 		song_sort_val[arraySongPointers[i]] =
-			ssprintf("%9i", GetSongSortDifficulty(arraySongPointers[i]));
+			ssprintf("%9i", GetStepsSortKeys(arraySongPointers[i]).iSortDifficulty);
 	stable_sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersBySortValueAscending );
 }
 
 bool CompareSongPointersByBPM(const Song *pSong1, const Song *pSong2)
 {
-	DisplayBpms bpms1, bpms2;
-	pSong1->GetDisplayBpms( bpms1 );
-	pSong2->GetDisplayBpms( bpms2 );
+	const float fMax1 = GetSortKeys( pSong1 ).fMaxBPM;
+	const float fMax2 = GetSortKeys( pSong2 ).fMaxBPM;
 
-	if( bpms1.GetMax() < bpms2.GetMax() )
+	if( fMax1 < fMax2 )
 		return true;
-	if( bpms1.GetMax() > bpms2.GetMax() )
+	if( fMax1 > fMax2 )
 		return false;
 	
 	return CompareCStringsAsc( pSong1->GetSongFilePath(), pSong2->GetSongFilePath() );
@@ -121,6 +238,7 @@ bool CompareSongPointersByBPM(const Song *pSong1, const Song *pSong2)
 
 void SongUtil::SortSongPointerArrayByBPM( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersByBPM );
 }
 
@@ -141,6 +259,7 @@ void SongUtil::SortSongPointerArrayByGrade( vector<Song*> &arraySongPointers )
 {
 	/* Optimize by pre-writing a string to compare, since doing GetNumNotesWithGrade
 	 * inside the sort is too slow. */
+	LockMut( g_SortKeysLock );
 	typedef pair< Song *, CString > val;
 	vector<val> vals;
 	vals.reserve( arraySongPointers.size() );
@@ -150,8 +269,7 @@ void SongUtil::SortSongPointerArrayByGrade( vector<Song*> &arraySongPointers )
 	{
 		Song *pSong = arraySongPointers[i];
 
-		int iCounts[NUM_GRADES];
-		PROFILEMAN->GetMachineProfile()->GetGrades( pSong, GAMESTATE->GetCurrentStyle()->m_StepsType, iCounts );
+		const int *iCounts = GetGradeSortKeys( pSong ).iGradeCounts;
 
 		CString foo;
 		foo.reserve(256);
@@ -169,8 +287,9 @@ void SongUtil::SortSongPointerArrayByGrade( vector<Song*> &arraySongPointers )
 
 void SongUtil::SortSongPointerArrayByArtist( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	for( unsigned i = 0; i < arraySongPointers.size(); ++i )
-		song_sort_val[arraySongPointers[i]] = MakeSortString( arraySongPointers[i]->GetTranslitArtist() );
+		song_sort_val[arraySongPointers[i]] = GetSortKeys( arraySongPointers[i] ).sArtistSort;
 	stable_sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersBySortValueAscending );
 }
 
@@ -178,8 +297,9 @@ void SongUtil::SortSongPointerArrayByArtist( vector<Song*> &arraySongPointers )
  * interesting for display. */
 void SongUtil::SortSongPointerArrayByDisplayArtist( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	for( unsigned i = 0; i < arraySongPointers.size(); ++i )
-		song_sort_val[arraySongPointers[i]] = MakeSortString( arraySongPointers[i]->GetDisplayArtist() );
+		song_sort_val[arraySongPointers[i]] = GetSortKeys( arraySongPointers[i] ).sDisplayArtistSort;
 	stable_sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersBySortValueAscending );
 }
 
@@ -210,6 +330,7 @@ int CompareSongPointersByGroupAndTitle(const Song *pSong1, const Song *pSong2)
 
 void SongUtil::SortSongPointerArrayByGroupAndTitle( vector<Song*> &arraySongPointers )
 {
+	LockMut( g_SortKeysLock );
 	sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersByGroupAndTitle );
 }
 
@@ -244,14 +365,16 @@ CString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 	case SORT_TITLE:
 	case SORT_ARTIST:	
 		{
+			LockMut( g_SortKeysLock );
+			const SongSortKeys &k = GetSortKeys( pSong );
 			CString s;
 			switch( so )
 			{
-			case SORT_TITLE:	s = pSong->GetTranslitMainTitle();	break;
-			case SORT_ARTIST:	s = pSong->GetTranslitArtist();		break;
+			case SORT_TITLE:	s = k.sTitleSort;	break;
+			case SORT_ARTIST:	s = k.sArtistSort;	break;
 			default:	ASSERT(0);
 			}
-			s = MakeSortString(s);	// resulting string will be uppercase
+			// MakeSortString results are uppercase
 			
 			if( s.empty() )
 				return "";
@@ -265,9 +388,8 @@ CString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 	case SORT_BPM:
 		{
 			const int iBPMGroupSize = 20;
-			DisplayBpms bpms;
-			pSong->GetDisplayBpms( bpms );
-			int iMaxBPM = (int)bpms.GetMax();
+			LockMut( g_SortKeysLock );
+			int iMaxBPM = (int)GetSortKeys( pSong ).fMaxBPM;
 			iMaxBPM += iBPMGroupSize - (iMaxBPM%iBPMGroupSize) - 1;
 			return ssprintf("%03d-%03d",iMaxBPM-(iBPMGroupSize-1), iMaxBPM);
 		}
@@ -275,8 +397,8 @@ CString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 		return "";
 	case SORT_GRADE:
 		{
-			int iCounts[NUM_GRADES];
-			PROFILEMAN->GetMachineProfile()->GetGrades( pSong, GAMESTATE->GetCurrentStyle()->m_StepsType, iCounts );
+			LockMut( g_SortKeysLock );
+			const int *iCounts = GetGradeSortKeys( pSong ).iGradeCounts;
 
 			for( int i=GRADE_TIER_1; i<NUM_GRADES; ++i )
 			{
@@ -287,31 +409,23 @@ CString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 			return GradeToThemedString( GRADE_NO_DATA );
 		}
 	case SORT_EASY_METER:
-		{
-			Steps* pSteps = pSong->GetStepsByDifficulty(GAMESTATE->GetCurrentStyle()->m_StepsType,DIFFICULTY_EASY);
-			if( pSteps )	
-				return ssprintf("%02d", pSteps->GetMeter() );
-			return "N/A";
-		}
 	case SORT_MEDIUM_METER:
-		{
-			Steps* pSteps = pSong->GetStepsByDifficulty(GAMESTATE->GetCurrentStyle()->m_StepsType,DIFFICULTY_MEDIUM);
-			if( pSteps )	
-				return ssprintf("%02d", pSteps->GetMeter() );
-			return "N/A";
-		}
 	case SORT_HARD_METER:
-		{
-			Steps* pSteps = pSong->GetStepsByDifficulty(GAMESTATE->GetCurrentStyle()->m_StepsType,DIFFICULTY_HARD);
-			if( pSteps )	
-				return ssprintf("%02d", pSteps->GetMeter() );
-			return "N/A";
-		}
 	case SORT_CHALLENGE_METER:
 		{
-			Steps* pSteps = pSong->GetStepsByDifficulty(GAMESTATE->GetCurrentStyle()->m_StepsType,DIFFICULTY_CHALLENGE);
-			if( pSteps )	
-				return ssprintf("%02d", pSteps->GetMeter() );
+			Difficulty dc;
+			switch( so )
+			{
+			case SORT_EASY_METER:	dc = DIFFICULTY_EASY;		break;
+			case SORT_MEDIUM_METER:	dc = DIFFICULTY_MEDIUM;		break;
+			case SORT_HARD_METER:	dc = DIFFICULTY_HARD;		break;
+			default:				dc = DIFFICULTY_CHALLENGE;	break;
+			}
+
+			LockMut( g_SortKeysLock );
+			const int iMeter = GetStepsSortKeys( pSong ).iMeter[dc];
+			if( iMeter != -1 )
+				return ssprintf("%02d", iMeter );
 			return "N/A";
 		}
 	case SORT_SORT_MENU:
@@ -329,6 +443,7 @@ CString SongUtil::GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so
 
 void SongUtil::SortSongPointerArrayBySectionName( vector<Song*> &arraySongPointers, SortOrder so )
 {
+	LockMut( g_SortKeysLock );
 	for(unsigned i = 0; i < arraySongPointers.size(); ++i)
 	{
 		CString val = GetSectionNameFromSongAndSort( arraySongPointers[i], so );
@@ -347,14 +462,15 @@ void SongUtil::SortSongPointerArrayBySectionName( vector<Song*> &arraySongPointe
 
 void SongUtil::SortSongPointerArrayByMeter( vector<Song*> &arraySongPointers, Difficulty dc )
 {
+	LockMut( g_SortKeysLock );
 	song_sort_val.clear();
 	for(unsigned i = 0; i < arraySongPointers.size(); ++i)
 	{
-		Steps* pSteps = arraySongPointers[i]->GetStepsByDifficulty( GAMESTATE->GetCurrentStyle()->m_StepsType, dc );
+		const SongSortKeys &k = GetStepsSortKeys( arraySongPointers[i] );
 		CString &s = song_sort_val[arraySongPointers[i]];
-		s = ssprintf("%03d", pSteps ? pSteps->GetMeter() : 0);
+		s = ssprintf("%03d", max(k.iMeter[dc], 0));
 		if( PREFSMAN->m_bSubSortByNumSteps )
-			s += ssprintf("%06.0f",pSteps ? pSteps->GetRadarValues()[RADAR_NUM_TAPS_AND_HOLDS] : 0);
+			s += ssprintf("%06.0f", k.fNumTapsAndHolds[dc]);
 	}
 	stable_sort( arraySongPointers.begin(), arraySongPointers.end(), CompareSongPointersBySortValueAscending );
 }
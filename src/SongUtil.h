@@ -25,6 +25,15 @@ namespace SongUtil
 	void SortSongPointerArrayByMeter( vector<Song*> &arraySongPointers, Difficulty dc );
 	CString GetSectionNameFromSongAndSort( const Song* pSong, SortOrder so );
 	void SortSongPointerArrayBySectionName( vector<Song*> &arraySongPointers, SortOrder so );
+
+	/* The sorts above cache per-song sort keys.  Call these when a song is
+	 * reloaded, changed or freed, or when its scores change.  The generation
+	 * changes whenever a cached key is dropped, so callers can keep sorted
+	 * lists until it does. */
+	void InvalidateSortKeys( const Song *pSong );
+	void InvalidateGradeSortKeys( const Song *pSong );
+	void InvalidateAllGradeSortKeys();
+	int GetSortKeyGeneration();
 }
 
 class SongID
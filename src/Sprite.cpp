@@ -863,30 +863,51 @@ void Sprite::StretchTexCoords( float fX, float fY )
 	SetCustomTextureCoords( fTexCoords );
 }
 
+enum SpriteCommand
+{
+	SC_CUSTOMTEXTURERECT,
+	SC_TEXCOORDVELOCITY,
+	SC_SCALETOCLIPPED,
+	SC_STRETCHTEXCOORDS,
+	SC_POSITION,
+	SC_LOOP,
+	SC_PLAY,
+	SC_PAUSE,
+	SC_RATE,
+	NUM_SPRITE_COMMANDS
+};
+
+static const char *const g_szSpriteCommandNames[NUM_SPRITE_COMMANDS] =
+{
+	"customtexturerect", "texcoordvelocity", "scaletoclipped", "stretchtexcoords",
+	"position", "loop", "play", "pause", "rate"
+};
+
+static const CommandNameTable g_SpriteCommands( g_szSpriteCommandNames, NUM_SPRITE_COMMANDS );
+
 void Sprite::HandleCommand( const ParsedCommand &command )
 {
 	HandleParams;
 
-	const CString& sName = sParam(0);
-
 	// Commands that go in the tweening queue:
 	// Commands that take effect immediately (ignoring the tweening queue):
-	if( sName=="customtexturerect" )		SetCustomTextureRect( RectF(fParam(1),fParam(2),fParam(3),fParam(4)) );
-	else if( sName=="texcoordvelocity" )	SetTexCoordVelocity( fParam(1),fParam(2) );
-	else if( sName=="scaletoclipped" )		ScaleToClipped( fParam(1),fParam(2) );
-	else if( sName=="stretchtexcoords" )	StretchTexCoords( fParam(1),fParam(2) );
+	switch( g_SpriteCommands.Lookup(command) )
+	{
+	case SC_CUSTOMTEXTURERECT:	SetCustomTextureRect( RectF(fParam(1),fParam(2),fParam(3),fParam(4)) ); break;
+	case SC_TEXCOORDVELOCITY:	SetTexCoordVelocity( fParam(1),fParam(2) ); break;
+	case SC_SCALETOCLIPPED:		ScaleToClipped( fParam(1),fParam(2) ); break;
+	case SC_STRETCHTEXCOORDS:	StretchTexCoords( fParam(1),fParam(2) ); break;
 
 	/* Texture commands; these could be moved to RageTexture* (even though that's
 	 * not an Actor) if these are needed for other things that use textures.
 	 * We'd need to break the command helpers into a separate function; RageTexture
 	 * shouldn't depend on Actor. */
-	else if( sName=="position" )		GetTexture()->SetPosition( fParam(1) );
-	else if( sName=="loop" )			GetTexture()->SetLooping( bParam(1) );
-	else if( sName=="play" )			GetTexture()->Play();
-	else if( sName=="pause" )			GetTexture()->Pause();
-	else if( sName=="rate" )			GetTexture()->SetPlaybackRate( fParam(1) );
-	else
-	{
+	case SC_POSITION:			GetTexture()->SetPosition( fParam(1) ); break;
+	case SC_LOOP:				GetTexture()->SetLooping( bParam(1) ); break;
+	case SC_PLAY:				GetTexture()->Play(); break;
+	case SC_PAUSE:				GetTexture()->Pause(); break;
+	case SC_RATE:				GetTexture()->SetPlaybackRate( fParam(1) ); break;
+	default:
 		Actor::HandleCommand( command );
 		return;
 	}
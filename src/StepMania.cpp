@@ -52,6 +52,7 @@
 #include "Bookkeeper.h"
 #include "ModelManager.h"
 #include "NetworkSyncManager.h"
+#include "LuaHelpers.h"
 
 #define ZIPS_DIR "Packages/"
 
@@ -188,10 +189,26 @@ static void CheckSettings()
 }
 
 #include "RageDisplay_PSP.h"
+#include "RageDisplay_Null.h"
 
 RageDisplay *CreateDisplay()
 {
-	return new RageDisplay_PSP( GetCurVideoModeParams() );
+	CStringArray asRenderers;
+	split( PREFSMAN->GetVideoRenderers(), ",", asRenderers, true );
+
+	for( unsigned i = 0; i < asRenderers.size(); ++i )
+	{
+		const CString &sRenderer = asRenderers[i];
+
+		if( !sRenderer.CompareNoCase("PSP") )
+			return new RageDisplay_PSP( GetCurVideoModeParams() );
+		if( !sRenderer.CompareNoCase("Null") )
+			return new RageDisplay_Null( GetCurVideoModeParams() );
+
+		LOG->Warn( "Unknown video renderer name: %s", sRenderer.c_str() );
+	}
+
+	RageException::Throw( "No video renderers attempted: \"%s\"", PREFSMAN->GetVideoRenderers().c_str() );
 }
 
 
@@ -352,6 +369,7 @@ static void ApplyLogPreferences()
 	LOG->SetLogToDisk( PREFSMAN->m_bLogToDisk );
 	LOG->SetInfoToDisk( true );
 	LOG->SetFlushing( PREFSMAN->m_bForceLogFlush );
+	LOG->SetOverflowPolicy( PREFSMAN->m_bLogDropOnOverflow? RageLog::OVERFLOW_DROP:RageLog::OVERFLOW_BLOCK );
 	Checkpoints::LogCheckpoints( PREFSMAN->m_bLogCheckpoints );
 }
 
@@ -592,6 +610,7 @@ int main(int argc, char* argv[])
 	SAFE_DELETE( GAMEMAN );
 	SAFE_DELETE( NOTESKIN );
 	SAFE_DELETE( THEME );
+	Lua::Shutdown();
 	SAFE_DELETE( ANNOUNCER );
 	SAFE_DELETE( BOOKKEEPER );
 	SAFE_DELETE( SOUNDMAN );
@@ -30,6 +30,7 @@
 #include "ProfileManager.h"
 #include "PrefsManager.h"
 #include "NotesLoaderSM.h"
+#include "RageFile.h"
 
 const int MAX_DESCRIPTION_LENGTH = 20;
 
@@ -40,6 +41,8 @@ Steps::Steps()
 	m_uHash = 0;
 	m_Difficulty = DIFFICULTY_INVALID;
 	m_iMeter = 0;
+	m_iFileOffset = -1;
+	m_iFileLength = -1;
 
 	notes = NULL;
 	notes_comp = NULL;
@@ -185,7 +188,11 @@ void Steps::Decompress() const
 		return;
 	}
 
-	if( !m_sFilename.empty() && notes_comp == NULL )
+	if( !m_sFilename.empty() && notes_comp == NULL && LoadFromFileRange() )
+	{
+		/* Read just our own #NOTES tag. */
+	}
+	else if( !m_sFilename.empty() && notes_comp == NULL )
 	{
 		/* We have data on disk and not in memory.  Load it. */
 		Song s;
@@ -225,6 +232,52 @@ void Steps::Decompress() const
 	}
 }
 
+/* If we know where our #NOTES tag lives in m_sFilename, read and parse only that
+ * instead of the whole file.  If the range doesn't hold the tag we expect (the
+ * file was rewritten behind our back), return false and let the caller load the
+ * whole file. */
+bool Steps::LoadFromFileRange() const
+{
+	if( m_iFileOffset < 0 || m_iFileLength <= 0 )
+		return false;
+
+	RageFile f;
+	if( !f.Open( m_sFilename ) )
+		return false;
+	if( f.Seek( m_iFileOffset ) != m_iFileOffset )
+		return false;
+
+	CString sTag;
+	if( f.Read( sTag, m_iFileLength ) != m_iFileLength )
+		return false;
+
+	MsdFile msd;
+	msd.ReadFromString( sTag );
+	if( msd.GetNumValues() != 1 )
+		return false;
+
+	const MsdFile::value_t &sParams = msd.GetValue(0);
+	const int iNumParams = msd.GetNumParams(0);
+	if( sParams[0].CompareNoCase("NOTES") || iNumParams < 7 )
+		return false;
+
+	Steps tmp;
+	SMLoader::LoadFromSMTokens( 
+		sParams[1], sParams[2], sParams[3], sParams[4], sParams[5], sParams[6], (iNumParams>=8)?sParams[7]:CString(""),
+		tmp );
+	if( tmp.m_StepsType != m_StepsType ||
+		tmp.GetDifficulty() != GetDifficulty() ||
+		tmp.GetDescription() != GetDescription() )
+	{
+		LOG->Trace( "Steps range %i+%i in \"%s\" is stale", m_iFileOffset, m_iFileLength, m_sFilename.c_str() );
+		return false;
+	}
+
+	notes_comp = new CompressedNoteData;
+	tmp.GetSMNoteData( notes_comp->notes, notes_comp->attacks );
+	return true;
+}
+
 void Steps::Compress() const
 {
 	if( !m_sFilename.empty() )
@@ -312,6 +365,12 @@ void Steps::SetFile( const CString &fn )
 	m_sFilename = fn;
 }
 
+void Steps::SetFileRange( int iOffset, int iLength )
+{
+	m_iFileOffset = iOffset;
+	m_iFileLength = iLength;
+}
+
 void Steps::SetDescription(const CString &desc)
 {
 	DeAutogen();
@@ -37,6 +37,7 @@ public:
 	const RadarValues& GetRadarValues() const { return Real()->m_RadarValues; }
 
 	void SetFile( const CString &fn );
+	void SetFileRange( int iOffset, int iLength );
 	void SetDescription(const CString &desc);
 	void SetDifficulty(Difficulty d);
 	void SetLoadedFromProfile( ProfileSlot slot ) { m_LoadedFromProfile = slot; }
@@ -72,6 +73,11 @@ protected:
 	const Steps *Real() const;
 
 	CString			m_sFilename;
+	/* Byte range of our #NOTES tag within m_sFilename, or -1 if unknown. */
+	int				m_iFileOffset;
+	int				m_iFileLength;
+
+	bool LoadFromFileRange() const;
 
 	/* These values are pulled from the autogen source first, if there is one. */
 	ProfileSlot		m_LoadedFromProfile;	// PROFILE_SLOT_INVALID if wasn't loaded from a profile
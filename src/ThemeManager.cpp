@@ -48,6 +48,53 @@ deque<Theme> g_vThemes;
 /* We spend a lot of time doing redundant theme path lookups.  Cache results. */
 static map<CString, CString> g_ThemePathCache[NUM_ELEMENT_CATEGORIES];
 
+/* Resolved paths are also saved to disk, so the next boot with the same theme
+ * files starts with a warm cache instead of scanning the theme directories for
+ * every element.  The file is only used if its key matches; see
+ * GetThemePathCacheKey.  Paths substituted for missing elements the user chose
+ * to ignore aren't saved, so the dialog comes back next time. */
+#define THEME_PATH_CACHE "Cache/themepaths.cache"
+static const int THEME_PATH_CACHE_MAGIC = 0x48545054;	/* "TPTH" */
+static const int THEME_PATH_CACHE_VERSION = 1;
+static set<CString> g_ThemePathsNotToSave[NUM_ELEMENT_CATEGORIES];
+static unsigned g_uThemePathCacheKey = 0;
+static bool g_bThemePathCacheDirty = false;
+
+struct ThemePathCacheHeader
+{
+	int iMagic;
+	int iVersion;
+	unsigned uKey;
+	int iNumEntries;
+};
+
+struct ThemePathCacheRecord
+{
+	int iCategory;
+	int iNameLength;	/* followed by the name and then the path, not NUL-terminated */
+	int iPathLength;
+};
+
+/* Metrics with fallbacks already followed, keyed by "class\nvalue".  Missing
+ * metrics are cached too, so HasMetric on an absent key doesn't walk every
+ * theme and fallback class again. */
+struct ResolvedMetric
+{
+	bool bFound;
+	CString sValue;
+};
+static map<CString, ResolvedMetric> g_MetricCache;
+
+static void ClearThemeCaches()
+{
+	for( int i = 0; i < NUM_ELEMENT_CATEGORIES; ++i )
+	{
+		g_ThemePathCache[i].clear();
+		g_ThemePathsNotToSave[i].clear();
+	}
+	g_MetricCache.clear();
+}
+
 void FileNameToClassAndElement( const CString &sFileName, CString &sClassNameOut, CString &sElementOut )
 {
 	// split into class name and file name
@@ -84,6 +131,7 @@ ThemeManager::ThemeManager()
 
 ThemeManager::~ThemeManager()
 {
+	SaveThemePathCache();
 }
 
 void ThemeManager::GetThemeNames( CStringArray& AddTo )
@@ -188,13 +236,13 @@ void ThemeManager::SwitchThemeAndLanguage( CString sThemeName, CString sLanguage
 	if( sThemeName == m_sCurThemeName && sLanguage == m_sCurLanguage )
 		return;
 
+	/* Keep what we resolved for the outgoing theme. */
+	SaveThemePathCache();
+
 	m_sCurThemeName = sThemeName;
 	m_sCurLanguage = sLanguage;
 
-	// clear theme path cache
-	int i;
-	for( i = 0; i < NUM_ELEMENT_CATEGORIES; ++i )
-		g_ThemePathCache[i].clear();
+	ClearThemeCaches();
 
 	g_vThemes.clear();
 
@@ -202,7 +250,7 @@ void ThemeManager::SwitchThemeAndLanguage( CString sThemeName, CString sLanguage
 	LoadThemeRecursive( g_vThemes, m_sCurThemeName );
 
 	CString sMetric;
-	for( i = 0; GetCommandlineArgument( "metric", &sMetric, i ); ++i )
+	for( int i = 0; GetCommandlineArgument( "metric", &sMetric, i ); ++i )
 	{
 		/* sMetric must be "foo::bar=baz".  "foo" and "bar" never contain "=", so in
 		 * "foo::bar=1+1=2", "baz" is always "1+1=2".  Neither foo nor bar may be
@@ -214,6 +262,8 @@ void ThemeManager::SwitchThemeAndLanguage( CString sThemeName, CString sLanguage
 
 		g_vThemes.front().iniMetrics.SetValue( sBits[0], sBits[1], sBits[2] );
 	}
+
+	LoadThemePathCache();
 	
 	LOG->MapLog("theme", "Theme: %s", sThemeName.c_str());
 	LOG->MapLog("language", "Language: %s", sLanguage.c_str());
@@ -336,6 +386,7 @@ try_element_again:
 	{
 		FlushDirCache();
 		g_ThemePathCache[category].clear();
+		g_ThemePathsNotToSave[category].clear();
 
 		CString message = ssprintf( 
 			"ThemeManager:  There is more than one theme element element that matches "
@@ -427,6 +478,7 @@ try_element_again:
 		if( !ret.empty() )	// we found something
 		{
 			Cache[sFileName] = ret;
+			g_bThemePathCacheDirty = true;
 			return ret;
 		}
 	}
@@ -434,6 +486,7 @@ try_element_again:
 	if( bOptional )
 	{
 		Cache[sFileName] = "";
+		g_bThemePathCacheDirty = true;
 		return "";
 	}
 
@@ -465,6 +518,7 @@ try_element_again:
 			RageException::Throw("'_missing' isn't present in '%s%s'", GetThemeDirFromName(BASE_THEME_NAME).c_str(), szCategory );
 
 		Cache[sFileName] = GetPath( category, "", "_missing" );
+		g_ThemePathsNotToSave[category].insert( sFileName );
 		return Cache[sFileName];
 	/* XXX: "abort" and "cancel" are synonyms; merge */
 	case Dialog::abort:
@@ -486,6 +540,115 @@ CString ThemeManager::GetMetricsIniPath( const CString &sThemeName )
 	return GetThemeDirFromName( sThemeName ) + METRICS_FILE;
 }
 
+/* Everything a resolved path depends on: the language, the theme chain, the
+ * files in each theme's element directories (including .redir files), the
+ * metrics (for Fallback classes) and any --metric overrides. */
+unsigned ThemeManager::GetThemePathCacheKey() const
+{
+	unsigned uKey = GetHashForString( m_sCurLanguage );
+
+	for( deque<Theme>::const_iterator iter = g_vThemes.begin();
+		iter != g_vThemes.end();
+		iter++ )
+	{
+		const CString sThemeDir = GetThemeDirFromName( iter->sThemeName );
+		uKey = uKey*31 + GetHashForDirectory( sThemeDir );
+		uKey = uKey*31 + GetHashForDirectory( sThemeDir + LANGUAGES_SUBDIR );
+		for( int i = 0; i < NUM_ELEMENT_CATEGORIES; ++i )
+			uKey = uKey*31 + GetHashForDirectory( sThemeDir + ELEMENT_CATEGORY_STRING[i] + "/" );
+	}
+
+	CString sMetric;
+	for( int i = 0; GetCommandlineArgument( "metric", &sMetric, i ); ++i )
+		uKey = uKey*31 + GetHashForString( sMetric );
+
+	return uKey;
+}
+
+void ThemeManager::LoadThemePathCache()
+{
+	g_uThemePathCacheKey = GetThemePathCacheKey();
+	g_bThemePathCacheDirty = false;
+
+	RageFile f;
+	if( !f.Open( THEME_PATH_CACHE ) )
+		return;
+
+	ThemePathCacheHeader h;
+	if( f.Read( &h, sizeof(h) ) != sizeof(h) )
+		return;
+	if( h.iMagic != THEME_PATH_CACHE_MAGIC || h.iVersion != THEME_PATH_CACHE_VERSION ||
+		h.uKey != g_uThemePathCacheKey || h.iNumEntries < 0 )
+		return;
+
+	for( int i = 0; i < h.iNumEntries; ++i )
+	{
+		ThemePathCacheRecord r;
+		CString sName, sPath;
+		if( f.Read( &r, sizeof(r) ) != sizeof(r) ||
+			r.iCategory < 0 || r.iCategory >= NUM_ELEMENT_CATEGORIES ||
+			r.iNameLength < 0 || r.iNameLength > 4096 ||
+			r.iPathLength < 0 || r.iPathLength > 4096 ||
+			f.Read( sName, r.iNameLength ) != r.iNameLength ||
+			f.Read( sPath, r.iPathLength ) != r.iPathLength )
+		{
+			LOG->Warn( "Theme path cache \"%s\" is truncated; ignored", THEME_PATH_CACHE );
+			for( int c = 0; c < NUM_ELEMENT_CATEGORIES; ++c )
+				g_ThemePathCache[c].clear();
+			return;
+		}
+
+		g_ThemePathCache[r.iCategory][sName] = sPath;
+	}
+
+	LOG->Trace( "Loaded %i theme paths from \"%s\"", h.iNumEntries, THEME_PATH_CACHE );
+}
+
+void ThemeManager::SaveThemePathCache()
+{
+	if( !g_bThemePathCacheDirty )
+		return;
+	g_bThemePathCacheDirty = false;
+
+	RageFile f;
+	if( !f.Open( THEME_PATH_CACHE, RageFile::WRITE ) )
+	{
+		LOG->Warn( "Couldn't write theme path cache \"%s\": %s", THEME_PATH_CACHE, f.GetError().c_str() );
+		return;
+	}
+
+	ThemePathCacheHeader h;
+	h.iMagic = THEME_PATH_CACHE_MAGIC;
+	h.iVersion = THEME_PATH_CACHE_VERSION;
+	h.uKey = g_uThemePathCacheKey;
+	h.iNumEntries = 0;
+	for( int c = 0; c < NUM_ELEMENT_CATEGORIES; ++c )
+		h.iNumEntries += g_ThemePathCache[c].size();
+	for( int c = 0; c < NUM_ELEMENT_CATEGORIES; ++c )
+		for( set<CString>::const_iterator it = g_ThemePathsNotToSave[c].begin(); it != g_ThemePathsNotToSave[c].end(); ++it )
+			if( g_ThemePathCache[c].find(*it) != g_ThemePathCache[c].end() )
+				--h.iNumEntries;
+	f.Write( &h, sizeof(h) );
+
+	for( int c = 0; c < NUM_ELEMENT_CATEGORIES; ++c )
+	{
+		const map<CString, CString> &Cache = g_ThemePathCache[c];
+		for( map<CString, CString>::const_iterator it = Cache.begin(); it != Cache.end(); ++it )
+		{
+			if( g_ThemePathsNotToSave[c].find(it->first) != g_ThemePathsNotToSave[c].end() )
+				continue;
+
+			ThemePathCacheRecord r;
+			r.iCategory = c;
+			r.iNameLength = it->first.size();
+			r.iPathLength = it->second.size();
+			f.Write( &r, sizeof(r) );
+			f.Write( it->first );
+			f.Write( it->second );
+		}
+	}
+}
+
 bool ThemeManager::HasMetric( const CString &sClassName, const CString &sValueName )
 {
 	CString sThrowAway;
@@ -506,13 +669,33 @@ void ThemeManager::ReloadMetrics()
 	//
 	// clear theme path cache
 	//
-	for( int i = 0; i < NUM_ELEMENT_CATEGORIES; ++i )
-		g_ThemePathCache[i].clear();
+	/* Don't trust the saved table, either; this is how the user asks us to
+	 * pick up edited theme files.  Overwrite it with what we resolve now. */
+	ClearThemeCaches();
+	g_bThemePathCacheDirty = true;
 }
 
 
 bool ThemeManager::GetMetricRaw( const CString &sClassName, const CString &sValueName, CString &ret, int level )
 {
+	if( level == 0 )
+	{
+		const CString sKey = sClassName + '\n' + sValueName;
+		map<CString, ResolvedMetric>::const_iterator it = g_MetricCache.find( sKey );
+		if( it != g_MetricCache.end() )
+		{
+			if( it->second.bFound )
+				ret = it->second.sValue;
+			return it->second.bFound;
+		}
+
+		ResolvedMetric &m = g_MetricCache[sKey];
+		m.bFound = GetMetricRaw( sClassName, sValueName, m.sValue, 1 );
+		if( m.bFound )
+			ret = m.sValue;
+		return m.bFound;
+	}
+
 	if( level > 100 )
 		RageException::Throw("Infinite recursion looking up theme metric \"%s::%s\"", sClassName.c_str(), sValueName.c_str() );
 
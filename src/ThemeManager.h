@@ -68,6 +68,9 @@ protected:
 	static CString GetMetricsIniPath( const CString &sThemeName );
 	static void GetLanguagesForTheme( const CString &sThemeName, CStringArray& asLanguagesOut );
 	static CString GetLanguageIniPath( const CString &sThemeName, const CString &sLanguage );
+	unsigned GetThemePathCacheKey() const;
+	void LoadThemePathCache();
+	void SaveThemePathCache();
 
 	CString m_sCurThemeName;
 	CString m_sCurLanguage;
@@ -6,6 +6,8 @@
 TimingData::TimingData()
 {
 	m_fBeat0OffsetInSeconds = 0;
+	m_iBreakpointBPMs = m_iBreakpointStops = 0;
+	m_bBreakpointsDirty = true;
 }
 
 static int CompareBPMSegments(const BPMSegment &seg1, const BPMSegment &seg2)
@@ -45,12 +47,14 @@ void TimingData::AddBPMSegment( const BPMSegment &seg )
 {
 	m_BPMSegments.push_back( seg );
 	SortBPMSegmentsArray( m_BPMSegments );
+	m_bBreakpointsDirty = true;
 }
 
 void TimingData::AddStopSegment( const StopSegment &seg )
 {
 	m_StopSegments.push_back( seg );
 	SortStopSegmentsArray( m_StopSegments );
+	m_bBreakpointsDirty = true;
 }
 
 void TimingData::SetBPMAtBeat( float fBeat, float fBPM )
@@ -72,6 +76,7 @@ void TimingData::SetBPMAtBeat( float fBeat, float fBPM )
 		else
 			m_BPMSegments[i].m_fBPM = fBPM;
 	}
+	m_bBreakpointsDirty = true;
 }
 
 
@@ -94,64 +99,141 @@ BPMSegment& TimingData::GetBPMSegmentAtBeat( float fBeat )
 }
 
 
-void TimingData::GetBeatAndBPSFromElapsedTime( float fElapsedTime, float &fBeatOut, float &fBPSOut, bool &bFreezeOut ) const
+void TimingData::UpdateBreakpoints()
 {
-//	LOG->Trace( "GetBeatAndBPSFromElapsedTime( fElapsedTime = %f )", fElapsedTime );
+	BuildBreakpoints();
+}
 
-	fElapsedTime += PREFSMAN->m_fGlobalOffsetSeconds;
+/* Walk the BPM segments and stops in beat order, accumulating time.  A stop
+ * on the same beat as a BPM change happens before the change, and stops
+ * before the first segment just delay everything. */
+void TimingData::BuildBreakpoints() const
+{
+	m_Breakpoints.clear();
+	m_iBreakpointBPMs = m_BPMSegments.size();
+	m_iBreakpointStops = m_StopSegments.size();
+	m_bBreakpointsDirty = false;
 
-	fElapsedTime += m_fBeat0OffsetInSeconds;
+	if( m_BPMSegments.empty() )
+		return;
+
+	m_Breakpoints.reserve( m_BPMSegments.size() + m_StopSegments.size() );
+
+	float fBeat = m_BPMSegments[0].m_fStartBeat;
+	float fSeconds = 0;
+	float fBPS = m_BPMSegments[0].m_fBPM / 60.0f;
 
+	unsigned j = 0;
+	while( j < m_StopSegments.size() && m_StopSegments[j].m_fStartBeat < fBeat )
+		fSeconds += m_StopSegments[j++].m_fStopSeconds;
 
-	for( unsigned i=0; i<m_BPMSegments.size(); i++ ) // foreach BPMSegment
+	TimingBreakpoint bp;
+	bp.m_fBeat = fBeat;
+	bp.m_fSeconds = fSeconds;
+	bp.m_fBPS = fBPS;
+	bp.m_fStopSeconds = 0;
+	m_Breakpoints.push_back( bp );
+
+	unsigned i = 1;
+	while( i < m_BPMSegments.size() || j < m_StopSegments.size() )
 	{
-		const float fStartBeatThisSegment = m_BPMSegments[i].m_fStartBeat;
-		const bool bIsFirstBPMSegment = i==0;
-		const bool bIsLastBPMSegment = i==m_BPMSegments.size()-1;
-		const float fStartBeatNextSegment = bIsLastBPMSegment ? 40000/*inf*/ : m_BPMSegments[i+1].m_fStartBeat; 
-		const float fBPS = m_BPMSegments[i].m_fBPM / 60.0f;
+		const bool bStop = j < m_StopSegments.size() &&
+			( i == m_BPMSegments.size() || m_StopSegments[j].m_fStartBeat <= m_BPMSegments[i].m_fStartBeat );
+		const float fNextBeat = bStop? m_StopSegments[j].m_fStartBeat:m_BPMSegments[i].m_fStartBeat;
+
+		fSeconds += (fNextBeat - fBeat) / fBPS;
+		fBeat = fNextBeat;
 
-		for( unsigned j=0; j<m_StopSegments.size(); j++ )	// foreach freeze
+		bp.m_fBeat = fBeat;
+		bp.m_fSeconds = fSeconds;
+		if( bStop )
 		{
-			if( !bIsFirstBPMSegment && fStartBeatThisSegment >= m_StopSegments[j].m_fStartBeat )
-				continue;
-			if( !bIsLastBPMSegment && m_StopSegments[j].m_fStartBeat > fStartBeatNextSegment )
-				continue;
-
-			// this freeze lies within this BPMSegment
-			const float fBeatsSinceStartOfSegment = m_StopSegments[j].m_fStartBeat - fStartBeatThisSegment;
-			const float fFreezeStartSecond = fBeatsSinceStartOfSegment / fBPS;
-			
-			if( fFreezeStartSecond >= fElapsedTime )
-				break;
-
-			// the freeze segment is <= current time
-			fElapsedTime -= m_StopSegments[j].m_fStopSeconds;
-
-			if( fFreezeStartSecond >= fElapsedTime )
-			{
-				/* The time lies within the stop. */
-				fBeatOut = m_StopSegments[j].m_fStartBeat;
-				fBPSOut = fBPS;
-				bFreezeOut = true;
-				return;
-			}
+			bp.m_fBPS = fBPS;
+			bp.m_fStopSeconds = m_StopSegments[j].m_fStopSeconds;
+			fSeconds += bp.m_fStopSeconds;
+			++j;
 		}
-
-		const float fBeatsInThisSegment = fStartBeatNextSegment - fStartBeatThisSegment;
-		const float fSecondsInThisSegment =  fBeatsInThisSegment / fBPS;
-		if( bIsLastBPMSegment || fElapsedTime <= fSecondsInThisSegment )
+		else
 		{
-			// this BPMSegment IS the current segment
-			fBeatOut = fStartBeatThisSegment + fElapsedTime*fBPS;
-			fBPSOut = fBPS;
-			bFreezeOut = false;
-			return;
+			fBPS = m_BPMSegments[i].m_fBPM / 60.0f;
+			bp.m_fBPS = fBPS;
+			bp.m_fStopSeconds = 0;
+			++i;
 		}
+		m_Breakpoints.push_back( bp );
+	}
+}
+
+const vector<TimingBreakpoint> &TimingData::GetBreakpoints() const
+{
+	/* Loaders fill in the segment arrays directly; notice when they've changed size. */
+	if( m_bBreakpointsDirty ||
+		m_iBreakpointBPMs != m_BPMSegments.size() ||
+		m_iBreakpointStops != m_StopSegments.size() )
+		BuildBreakpoints();
+	return m_Breakpoints;
+}
+
+static bool CompareBreakpointBeat( const TimingBreakpoint &bp, float fBeat )
+{
+	return bp.m_fBeat < fBeat;
+}
+
+static bool CompareBreakpointSeconds( float fSeconds, const TimingBreakpoint &bp )
+{
+	return fSeconds < bp.m_fSeconds;
+}
+
+/* Return the last breakpoint strictly before fBeat, or the first one if fBeat
+ * is before all of them.  The exact beat of a stop comes before the stop, so a
+ * stop on fBeat doesn't count yet. */
+int TimingData::FindBreakpointByBeat( float fBeat ) const
+{
+	const vector<TimingBreakpoint> &bps = m_Breakpoints;
+	vector<TimingBreakpoint>::const_iterator it = lower_bound( bps.begin(), bps.end(), fBeat, CompareBreakpointBeat );
+	if( it == bps.begin() )
+		return 0;
+	return (it - bps.begin()) - 1;
+}
+
+float TimingData::GetElapsedTimeFromBreakpoint( int iIndex, float fBeat ) const
+{
+	const TimingBreakpoint &bp = m_Breakpoints[iIndex];
+	float fSeconds = bp.m_fSeconds + (fBeat - bp.m_fBeat) / bp.m_fBPS;
+	if( bp.m_fBeat < fBeat )
+		fSeconds += bp.m_fStopSeconds;
+	return fSeconds;
+}
 
-		// this BPMSegment is NOT the current segment
-		fElapsedTime -= fSecondsInThisSegment;
+void TimingData::GetBeatAndBPSFromElapsedTime( float fElapsedTime, float &fBeatOut, float &fBPSOut, bool &bFreezeOut ) const
+{
+//	LOG->Trace( "GetBeatAndBPSFromElapsedTime( fElapsedTime = %f )", fElapsedTime );
+
+	fElapsedTime += PREFSMAN->m_fGlobalOffsetSeconds;
+
+	fElapsedTime += m_fBeat0OffsetInSeconds;
+
+	const vector<TimingBreakpoint> &bps = GetBreakpoints();
+	if( bps.empty() )
+		return;
+
+	/* Find the last breakpoint at or before this time. */
+	vector<TimingBreakpoint>::const_iterator it = upper_bound( bps.begin(), bps.end(), fElapsedTime, CompareBreakpointSeconds );
+	if( it != bps.begin() )
+		--it;
+	const TimingBreakpoint &bp = *it;
+
+	fBPSOut = bp.m_fBPS;
+	if( fElapsedTime >= bp.m_fSeconds && fElapsedTime < bp.m_fSeconds + bp.m_fStopSeconds )
+	{
+		/* The time lies within the stop. */
+		fBeatOut = bp.m_fBeat;
+		bFreezeOut = true;
+		return;
 	}
+
+	fBeatOut = bp.m_fBeat + (fElapsedTime - bp.m_fSeconds - bp.m_fStopSeconds) * bp.m_fBPS;
+	bFreezeOut = false;
 }
 
 
@@ -161,37 +243,39 @@ float TimingData::GetElapsedTimeFromBeat( float fBeat ) const
 	fElapsedTime -= PREFSMAN->m_fGlobalOffsetSeconds;
 	fElapsedTime -= m_fBeat0OffsetInSeconds;
 
-	for( unsigned j=0; j<m_StopSegments.size(); j++ )	// foreach freeze
+	if( GetBreakpoints().empty() )
+		return fElapsedTime;
+
+	return fElapsedTime + GetElapsedTimeFromBreakpoint( FindBreakpointByBeat(fBeat), fBeat );
+}
+
+void TimingData::GetElapsedTimesFromBeats( const float *pBeats, float *pSecondsOut, int iCount ) const
+{
+	const float fOffset = -PREFSMAN->m_fGlobalOffsetSeconds - m_fBeat0OffsetInSeconds;
+
+	const vector<TimingBreakpoint> &bps = GetBreakpoints();
+	if( bps.empty() )
 	{
-		/* The exact beat of a stop comes before the stop, not after, so use >=, not >. */
-		if( m_StopSegments[j].m_fStartBeat >= fBeat )
-			break;
-		fElapsedTime += m_StopSegments[j].m_fStopSeconds;
+		for( int i=0; i<iCount; i++ )
+			pSecondsOut[i] = fOffset;
+		return;
 	}
 
-	for( unsigned i=0; i<m_BPMSegments.size(); i++ ) // foreach BPMSegment
-	{
-		const bool bIsLastBPMSegment = i==m_BPMSegments.size()-1;
-		const float fBPS = m_BPMSegments[i].m_fBPM / 60.0f;
+	if( iCount == 0 )
+		return;
 
-		if( bIsLastBPMSegment )
-		{
-			fElapsedTime += fBeat / fBPS;
-		}
-		else
-		{
-			const float fStartBeatThisSegment = m_BPMSegments[i].m_fStartBeat;
-			const float fStartBeatNextSegment = m_BPMSegments[i+1].m_fStartBeat; 
-			const float fBeatsInThisSegment = fStartBeatNextSegment - fStartBeatThisSegment;
-			fElapsedTime += min(fBeat, fBeatsInThisSegment) / fBPS;
-			fBeat -= fBeatsInThisSegment;
-		}
-		
-		if( fBeat <= 0 )
-			return fElapsedTime;
+	/* Neighboring beats are usually in the same or an adjacent segment, so
+	 * walk from the last breakpoint instead of searching each time.  Beats in
+	 * either order work; FindBreakpointByBeat is the same walk done once. */
+	int iBP = FindBreakpointByBeat( pBeats[0] );
+	for( int i=0; i<iCount; i++ )
+	{
+		while( iBP+1 < (int) bps.size() && bps[iBP+1].m_fBeat < pBeats[i] )
+			++iBP;
+		while( iBP > 0 && bps[iBP].m_fBeat >= pBeats[i] )
+			--iBP;
+		pSecondsOut[i] = fOffset + GetElapsedTimeFromBreakpoint( iBP, pBeats[i] );
 	}
-
-	return fElapsedTime;
 }
 
 void TimingData::ScaleRegion( float fScale, float fStartBeat, float fEndBeat )
@@ -223,6 +307,8 @@ void TimingData::ScaleRegion( float fScale, float fStartBeat, float fEndBeat )
 		else
 			m_StopSegments[ix].m_fStartBeat = (fSegStart - fStartBeat) * fScale + fStartBeat;
 	}
+
+	m_bBreakpointsDirty = true;
 }
 
 void TimingData::ShiftRows( float fStartBeat, float fBeatsToShift )
@@ -247,6 +333,8 @@ void TimingData::ShiftRows( float fStartBeat, float fBeatsToShift )
 		fSegStart += fBeatsToShift;
 		fSegStart = max( fSegStart, fStartBeat );
 	}
+
+	m_bBreakpointsDirty = true;
 }
 
 bool TimingData::HasBpmChangesOrStops() const
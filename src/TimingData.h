@@ -19,6 +19,16 @@ struct StopSegment
 	float m_fStopSeconds;
 };
 
+/* One point where the beat<->time mapping changes slope: the start of a
+ * BPM segment or a stop.  Built from the segments by TimingData. */
+struct TimingBreakpoint
+{
+	float m_fBeat;
+	float m_fSeconds;		// time this beat is reached, not counting global/song offsets
+	float m_fBPS;			// beats per second after this point
+	float m_fStopSeconds;	// length of the stop here; 0 for a BPM change
+};
+
 class TimingData
 {
 public:
@@ -40,8 +50,17 @@ public:
 		return fBeat;
 	}
 	float GetElapsedTimeFromBeat( float fBeat ) const;
+
+	/* Convert an array of beats to seconds in one pass.  This is fastest when
+	 * the beats are in order, ascending or descending. */
+	void GetElapsedTimesFromBeats( const float *pBeats, float *pSecondsOut, int iCount ) const;
+
 	bool HasBpmChangesOrStops() const;
 
+	/* Call this after changing m_BPMSegments or m_StopSegments directly.
+	 * (Adding or removing segments is noticed automatically.) */
+	void UpdateBreakpoints();
+
 	// used for editor fix - expand/contract needs to move BPMSegments
 	// and StopSegments that land during/after the edited range.
 	// in addition, we need to be able to shift them otherwise as well
@@ -59,6 +78,17 @@ public:
 	vector<BPMSegment>			m_BPMSegments;	// this must be sorted before gameplay
 	vector<StopSegment>			m_StopSegments;	// this must be sorted before gameplay
 	float	m_fBeat0OffsetInSeconds;
+
+private:
+	const vector<TimingBreakpoint> &GetBreakpoints() const;
+	int FindBreakpointByBeat( float fBeat ) const;
+	float GetElapsedTimeFromBreakpoint( int iIndex, float fBeat ) const;
+
+	/* Sorted by beat and by time; queries are binary searches over this. */
+	mutable vector<TimingBreakpoint>	m_Breakpoints;
+	mutable unsigned	m_iBreakpointBPMs, m_iBreakpointStops;	// segment counts m_Breakpoints was built from
+	mutable bool		m_bBreakpointsDirty;
+	void BuildBreakpoints() const;
 };
 
 #endif
@@ -0,0 +1,238 @@
+#include "global.h"
+#include "RageSoundDriver_Mix.h"
+#include "RageSoundMixSink.h"
+#include "RageSoundManager.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+
+static const int channels = 2;
+static const int bytes_per_frame = 2 * channels; /* 16-bit */
+
+int RageSound_Mix::MixerThread_start( void *p )
+{
+	((RageSound_Mix *) p)->MixerThread();
+	return 0;
+}
+
+void RageSound_Mix::MixerThread()
+{
+#if defined(PSP)
+	sceKernelChangeThreadPriority( sceKernelGetThreadId(), 0x13 );
+#endif
+
+	SoundMixBuffer mix;
+	int16_t *pBuf = new int16_t[m_iFramesPerWrite * channels];
+	int16_t *pDecodeBuf = new int16_t[m_iFramesPerWrite * channels];
+
+	while( !shutdown )
+	{
+		/* If nothing is playing, don't feed the sink silence; just wait. */
+		if( !Mix(mix, pBuf, pDecodeBuf) )
+		{
+			usleep( 1000 );
+			continue;
+		}
+
+		/* This may block; don't hold m_Mutex. */
+		m_pSink->Write( pBuf, m_iFramesPerWrite );
+		m_iWritePos += m_iFramesPerWrite;
+	}
+
+	delete [] pBuf;
+	delete [] pDecodeBuf;
+}
+
+/* Mix one buffer of all playing sounds into pBuf.  Return false if no sounds
+ * are playing. */
+bool RageSound_Mix::Mix( SoundMixBuffer &mix, int16_t *pBuf, int16_t *pDecodeBuf )
+{
+	LockMut( m_Mutex );
+
+	const int64_t iPlayed = m_pSink->GetPlayedFrames();
+	const int iSampleRate = m_pSink->GetSampleRate();
+	bool bAnyPlaying = false;
+
+	for( unsigned i = 0; i < sounds.size(); ++i )
+	{
+		sound *s = sounds[i];
+
+		if( s->state == sound::FLUSHING && iPlayed >= s->flush_pos )
+			s->state = sound::FINISHED;
+		if( s->state != sound::PLAYING )
+			continue;
+
+		bAnyPlaying = true;
+
+		/* Does the sound have a start time?  If it's supposed to start past the
+		 * beginning of this buffer, insert silence.  What we write now won't be
+		 * heard until the frames already queued in the sink are. */
+		int iSilentFrames = 0;
+		if( !s->start_time.IsZero() )
+		{
+			const float fSecondsBeforeStart = -s->start_time.Ago();
+			const int64_t iQueuedFrames = m_iWritePos - iPlayed;
+			const int64_t iFramesBeforeStart = int64_t(fSecondsBeforeStart * iSampleRate) - iQueuedFrames;
+			iSilentFrames = (int) clamp( iFramesBeforeStart, (int64_t) 0, (int64_t) m_iFramesPerWrite );
+			if( iSilentFrames == 0 )
+				s->start_time.SetZero();
+		}
+
+		const int iWantFrames = m_iFramesPerWrite - iSilentFrames;
+		if( iWantFrames == 0 )
+			continue;
+
+		const int64_t iFrameNo = m_iWritePos + iSilentFrames;
+		const int iGotFrames = s->snd->GetPCM( (char *) pDecodeBuf, iWantFrames * bytes_per_frame, iFrameNo ) / bytes_per_frame;
+		mix.write( pDecodeBuf, iGotFrames * channels, s->snd->GetVolume(), iSilentFrames * channels );
+
+		if( iGotFrames < iWantFrames )
+		{
+			/* The sound is done; it's finished when the last frame is heard. */
+			s->state = sound::FLUSHING;
+			s->flush_pos = iFrameNo + iGotFrames;
+		}
+	}
+
+	if( !bAnyPlaying )
+		return false;
+
+	memset( pBuf, 0, m_iFramesPerWrite * bytes_per_frame );
+	mix.read( pBuf );
+	return true;
+}
+
+void RageSound_Mix::Update( float delta )
+{
+	/* Call SoundIsFinishedPlaying without holding m_Mutex; it takes the sound's
+	 * own lock. */
+	vector<RageSoundBase *> apFinished;
+
+	m_Mutex.Lock();
+	for( unsigned i = 0; i < sounds.size(); )
+	{
+		if( sounds[i]->state != sound::FINISHED )
+		{
+			++i;
+			continue;
+		}
+
+		apFinished.push_back( sounds[i]->snd );
+		sound *s = sounds[i];
+		m_SoundListMutex.Lock();
+		sounds.erase( sounds.begin()+i );
+		m_SoundListMutex.Unlock();
+		delete s;
+	}
+	m_Mutex.Unlock();
+
+	for( unsigned i = 0; i < apFinished.size(); ++i )
+		apFinished[i]->SoundIsFinishedPlaying();
+}
+
+void RageSound_Mix::StartMixing( RageSoundBase *snd )
+{
+	sound *s = new sound;
+	s->snd = snd;
+	s->start_time = snd->GetStartTime();
+
+	LockMut( m_Mutex );
+	m_SoundListMutex.Lock();
+	sounds.push_back( s );
+	m_SoundListMutex.Unlock();
+}
+
+void RageSound_Mix::StopMixing( RageSoundBase *snd )
+{
+	ASSERT( snd != NULL );
+
+	/* Once we hold the lock, the mixer isn't in GetPCM for this sound. */
+	LockMut( m_Mutex );
+
+	for( unsigned i = 0; i < sounds.size(); ++i )
+	{
+		if( sounds[i]->snd != snd )
+			continue;
+
+		/* We're stopping on request, so don't call SoundIsFinishedPlaying. */
+		sound *s = sounds[i];
+		m_SoundListMutex.Lock();
+		sounds.erase( sounds.begin()+i );
+		m_SoundListMutex.Unlock();
+		delete s;
+		return;
+	}
+
+	LOG->Trace( "not stopping a sound because it's not playing" );
+}
+
+int64_t RageSound_Mix::GetPosition( const RageSoundBase *snd ) const
+{
+	/* Don't lock m_Mutex: the caller holds the sound's lock, and the mixer takes
+	 * that lock (in GetPCM) while holding m_Mutex.  m_SoundListMutex is enough to
+	 * keep sounds[] from changing under us. */
+	bool bFound = false;
+	m_SoundListMutex.Lock();
+	for( unsigned i = 0; i < sounds.size(); ++i )
+	{
+		if( sounds[i]->snd == snd )
+		{
+			bFound = true;
+			break;
+		}
+	}
+	m_SoundListMutex.Unlock();
+
+	if( !bFound )
+		RageException::Throw( "GetPosition: Sound %s is not being played", snd->GetLoadedFilePath().c_str() );
+
+	/* All sounds share the sink's timeline; that's what we pass to GetPCM. */
+	return m_pSink->GetPlayedFrames();
+}
+
+int RageSound_Mix::GetSampleRate( int rate ) const
+{
+	return m_pSink->GetSampleRate();
+}
+
+float RageSound_Mix::GetPlayLatency() const
+{
+	return float(m_iFramesPerWrite) / m_pSink->GetSampleRate();
+}
+
+RageSound_Mix::RageSound_Mix( RageSoundMixSink *pSink, int iFramesPerWrite ):
+	m_Mutex( "MixSoundMutex" ),
+	m_SoundListMutex( "MixSoundListMutex" )
+{
+	ASSERT( pSink != NULL );
+	m_pSink = pSink;
+	m_iFramesPerWrite = iFramesPerWrite;
+	m_iWritePos = 0;
+	shutdown = false;
+}
+
+CString RageSound_Mix::Init()
+{
+	CString sError = m_pSink->Init();
+	if( sError != "" )
+		return sError;
+
+	MixingThread.SetName( "Mixer thread" );
+	MixingThread.Create( MixerThread_start, this );
+	return "";
+}
+
+RageSound_Mix::~RageSound_Mix()
+{
+	if( MixingThread.IsCreated() )
+	{
+		/* Signal the mixing thread to quit. */
+		shutdown = true;
+		LOG->Trace( "Shutting down mixer thread ..." );
+		MixingThread.Wait();
+		LOG->Trace( "Mixer thread shut down." );
+	}
+
+	for( unsigned i = 0; i < sounds.size(); ++i )
+		delete sounds[i];
+	delete m_pSink;
+}
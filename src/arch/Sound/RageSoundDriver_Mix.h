@@ -0,0 +1,72 @@
+/* RageSound_Mix: Software-mixing sound driver that writes to a RageSoundMixSink */
+
+#ifndef RAGE_SOUND_MIX_H
+#define RAGE_SOUND_MIX_H
+
+#include "RageSound.h"
+#include "RageThreads.h"
+#include "RageSoundDriver.h"
+
+class RageSoundMixSink;
+class SoundMixBuffer;
+
+/* Mix any number of sounds in software on one thread, and send the result
+ * to a RageSoundMixSink. */
+class RageSound_Mix: public RageSoundDriver
+{
+public:
+	/* We take ownership of pSink. */
+	RageSound_Mix( RageSoundMixSink *pSink, int iFramesPerWrite );
+	~RageSound_Mix();
+
+	/* Return "" on success, or an error. */
+	CString Init();
+
+	/* virtuals: */
+	void StartMixing( RageSoundBase *snd );
+	void StopMixing( RageSoundBase *snd );
+	int64_t GetPosition( const RageSoundBase *snd ) const;
+	int GetSampleRate( int rate ) const;
+	float GetPlayLatency() const;
+
+	void Update( float delta );
+
+private:
+	struct sound
+	{
+		sound() { snd = NULL; state = PLAYING; flush_pos = 0; }
+
+		RageSoundBase *snd;
+		RageTimer start_time;
+
+		enum {
+			PLAYING,
+			FLUSHING,	/* finished decoding; waiting for flush_pos to be heard */
+			FINISHED	/* waiting for Update to tell snd */
+		} state;
+
+		int64_t flush_pos;
+	};
+
+	/* This mutex serializes the mixer thread with StartMixing, StopMixing
+	 * and Update; sounds[] is only touched with it held. */
+	RageMutex m_Mutex;
+	vector<sound *> sounds;
+
+	/* Also held while sounds[] is changed, so GetPosition can search it without
+	 * m_Mutex.  Nothing else is locked while this is held. */
+	mutable RageMutex m_SoundListMutex;
+
+	RageSoundMixSink *m_pSink;
+	int m_iFramesPerWrite;
+	int64_t m_iWritePos;	/* frames sent to the sink */
+
+	bool shutdown;
+
+	static int MixerThread_start( void *p );
+	void MixerThread();
+	bool Mix( SoundMixBuffer &mix, int16_t *pBuf, int16_t *pDecodeBuf );
+	RageThread MixingThread;
+};
+
+#endif
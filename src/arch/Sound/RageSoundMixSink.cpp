@@ -0,0 +1,98 @@
+#include "global.h"
+#include "RageSoundMixSink.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+
+static const int channels = 2;
+static const int bytes_per_frame = 2 * channels; /* 16-bit */
+
+RageSoundMixSink_Null::RageSoundMixSink_Null()
+{
+	m_iFramesWritten = 0;
+	m_iFramesAtStart = 0;
+}
+
+void RageSoundMixSink_Null::Write( const int16_t *pBuf, int iFrames )
+{
+	/* Let the first write after an underrun through immediately, and restart
+	 * the clock from there; the mixer stops writing while nothing is playing,
+	 * and that time mustn't count as played.  After that, stay at most one
+	 * buffer ahead of the clock, like a device would. */
+	if( GetPlayedFrames() >= m_iFramesWritten )
+	{
+		m_StartTime.Touch();
+		m_iFramesAtStart = m_iFramesWritten;
+	}
+
+	m_iFramesWritten += iFrames;
+
+	while( 1 )
+	{
+		const int64_t iAhead = m_iFramesWritten - iFrames - GetPlayedFrames();
+		if( iAhead <= 0 )
+			break;
+		usleep( max( 1000, int(iAhead * 1000000 / GetSampleRate()) ) );
+	}
+}
+
+int64_t RageSoundMixSink_Null::GetPlayedFrames() const
+{
+	if( m_iFramesWritten == 0 )
+		return 0;
+	const int64_t iElapsed = int64_t( m_StartTime.Ago() * GetSampleRate() );
+	return min( m_iFramesAtStart + iElapsed, m_iFramesWritten );
+}
+
+RageSoundMixSink_WAV::RageSoundMixSink_WAV( const CString &sPath )
+{
+	m_sPath = sPath;
+	m_iFramesWritten = 0;
+}
+
+CString RageSoundMixSink_WAV::Init()
+{
+	if( !m_File.Open(m_sPath, RageFile::WRITE) )
+		return ssprintf( "Couldn't open \"%s\": %s", m_sPath.c_str(), m_File.GetError().c_str() );
+
+	/* We can't seek back to fill in the lengths when we're done, so write the
+	 * largest lengths possible; readers treat that as "until end of file". */
+	const uint32_t iUnknownLength = Swap32LE( 0xFFFFFFFF );
+	const uint32_t iFmtLength = Swap32LE( 16 );
+	const uint16_t iFormat = Swap16LE( 1 ); /* PCM */
+	const uint16_t iChannels = Swap16LE( channels );
+	const uint32_t iSampleRate = Swap32LE( GetSampleRate() );
+	const uint32_t iByteRate = Swap32LE( GetSampleRate() * bytes_per_frame );
+	const uint16_t iBlockAlign = Swap16LE( bytes_per_frame );
+	const uint16_t iBitsPerSample = Swap16LE( 16 );
+
+	m_File.Write( "RIFF", 4 );
+	m_File.Write( &iUnknownLength, 4 );
+	m_File.Write( "WAVEfmt ", 8 );
+	m_File.Write( &iFmtLength, 4 );
+	m_File.Write( &iFormat, 2 );
+	m_File.Write( &iChannels, 2 );
+	m_File.Write( &iSampleRate, 4 );
+	m_File.Write( &iByteRate, 4 );
+	m_File.Write( &iBlockAlign, 2 );
+	m_File.Write( &iBitsPerSample, 2 );
+	m_File.Write( "data", 4 );
+	m_File.Write( &iUnknownLength, 4 );
+
+	return "";
+}
+
+void RageSoundMixSink_WAV::Write( const int16_t *pBuf, int iFrames )
+{
+	const int iSamples = iFrames * channels;
+#if defined(ENDIAN_BIG)
+	int16_t *pSwapped = new int16_t[iSamples];
+	for( int i = 0; i < iSamples; ++i )
+		pSwapped[i] = Swap16LE( pBuf[i] );
+	m_File.Write( pSwapped, iSamples * sizeof(int16_t) );
+	delete [] pSwapped;
+#else
+	m_File.Write( pBuf, iSamples * sizeof(int16_t) );
+#endif
+
+	m_iFramesWritten += iFrames;
+}
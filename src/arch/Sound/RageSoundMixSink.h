@@ -0,0 +1,57 @@
+/* RageSoundMixSink: Output targets for RageSound_Mix, plus the null and WAV sinks */
+
+#ifndef RAGE_SOUND_MIX_SINK_H
+#define RAGE_SOUND_MIX_SINK_H
+
+#include "RageFile.h"
+#include "RageTimer.h"
+
+/* Where RageSound_Mix sends its output.  Data is always 16-bit stereo. */
+class RageSoundMixSink
+{
+public:
+	virtual ~RageSoundMixSink() { }
+
+	/* Return "" on success, or an error. */
+	virtual CString Init() { return ""; }
+
+	/* Queue iFrames frames of audio.  This may block until there's room. */
+	virtual void Write( const int16_t *pBuf, int iFrames ) = 0;
+
+	/* Number of frames written so far that have actually been heard. */
+	virtual int64_t GetPlayedFrames() const = 0;
+
+	virtual int GetSampleRate() const { return 44100; }
+};
+
+/* Discard output, but consume it in real time, so positions behave as they
+ * would on a device. */
+class RageSoundMixSink_Null: public RageSoundMixSink
+{
+public:
+	RageSoundMixSink_Null();
+	void Write( const int16_t *pBuf, int iFrames );
+	int64_t GetPlayedFrames() const;
+
+private:
+	RageTimer m_StartTime;		/* when m_iFramesAtStart began playing */
+	int64_t m_iFramesAtStart;
+	int64_t m_iFramesWritten;
+};
+
+/* Write output to a WAV file as fast as it's mixed. */
+class RageSoundMixSink_WAV: public RageSoundMixSink
+{
+public:
+	RageSoundMixSink_WAV( const CString &sPath );
+	CString Init();
+	void Write( const int16_t *pBuf, int iFrames );
+	int64_t GetPlayedFrames() const { return m_iFramesWritten; }
+
+private:
+	CString m_sPath;
+	RageFile m_File;
+	int64_t m_iFramesWritten;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "global.h"
+#include "RageSoundMixSink_PSP.h"
+#include "RageLog.h"
+#include "RageUtil.h"
+
+#include <pspaudio.h>
+
+static const int bytes_per_frame = 4; /* 16-bit stereo */
+
+RageSoundMixSink_PSP::RageSoundMixSink_PSP( int iFramesPerWrite )
+{
+	m_iFramesPerWrite = iFramesPerWrite;
+	m_iChannel = -1;
+	m_iBuffer = 0;
+	m_iFramesWritten = 0;
+
+	/* The hardware may still be reading one buffer while we fill the other. */
+	m_pBuffer[0] = (int16_t *) memalign( 64, m_iFramesPerWrite * bytes_per_frame );
+	m_pBuffer[1] = (int16_t *) memalign( 64, m_iFramesPerWrite * bytes_per_frame );
+	ASSERT( m_pBuffer[0] != NULL && m_pBuffer[1] != NULL );
+}
+
+RageSoundMixSink_PSP::~RageSoundMixSink_PSP()
+{
+	if( m_iChannel >= 0 )
+		sceAudioChRelease( m_iChannel );
+	free( m_pBuffer[0] );
+	free( m_pBuffer[1] );
+}
+
+CString RageSoundMixSink_PSP::Init()
+{
+	m_iChannel = sceAudioChReserve( PSP_AUDIO_NEXT_CHANNEL, PSP_AUDIO_SAMPLE_ALIGN(m_iFramesPerWrite), PSP_AUDIO_FORMAT_STEREO );
+	if( m_iChannel < 0 )
+		return ssprintf( "sceAudioChReserve failed (%08x)", m_iChannel );
+	return "";
+}
+
+void RageSoundMixSink_PSP::Write( const int16_t *pBuf, int iFrames )
+{
+	ASSERT( iFrames == m_iFramesPerWrite );
+
+	int16_t *pOut = m_pBuffer[m_iBuffer];
+	memcpy( pOut, pBuf, iFrames * bytes_per_frame );
+	m_iBuffer ^= 1;
+
+	/* Blocks until the previous buffer has been taken. */
+	sceAudioOutputBlocking( m_iChannel, PSP_AUDIO_VOLUME_MAX, pOut );
+	m_iFramesWritten += iFrames;
+}
+
+int64_t RageSoundMixSink_PSP::GetPlayedFrames() const
+{
+	int iRest = sceAudioGetChannelRestLength( m_iChannel );
+	if( iRest < 0 )
+		iRest = 0;
+	return m_iFramesWritten - iRest;
+}
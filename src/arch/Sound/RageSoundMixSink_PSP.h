@@ -0,0 +1,27 @@
+/* RageSoundMixSink_PSP: RageSound_Mix output through a PSP audio channel */
+
+#ifndef RAGE_SOUND_MIX_SINK_PSP_H
+#define RAGE_SOUND_MIX_SINK_PSP_H
+
+#include "RageSoundMixSink.h"
+
+/* Output to a single hardware channel. */
+class RageSoundMixSink_PSP: public RageSoundMixSink
+{
+public:
+	RageSoundMixSink_PSP( int iFramesPerWrite );
+	~RageSoundMixSink_PSP();
+
+	CString Init();
+	void Write( const int16_t *pBuf, int iFrames );
+	int64_t GetPlayedFrames() const;
+
+private:
+	int m_iFramesPerWrite;
+	int m_iChannel;
+	int16_t *m_pBuffer[2];
+	int m_iBuffer;
+	int64_t m_iFramesWritten;
+};
+
+#endif
@@ -20,7 +20,51 @@ LoadingWindow *MakeLoadingWindow()
 		return new LoadingWindow_PSP;
 }
 
+/* Mix in software, one writeahead at a time.  The hardware wants a multiple of
+ * 64 frames. */
+static int GetMixFramesPerWrite()
+{
+	int iFrames = 1024;
+	if( PREFSMAN->m_iSoundWriteAhead )
+		iFrames = PREFSMAN->m_iSoundWriteAhead;
+	return clamp( (iFrames + 63) & ~63, 64, 65472 );
+}
+
 RageSoundDriver *MakeRageSoundDriver()
 {
+	CStringArray asDriversToTry;
+	split( PREFSMAN->GetSoundDrivers(), ",", asDriversToTry, true );
+
+	for( unsigned i = 0; i < asDriversToTry.size(); ++i )
+	{
+		const CString &sDriver = asDriversToTry[i];
+		LOG->Trace( "Initializing driver: %s", sDriver.c_str() );
+
+		if( !sDriver.CompareNoCase("PSP") )
+			return new RageSound_PSP;
+
+		RageSoundMixSink *pSink = NULL;
+		if( !sDriver.CompareNoCase("Mix") )
+			pSink = new RageSoundMixSink_PSP( GetMixFramesPerWrite() );
+		else if( !sDriver.CompareNoCase("Null") )
+			pSink = new RageSoundMixSink_Null;
+		else if( !sDriver.CompareNoCase("WAV") )
+			pSink = new RageSoundMixSink_WAV( "Data/SoundOutput.wav" );
+		else
+		{
+			LOG->Warn( "Unknown sound driver name: %s", sDriver.c_str() );
+			continue;
+		}
+
+		RageSound_Mix *pDriver = new RageSound_Mix( pSink, GetMixFramesPerWrite() );
+		const CString sError = pDriver->Init();
+		if( sError == "" )
+			return pDriver;
+
+		LOG->Info( "Couldn't load driver %s: %s", sDriver.c_str(), sError.c_str() );
+		delete pDriver;
+	}
+
+	LOG->Warn( "No sound driver could be started; using PSP" );
 	return new RageSound_PSP;
 }
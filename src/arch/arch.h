@@ -9,6 +9,12 @@ class ArchHooks;
 LoadingWindow *MakeLoadingWindow();
 RageSoundDriver *MakeRageSoundDriver();
 
+/* Comma-separated; the first one that starts is used.  "PSP" uses one hardware
+ * channel per sound; "Mix" mixes in software to a single channel.  "Null" and
+ * "WAV" mix to nowhere or to a file, for testing. */
+#define DEFAULT_SOUND_DRIVER_LIST "PSP"
+#define DEFAULT_VIDEO_RENDERER_LIST "PSP"
+
 #endif
 
 /*
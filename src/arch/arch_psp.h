@@ -5,5 +5,7 @@
 #include "ArchHooks/ArchHooks_PSP.h"
 #include "LoadingWindow/LoadingWindow_PSP.h"
 #include "Sound/RageSoundDriver_PSP.h"
+#include "Sound/RageSoundDriver_Mix.h"
+#include "Sound/RageSoundMixSink_PSP.h"
 
 #endif
\ No newline at end of file